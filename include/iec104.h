@@ -37,8 +37,16 @@ public:
     void start();
     void stop();
 
+    /**
+     * Apply a new configuration. A change limited to the exchanged data is applied
+     * without closing the connections, other changes restart the client.
+     */
+    void reconfigure(const std::string& stack_configuration,
+                     const std::string& msg_configuration,
+                     const std::string& tls_configuration);
+
     // void ingest(Reading& reading);
-    void ingest(std::string assetName, std::vector<Datapoint*>& points);
+    void ingest(const std::string& assetName, std::vector<Datapoint*>& points);
     void registerIngest(void* data, void (*cb)(void*, Reading));
     bool operation(const std::string& operation, int count, PLUGIN_PARAMETER** params) const;
 
@@ -55,9 +63,15 @@ private:
     bool m_setpointNormalized(int count, PLUGIN_PARAMETER** params, bool withTime) const;
     bool m_setpointScaled(int count, PLUGIN_PARAMETER** params, bool withTime) const;
     bool m_setpointShort(int count, PLUGIN_PARAMETER** params, bool withTime) const;
+    bool m_commandBatchOperation(int count, PLUGIN_PARAMETER** params) const;
+    bool m_selectBeforeOperateOperation(int count, PLUGIN_PARAMETER** params) const;
 
     std::shared_ptr<IEC104ClientConfig> m_config;
 
+    std::string m_stackConfiguration;    // Configuration strings applied by setJsonConfig, used to detect changes
+    std::string m_tlsConfiguration;
+    size_t m_msgConfigurationHash = 0;   // exchanged_data can be very large, only its hash is kept
+
     std::string m_asset;
 
 protected:
@@ -0,0 +1,97 @@
+#ifndef IEC104_ADDRESS_REPORT_H
+#define IEC104_ADDRESS_REPORT_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+/*
+ * Bounded counters for received information objects whose address is not in
+ * the exchanged_data or whose type does not match the configured one.
+ *
+ * At most "capacity" addresses are tracked. When a new address arrives and the
+ * report is full the least frequent one is replaced (space saving algorithm),
+ * so the most frequent addresses are always kept with a count that is never
+ * underestimated.
+ */
+class IEC104AddressReport
+{
+public:
+
+    enum class Error
+    {
+        NOT_FOUND,
+        TYPE_MISMATCH
+    };
+
+    struct Entry
+    {
+        Error error;
+        int ca;
+        int ioa;
+        int typeId; /* received type ID */
+        uint64_t count;
+    };
+
+    explicit IEC104AddressReport(size_t capacity = 64, int maxWarningsPerPeriod = 10);
+
+    /**
+     * Count an error for the address
+     *
+     * @return true when the caller should log the error: the address was not tracked yet
+     *         and the number of warnings in the current period is not exhausted
+     */
+    bool add(Error error, int ca, int ioa, int typeId);
+
+    /**
+     * Get the most frequent address errors, by decreasing count
+     */
+    std::vector<Entry> top(size_t n) const;
+
+    uint64_t TotalCount() const;
+
+    /**
+     * Start a new reporting period
+     *
+     * @return true when errors were counted since the previous period
+     */
+    bool newPeriod();
+
+    /**
+     * Human readable list of the most frequent address errors
+     */
+    std::string summary(size_t n) const;
+
+    void clear();
+
+private:
+
+    static uint64_t key(Error error, int ca, int ioa) {
+        return ((uint64_t)(error == Error::TYPE_MISMATCH) << 48) | ((uint64_t)(ca & 0xffff) << 32) | (uint32_t)ioa;
+    };
+
+    mutable std::mutex m_mutex;
+
+    size_t m_capacity;
+    int m_maxWarningsPerPeriod;
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<uint64_t, size_t> m_index; /* key -> position in m_entries */
+
+    uint64_t m_totalCount = 0;
+    uint64_t m_periodCount = 0;
+    int m_periodWarnings = 0;
+};
+
+#endif /* IEC104_ADDRESS_REPORT_H */
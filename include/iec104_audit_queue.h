@@ -0,0 +1,103 @@
+#ifndef IEC104_AUDIT_QUEUE_H
+#define IEC104_AUDIT_QUEUE_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <condition_variable>
+
+/*
+ * Queue for the audits of the plugin.
+ *
+ * Audits are pushed by the protocol threads and sent to Fledge by a background
+ * thread, so that a connection state change never waits for the audit logger.
+ * An audit identical to the previous one is dropped. With a batch delay the
+ * audits of a burst (link flapping) are collected and sent in one batch.
+ */
+class IEC104AuditQueue
+{
+public:
+
+    enum class Level
+    {
+        SUCCESS,
+        FAILURE,
+        WARNING,
+        INFORMATION
+    };
+
+    /**
+     * @param maxSize maximum number of queued audits, the oldest audit is dropped when full
+     * @param batchDelay time (ms) to collect more audits before sending a batch
+     */
+    explicit IEC104AuditQueue(size_t maxSize = 1000, int batchDelay = 0);
+
+    ~IEC104AuditQueue();
+
+    /**
+     * Queue an audit. When the sender thread is not running the audit is sent immediately.
+     */
+    void push(Level level, const std::string& code, const std::string& data, bool addQuotes = true);
+
+    void start();
+
+    /**
+     * Stop the sender thread after all queued audits have been sent
+     */
+    void stop();
+
+    uint64_t CoalescedCount() const {return m_coalescedCount;};
+    uint64_t DroppedCount() const {return m_droppedCount;};
+    uint64_t SentCount() const {return m_sentCount;};
+    uint64_t BatchCount() const {return m_batchCount;};
+
+private:
+
+    struct Audit
+    {
+        Level level;
+        std::string code;
+        std::string message;
+
+        bool operator==(const Audit& other) const {
+            return (level == other.level) && (code == other.code) && (message == other.message);
+        }
+    };
+
+    static void send(const Audit& audit);
+
+    void _senderThread();
+
+    size_t m_maxSize;
+    int m_batchDelay;
+
+    std::mutex m_queueLock;
+    std::condition_variable m_queueCond;
+    std::deque<Audit> m_queue;
+
+    Audit m_lastAudit;
+    bool m_hasLastAudit = false;
+
+    bool m_running = false;
+    std::shared_ptr<std::thread> m_senderThread;
+
+    std::atomic<uint64_t> m_coalescedCount {0}; // audits dropped because identical to the previous one
+    std::atomic<uint64_t> m_droppedCount {0}; // audits dropped because the queue was full
+    std::atomic<uint64_t> m_sentCount {0}; // audits sent to the audit logger
+    std::atomic<uint64_t> m_batchCount {0}; // batches sent by the sender thread
+};
+
+#endif /* IEC104_AUDIT_QUEUE_H */
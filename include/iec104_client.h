@@ -13,6 +13,7 @@
  */
 
 #include <mutex>
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <string>
@@ -20,11 +21,19 @@
 
 #include <lib60870/cs104_connection.h>
 
+#include "iec104_audit_queue.h"
+#include "iec104_point_freshness.h"
+#include "iec104_read_scheduler.h"
+#include "iec104_gi_arbiter.h"
+#include "iec104_staleness_monitor.h"
+#include "iec104_command_queue.h"
+#include "iec104_command_latency.h"
+
 class IEC104;
 class IEC104ClientRedGroup;
 class IEC104ClientConnection;
 class IEC104ClientConfig;
-class DataExchangeDefinition;
+struct IEC104ExchangeTable;
 class RedGroupCon;
 class Datapoint;
 
@@ -39,27 +48,53 @@ public:
     // ==================================================================== //
 
     // Sends the datapoints passed as Reading to Fledge
-    void sendData(std::vector<Datapoint*> data,
-                  const std::vector<std::string> labels);
+    void sendData(const std::vector<Datapoint*>& data,
+                  const std::vector<const std::string*>& labels);
 
     bool sendInterrogationCommand(int ca);
 
-    bool sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long time);
+    // Commands are queued with their priority when cmd_parallel commands are outstanding (application_layer/cmd_queue)
+    bool sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
+
+    bool sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool select, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
+
+    bool sendStepCommand(int ca, int ioa, int value, bool withTime, bool select, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
 
-    bool sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool select, long time);
+    bool sendSetpointNormalized(int ca, int ioa, float value, bool withTime, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
 
-    bool sendStepCommand(int ca, int ioa, int value, bool withTime, bool select, long time);
+    bool sendSetpointScaled(int ca, int ioa, int value, bool withTime, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
 
-    bool sendSetpointNormalized(int ca, int ioa, float value, bool withTime, long time);
+    bool sendSetpointShort(int ca, int ioa, float value, bool withTime, long time,
+                           IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR);
 
-    bool sendSetpointScaled(int ca, int ioa, int value, bool withTime, long time);
+    // Select before operate (single, double or step command): the execute is sent on the positive ACT-CON of the select
+    bool sendSelectBeforeOperate(IEC104CommandQueue::Command command);
 
-    bool sendSetpointShort(int ca, int ioa, float value, bool withTime, long time);
+    // Queue the commands of a batch (bulk priority), sent while less than cmd_parallel commands are outstanding (false when none is queued)
+    bool sendCommandBatch(std::vector<IEC104CommandQueue::Command>& commands);
 
     bool sendConnectionStatus();
 
+    bool sendAddressReport();
+
+    bool sendMemoryReport();
+
+    // Counters of the command queue, pacing state of the active connection and command latencies
+    bool sendCommandReport();
+
+    // Connection attempts, reconnect delays, RTT, errors and window utilization of each path (connection of a redundancy group)
+    bool sendPathReport();
+
     bool scheduleGI();
 
+    // Called after the exchanged data has been replaced, interrogates the CAs whose data points changed
+    void exchangeTableChanged(const std::vector<int>& changedCAs);
+
     bool handleASDU(const IEC104ClientConnection* connection, CS101_ASDU asdu);
 
     void start();
@@ -83,18 +118,69 @@ public:
 
     void updateQualityForAllDataObjectsInStationGroup(QualityDescriptor qd);
 
-    void createListOfDatapointsInStationGroup();
+    // Create the list of data points of an interrogation group (0 = station) expected in the GI response (all CAs when cas is empty)
+    void createListOfDatapointsInGroup(int group, const std::vector<int>& cas = std::vector<int>());
 
-    void updateQualityForDataObjectsNotReceivedInGIResponse(QualityDescriptor qd);
+    // Update the quality of the interrogated group data points not received in the GI response (all CAs when ca is -1)
+    void updateQualityForDataObjectsNotReceivedInGIResponse(QualityDescriptor qd, int ca = -1);
 
     const std::string& getServiceName() const;
 
+    // Audits are sent asynchronously so that protocol threads never wait for the audit logger
+    IEC104AuditQueue& AuditQueue() {return m_auditQueue;};
+
+    // Time of the last value received for each data point, used by the adaptive GI cycle
+    IEC104PointFreshness& PointFreshness() {return m_pointFreshness;};
+
+    // Read commands (C_RD_NA_1) of the data points not refreshed for longer than their stale_after age
+    IEC104ReadScheduler& ReadScheduler() {return m_readScheduler;};
+
+    // Station GI requests of all sources, merged and limited by application_layer/gi_min_interval
+    IEC104GiArbiter& GiArbiter() {return m_giArbiter;};
+
+    // Commands waiting for a free cmd_parallel slot, by priority class
+    IEC104CommandQueue& CommandQueue() {return m_commandQueue;};
+
+    enum class AsduRejectReason
+    {
+        UNKNOWN_CA,
+        COT_NOT_ALLOWED,
+        TYPE_NOT_ALLOWED,
+        TEST_ASDU,
+        COUNT
+    };
+
+    uint64_t getRejectedAsduCount(AsduRejectReason reason) const;
+
 private:
 
-    std::vector<std::shared_ptr<DataExchangeDefinition>> m_listOfStationGroupDatapoints;
+    std::atomic<uint64_t> m_rejectedAsdus[static_cast<int>(AsduRejectReason::COUNT)] {}; // counters for ASDUs dropped by the asdu_filter
+
+    bool isAsduRejectedByFilter(CS101_ASDU asdu);
+
+    /* data points of the interrogated group not received yet in the GI response, indexed by point id of m_giPendingTable */
+    std::vector<bool> m_giPending;
+    std::shared_ptr<const IEC104ExchangeTable> m_giPendingTable;
+    std::mutex m_giPendingMtx; // protect access to m_giPending and m_giPendingTable (connection and receive threads)
 
     std::shared_ptr<IEC104ClientConfig> m_config;
 
+    IEC104AuditQueue m_auditQueue;
+
+    IEC104PointFreshness m_pointFreshness;
+
+    IEC104ReadScheduler m_readScheduler;
+
+    IEC104GiArbiter m_giArbiter;
+
+    IEC104StalenessMonitor m_stalenessMonitor;
+
+    IEC104CommandQueue m_commandQueue;
+
+    std::atomic<uint32_t> m_nextBatchId {1};
+
+    IEC104CommandLatency m_commandLatency;
+
     class OutstandingCommand {
     public:
 
@@ -106,6 +192,14 @@ private:
         std::shared_ptr<IEC104ClientConnection> clientCon;
         bool actConReceived = false;
         uint64_t timeout = 0;
+        uint64_t sentTime = 0; /* time in ms the command was sent */
+        uint64_t actConTime = 0; /* time in ms the ACT-CON was received, 0 = not received */
+        uint32_t batchId = 0; /* 0 = not sent by a batch */
+        uint32_t batchIndex = 0;
+        bool sbo = false; /* part of a select before operate command, its result is reported */
+        std::shared_ptr<IEC104CommandQueue::Command> execute; /* select before operate: sent on the positive ACT-CON of the select */
+
+        void selectBeforeOperate(const IEC104CommandQueue::Command& command);
     };
 
     std::vector<std::shared_ptr<OutstandingCommand>> m_outstandingCommands; // list of outstanding commands
@@ -117,8 +211,37 @@ private:
 
     void removeOutstandingCommand(std::shared_ptr<OutstandingCommand> command);
 
+    // The command could not be sent: its slot is freed and its pacing token given back
+    void commandNotSent(std::shared_ptr<OutstandingCommand> command);
+
     std::shared_ptr<OutstandingCommand> addOutstandingCommandAndCheckLimit(int ca, int ioa, bool withTime, int typeIdWithTimestamp, int typeIdNoTimestamp);
 
+    // Queue a command with the deadline of its class (false when the queue is full or disabled)
+    bool enqueueCommand(IEC104CommandQueue::Command& command);
+
+    // Queue a command of an operation, sent as soon as a slot is free
+    bool queueCommand(IEC104CommandQueue::Command command);
+
+    // Send the queued commands over the connection while cmd_parallel allows it
+    void dispatchQueuedCommands(std::shared_ptr<IEC104ClientConnection> connection);
+
+    bool sendQueuedCommand(IEC104ClientConnection& connection, const IEC104CommandQueue::Command& command);
+
+    // Send the execute of a select before operate command in the slot of its select
+    void sendSelectedCommand(std::shared_ptr<OutstandingCommand> select);
+
+    // The outstanding command is complete (ACT-CON/ACT-TERM received), its slot is given to the next queued command
+    void commandCompleted(const OutstandingCommand& command, const std::string& result);
+
+    // Add the latencies of a completed or timed out command and report its result
+    void reportOutstandingCommand(const OutstandingCommand& command, const std::string& result);
+
+    // Report the result of a command to the south_monitoring asset (latencies in ms, -1 = not measured)
+    void sendCommandResult(uint32_t batchId, uint32_t index, int typeId, int ca, int ioa, const std::string& result,
+                           int64_t actConLatency = -1, int64_t actTermLatency = -1);
+
+    static Datapoint* m_createLatencyDatapoint(const std::string& name, const IEC104CommandLatency::Latencies& latencies);
+
     enum class ConnectionStatus
     {
         STARTED,
@@ -133,11 +256,21 @@ private:
 
     void sendSouthMonitoringEvent(bool connxStatus, bool giStatus);
 
+    void logAddressReport();
+
     std::vector<std::shared_ptr<IEC104ClientConnection>> m_connections;
 
     std::shared_ptr<IEC104ClientConnection> m_activeConnection;
     std::mutex m_activeConnectionMtx;
 
+    /* choice of the active connection (transport_layer/path_selection), called with m_activeConnectionMtx locked */
+    std::shared_ptr<IEC104ClientConnection> selectPath(const std::shared_ptr<IEC104ClientConnection>& excluded);
+    void checkPathSwitchover(uint64_t currentTime);
+
+    uint64_t m_pathActivationTime = 0; /* the active connection was activated */
+    uint64_t m_betterPathSince = 0; /* a connected path is better than the active one since, 0 = none */
+    std::atomic<uint64_t> m_pathSwitchovers{0};
+
     bool m_started = false;
 
     std::shared_ptr<std::thread> m_monitoringThread;
@@ -150,118 +283,24 @@ private:
     template <class T>
     static Datapoint* m_createDatapoint(const std::string& dataname, const T value);
 
-    Datapoint* m_createQualityUpdateForDataObject(std::shared_ptr<DataExchangeDefinition> dataDefinition, const QualityDescriptor* qd, CP56Time2a ts);
+    Datapoint* m_createQualityUpdateForDataObject(const IEC104ExchangeTable& exchangeTable, uint32_t pointId, const QualityDescriptor* qd, CP56Time2a ts);
 
     void updateQualityForAllDataObjects(QualityDescriptor qd);
 
-    void removeFromListOfDatapoints(std::shared_ptr<DataExchangeDefinition> toRemove);
+    // Send the data points that exceeded their max_age with non topical quality
+    void updateQualityForStaleDataObjects();
+
+    bool removeFromListOfDatapoints(const IEC104ExchangeTable& exchangeTable, uint32_t pointId);
 
     template <class T>
     Datapoint* m_createDataObject(CS101_ASDU asdu, int64_t ioa, const std::string& dataname, const T value,
         QualityDescriptor* qd, CP56Time2a ts = nullptr);
 
-    typedef void (*IEC104_ASDUHandler)(std::vector<Datapoint*>& datapoints,
-                                    std::string& label,
-                                    std::shared_ptr<IEC104Client> mclient, unsigned int ca,
-                                    CS101_ASDU asdu, InformationObject io,
-                                    uint64_t ioa);
-
-    void handle_M_ME_NB_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_SP_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_SP_TB_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_DP_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_DP_TB_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ST_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ST_TB_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ME_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ME_TD_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ME_TE_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ME_NC_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    void handle_M_ME_TF_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa);
-
-    // commands and setpoint commands (for ACKs)
-    void handle_C_SC_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
-
-    void handle_C_DC_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
-
-    void handle_C_RC_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
-
-    void handle_C_SE_NA_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
-
-    void handle_C_SE_NB_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
-
-    void handle_C_SE_NC_1(std::vector<Datapoint*>& datapoints,
-                                std::string& label,
-                                unsigned int ca, CS101_ASDU asdu,
-                                InformationObject io, uint64_t ioa,
-                                std::shared_ptr<OutstandingCommand> outstandingCommand);
+    // Decoders for received ASDUs, generated from the per type ID traits in iec104_client.cpp
+    struct AsduDecoders;
+
+    // Updates the outstanding command on ACT-CON/ACT-TERM (hasActTerm is false for set point commands)
+    void handleCommandResponse(CS101_ASDU asdu, std::shared_ptr<OutstandingCommand> outstandingCommand, bool hasActTerm);
 
     bool isAsduTriggerGi(std::vector<Datapoint*>& datapoints,
                             unsigned int ca,
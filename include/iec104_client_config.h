@@ -2,32 +2,105 @@
 #define IEC104_CLIENT_CONFIG_H
 
 
-#include <map>
+#include <bitset>
+#include <string>
 #include <vector>
 #include <memory>
-#include <utility>
-#include <unordered_set>
+#include <cstdint>
 
 #include <rapidjson/document.h>
 
+#include "iec104_address_report.h"
+#include "iec104_label_pool.h"
+
 class IEC104ClientRedGroup;
 
-struct DataExchangeDefinition {
-    int ca = 0;
-    int ioa = 0;
-    int typeId = 0;
-    std::string label;
-    int giGroups = 0;
-};
+/*
+ * Exchanged data imported from the exchanged_data configuration. A table is not
+ * modified once published: a reconfiguration builds a new table and swaps it
+ * atomically, readers keep the snapshot they got from ExchangeTable().
+ *
+ * The data points are stored in parallel arrays indexed by a 32 bit point id,
+ * ordered by CA then IOA. A point id is only meaningful with the table it comes from.
+ */
+struct IEC104ExchangeTable {
+    static const uint32_t NO_POINT = UINT32_MAX;
 
-// Define a custom hash function for std::pair<T, U>
-template <typename T, typename U>
-struct pairHash {
-    size_t operator()(const std::pair<T, U>& p) const {
-        size_t h1 = std::hash<T>{}(p.first);
-        size_t h2 = std::hash<U>{}(p.second);
-        return h1 ^ (h2 << 1); // Combine the two hash values
-    }
+    /* data point flags */
+    static const uint8_t FLAG_CG_TRIGGERING = 0x01; /* TS that triggers a CG if its value is 0 */
+
+    /* interrogation groups: 0 = station, 1..16 = groups interrogated with QOI 21..36 */
+    static const int GI_GROUP_STATION = 0;
+    static const int GI_GROUP_MAX = 16;
+
+    /* data points, indexed by point id */
+    std::vector<int32_t> cas;
+    std::vector<int32_t> ioas;
+    std::vector<uint8_t> typeIds;
+    std::vector<uint8_t> flags;
+    std::vector<uint32_t> giGroups; /* bit 0: station group, bit n: group n */
+    std::vector<uint32_t> labelIds;
+    std::vector<uint32_t> staleAfter; /* age in s after which the point is read (C_RD_NA_1), 0 = application_layer/read_refresh default */
+    std::vector<uint32_t> maxAge; /* age in s after which the point is sent with non topical quality, 0 = application_layer/max_age default */
+
+    IEC104LabelPool labels;
+
+    std::vector<int> listOfCAs;
+
+    std::vector<uint32_t> caFirstPoints; /* first point id of each CA of listOfCAs, followed by the number of points */
+
+    std::vector<uint32_t> caGiGroups; /* groups of the data points of each CA of listOfCAs */
+
+    std::bitset<65536> knownCas; /* CAs used in exchanged_data, for the asdu_filter */
+
+    std::vector<uint32_t> labelPoints; /* first point id (by CA and IOA) of each label, indexed by label id */
+
+    struct MemoryUsage {
+        size_t points;
+        size_t labels;
+        size_t pointBytes; /* parallel arrays */
+        size_t labelBytes; /* interned labels and label index */
+        size_t indexBytes; /* CA and label -> point indexes */
+    };
+
+    uint32_t Size() const {return static_cast<uint32_t>(cas.size());};
+
+    /* add a data point, the point ids are assigned by buildIndexes() */
+    void addPoint(int ca, int ioa, int typeId, uint32_t pointGiGroups, uint8_t pointFlags, uint32_t labelId,
+                  uint32_t pointStaleAfter = 0, uint32_t pointMaxAge = 0);
+
+    /* order the data points by address (the last definition of an address is kept) and update the indexes */
+    void buildIndexes();
+
+    /**
+     * @return the point id of the address or NO_POINT
+     */
+    uint32_t find(int ca, int ioa) const;
+
+    /**
+     * @return the first point id with the label or NO_POINT
+     */
+    uint32_t findLabel(const std::string& label) const;
+
+    /**
+     * Get the point ids of a CA: [first, last)
+     *
+     * @return false when the CA is not in the table
+     */
+    bool caRange(int ca, uint32_t& first, uint32_t& last) const;
+
+    /**
+     * Get the CAs with data points in an interrogation group
+     */
+    std::vector<int> casInGroup(int group) const;
+
+    const std::string& label(uint32_t pointId) const {return labels.Label(labelIds[pointId]);};
+    bool isCgTriggering(uint32_t pointId) const {return (flags[pointId] & FLAG_CG_TRIGGERING) != 0;};
+    bool isInStationGroup(uint32_t pointId) const {return isInGroup(pointId, GI_GROUP_STATION);};
+    bool isInGroup(uint32_t pointId, int group) const {return (giGroups[pointId] & (1u << group)) != 0;};
+
+    /* approximate heap memory used by the table */
+    MemoryUsage memoryUsage() const;
 };
 
 class IEC104ClientConfig
@@ -41,10 +114,30 @@ public:
 
     void importProtocolConfig(const std::string& protocolConfig);
     void importExchangeConfig(const std::string& exchangeConfig);
+
+    /**
+     * Replace the exchanged data while the connections are running
+     *
+     * @param changedCAs CAs of the new exchanged data whose data points were added, removed or modified
+     * @return false when the new exchanged data is invalid (the current one is kept)
+     */
+    bool reloadExchangeConfig(const std::string& exchangeConfig, std::vector<int>& changedCAs);
+
+    /* binary cache of the exchange table (empty path = no cache) */
+    void setExchangeTableCache(const std::string& path) {m_exchangeCacheFile = path;};
+    bool isExchangeTableFromCache() const {return m_exchangeTableFromCache;};
     void importTlsConfig(const std::string& tlsConfig);
 
     void importRedGroup(const rapidjson::Value& redGroup);
     void importRedGroupCon(const rapidjson::Value& con, std::shared_ptr<IEC104ClientRedGroup> redundancyGroup) const;
+    void importApciAutoTune(const rapidjson::Value& autoTune, std::shared_ptr<IEC104ClientRedGroup> redundancyGroup) const;
+    void importAsduFilter(const rapidjson::Value& asduFilter);
+    void importGiGroupCycles(const rapidjson::Value& giGroupCycles);
+    void importGiAdaptive(const rapidjson::Value& giAdaptive);
+    void importReadRefresh(const rapidjson::Value& readRefresh);
+    void importMaxAge(const rapidjson::Value& maxAge);
+    void importCmdQueue(const rapidjson::Value& cmdQueue);
+    void importPathSelection(const rapidjson::Value& pathSelection);
 
     int CaSize() {return m_caSize;};
     int IOASize() {return m_ioaSize;};
@@ -62,10 +155,47 @@ public:
     bool GiEnabled() {return m_giEnabled;};
     int GiRepeatCount() {return m_giRepeatCount;};
     int GiTime() {return m_giTime;};
+    int GiParallel() {return m_giParallel;};
+    int GiMinInterval() {return m_giMinInterval;};
+
+    /* cycle time in seconds of an interrogation group 1..16 (0 = not interrogated) */
+    int GiGroupCycle(int group) const {return ((group > 0) && (group <= IEC104ExchangeTable::GI_GROUP_MAX)) ? m_giGroupCycles[group] : 0;};
+
+    /* adaptive GI cycle (application_layer/gi_adaptive) */
+    bool isGiAdaptive() const {return (m_giAdaptiveCoverage > 0);};
+    int GiAdaptiveCoverage() const {return m_giAdaptiveCoverage;};
+    int GiAdaptiveMaxReads() const {return m_giAdaptiveMaxReads;};
+    int GiAdaptiveMaxSkips() const {return m_giAdaptiveMaxSkips;};
+
+    /* read of the stale data points (application_layer/read_refresh) */
+    int ReadStaleAfter() const {return m_readStaleAfter;};
+    int ReadMaxOutstanding() const {return m_readMaxOutstanding;};
+    int ReadTimeout() const {return m_readTimeout;};
+
+    /* age in s after which the data points of a type are sent with non topical quality (application_layer/max_age, 0 = not checked) */
+    int MaxAge(int typeId) const {return ((typeId >= 0) && (typeId < 128)) ? m_maxAgeByType[typeId] : 0;};
     int CmdExecTimeout() {return m_cmdExecTimeout;};
 
     int CmdParallel() {return m_cmdParallel;};
 
+    /* commands queued when cmd_parallel is reached (application_layer/cmd_queue) */
+    int CmdQueueSize() const {return m_cmdQueueSize;};
+    /* deadline in s of a queued command of a priority class (IEC104CommandQueue::Priority), 0 = no deadline */
+    int CmdQueueDeadline(int priority) const {return ((priority >= 0) && (priority < 3)) ? m_cmdQueueDeadlines[priority] : 0;};
+    bool isSetpointCoalescing() const {return m_cmdQueueCoalesceSetpoints;};
+
+    /* choice of the active connection (transport_layer/path_selection) */
+    bool isRttPathSelection() const {return m_rttPathSelection;};
+    bool isPathSwitchover() const {return m_pathSwitchover;};
+    int PathHysteresis() const {return m_pathHysteresis;};
+    int PathHoldTime() const {return m_pathHoldTime;};
+
+    /* ASDU filter (application_layer/asdu_filter) applied to monitoring direction ASDUs */
+    bool isCaAllowed(int ca) const {return !m_rejectUnknownCa || ((ca >= 0) && (ca < 65536) && ExchangeTable()->knownCas[ca]);};
+    bool isCotAllowed(int cot) const {return (cot >= 0) && (cot < 64) && ((m_allowedCots >> cot) & 1);};
+    bool isTypeIdAllowed(int typeId) const {return (typeId >= 0) && (typeId < 128) && m_allowedTypeIds[typeId];};
+    bool RejectTestAsdu() const {return m_rejectTestAsdu;};
+
     std::string& GetConnxStatusSignal() {return m_connxStatus;};
 
     std::string& GetPrivateKey() {return m_privateKey;};
@@ -77,23 +207,35 @@ public:
 
     std::vector<std::shared_ptr<IEC104ClientRedGroup>>& RedundancyGroups() {return m_redundancyGroups;};
 
-    std::map<int, std::map<int, std::shared_ptr<DataExchangeDefinition>>>& ExchangeDefinition() {return m_exchangeDefinitions;};
+    std::shared_ptr<const IEC104ExchangeTable> ExchangeTable() const {return std::atomic_load(&m_exchangeTable);};
 
     /**
-     * Check if a CA / IOA pair is in the CG triggering TS address set
+     * Check if a CA / IOA pair is a CG triggering TS address
      *
-     * @return True if the given pair is present in the address set
+     * @return True if the given pair is a CG triggering TS address
      */
-    bool isTsAddressCgTriggering(int ca, int ioa) { return m_cgTriggeringTsAdresses.find(std::make_pair(ca, ioa)) != m_cgTriggeringTsAdresses.end(); }
-
-    std::vector<int>& ListOfCAs() {return m_listOfCAs;};
+    bool isTsAddressCgTriggering(int ca, int ioa) const {
+        auto exchangeTable = ExchangeTable();
+        uint32_t pointId = exchangeTable->find(ca, ioa);
+        return (pointId != IEC104ExchangeTable::NO_POINT) && exchangeTable->isCgTriggering(pointId);
+    }
 
     static int getTypeIdFromString(const std::string& name);
     static std::string getStringFromTypeID(int typeId);
 
-    std::string* checkExchangeDataLayer(int typeId, int ca, int ioa);
+    /**
+     * Find the data point of a received information object
+     *
+     * @return the point id in the current exchange table, or IEC104ExchangeTable::NO_POINT when the address
+     *         is unknown or the type does not match
+     */
+    uint32_t checkExchangeDataLayer(int typeId, int ca, int ioa);
 
-    std::shared_ptr<DataExchangeDefinition> getExchangeDefinitionByLabel(std::string& label);
+    /* same as above with an exchange table snapshot held by the caller, the point id refers to this table */
+    uint32_t checkExchangeDataLayer(const IEC104ExchangeTable& exchangeTable, int typeId, int ca, int ioa);
+
+    IEC104AddressReport& AddressReport() {return m_addressReport;};
+    int AddressReportPeriod() {return m_addressReportPeriod;};
 
     int GetMaxRedGroups() const {return m_max_red_groups;};
 
@@ -103,19 +245,30 @@ private:
 
     static bool isMessageTypeMatching(int expectedType, int rcvdType);
 
-    void deleteExchangeDefinitions();
+    bool parseExchangeConfig(const std::string& exchangeConfig, IEC104ExchangeTable& exchangeTable) const;
+
+    /* load the exchange table from the cache or parse the JSON (and update the cache) */
+    bool buildExchangeTable(const std::string& exchangeConfig, IEC104ExchangeTable& exchangeTable);
+
+    static bool isSameCaDefinitions(const IEC104ExchangeTable& oldTable, const IEC104ExchangeTable& newTable, int ca);
 
     std::vector<std::shared_ptr<IEC104ClientRedGroup>> m_redundancyGroups;
     int m_max_red_groups = 2;
 
-    std::map<int, std::map<int, std::shared_ptr<DataExchangeDefinition>>> m_exchangeDefinitions;
+    std::shared_ptr<const IEC104ExchangeTable> m_exchangeTable = std::make_shared<IEC104ExchangeTable>(); /* only accessed with atomic_load/atomic_store */
 
-    /* Set of TS addresses that triggers a CG if the TS value is 0. First member is ca, second is ioa */
-    std::unordered_set<std::pair<int, int>, pairHash<int, int>> m_cgTriggeringTsAdresses;
-
-    std::vector<int> m_listOfCAs;
+    std::string m_exchangeCacheFile = ""; /* binary cache of the exchange table */
+    bool m_exchangeTableFromCache = false; /* last exchange table was loaded from the cache */
 
     int m_cmdParallel = 0; /* application_layer/cmd_parallel - 0 = no limit - limits the number of commands that can be executed in parallel */
+    int m_cmdQueueSize = 1000; /* application_layer/cmd_queue/size: commands queued when cmd_parallel is reached (0 = rejected) */
+    int m_cmdQueueDeadlines[3] = {2, 10, 120}; /* application_layer/cmd_queue/deadline: time in s a protection, operator or bulk command may stay queued */
+    bool m_cmdQueueCoalesceSetpoints = false; /* application_layer/cmd_queue/coalesce_setpoints: a queued set point is replaced by a newer one for the same address */
+
+    bool m_rttPathSelection = false; /* transport_layer/path_selection/mode: "rtt" = the connected path with the lowest cost is activated, "first" = the first connected path */
+    bool m_pathSwitchover = false; /* transport_layer/path_selection/switchover: the active path is replaced by a better connected path */
+    int m_pathHysteresis = 30; /* transport_layer/path_selection/hysteresis: percent the cost of the better path must be lower */
+    int m_pathHoldTime = 30; /* transport_layer/path_selection/hold_time: time in s the path must stay better, and minimum time between two switchovers */
     
     int m_caSize = 2;
     int m_ioaSize = 3;
@@ -132,9 +285,31 @@ private:
     int m_giCycle = 0; /* application_layer/gi_cycle: cycle time in seconds (0 = cycle disabled)*/
     int m_giRepeatCount = 2; /* application_layer/gi_repeat_count */
     int m_giTime = 0; /* timeout for GI execution (timeout is for each consecutive step of the GI process)*/
+    int m_giParallel = 1; /* application_layer/gi_parallel: maximum number of CAs interrogated at the same time (gi_all_ca) */
+    int m_giMinInterval = 0; /* application_layer/gi_min_interval: minimum time in seconds between the start of two requested GIs (0 = no limit) */
+    int m_giGroupCycles[IEC104ExchangeTable::GI_GROUP_MAX + 1] = {}; /* application_layer/gi_group_cycles: cycle time in seconds of each group (0 = not interrogated) */
+
+    int m_giAdaptiveCoverage = 0; /* application_layer/gi_adaptive/coverage: % of station group points refreshed since the last cycle to skip a GI (0 = disabled) */
+    int m_giAdaptiveMaxReads = 0; /* application_layer/gi_adaptive/max_reads: stale points read (C_RD_NA_1) when a GI is skipped */
+    int m_giAdaptiveMaxSkips = 3; /* application_layer/gi_adaptive/max_skips: consecutive skipped GI cycles before a GI is forced */
+
+    int m_readStaleAfter = 0; /* application_layer/read_refresh/stale_after: age in s after which a data point is read (0 = only the points with stale_after) */
+    int m_readMaxOutstanding = 4; /* application_layer/read_refresh/max_outstanding: reads waiting for their response (also limited by k) */
+    int m_readTimeout = 10; /* application_layer/read_refresh/timeout: time in s to wait for the response of a read */
+
+    int m_maxAgeByType[128] = {}; /* application_layer/max_age: age in s of the data points of each type, indexed by type ID */
 
     int m_cmdExecTimeout = 1000; /* timeout to wait until command execution is finished (ACT-CON/ACT-TERM received)*/
 
+    int m_addressReportPeriod = 60; /* application_layer/address_report_period: period in s of the unknown address summary (0 = disabled) */
+
+    IEC104AddressReport m_addressReport; /* unknown or type mismatching addresses received */
+
+    bool m_rejectUnknownCa = false; /* application_layer/asdu_filter/reject_unknown_ca */
+    uint64_t m_allowedCots = ~0ULL; /* application_layer/asdu_filter/allowed_cot - one bit per COT (all allowed by default) */
+    std::bitset<128> m_allowedTypeIds = std::bitset<128>().set(); /* application_layer/asdu_filter/allowed_types (all allowed by default) */
+    bool m_rejectTestAsdu = false; /* application_layer/asdu_filter/test_asdu: "accept" or "reject" */
+
     bool m_protocolConfigComplete = false; /* flag if protocol configuration is read */
     bool m_exchangeConfigComplete = false; /* flag if exchange configuration is read */
     bool m_tlsConfigComplete = false; /* flag if tls configuration is read */
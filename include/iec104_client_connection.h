@@ -3,11 +3,18 @@
 
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <vector>
 
 #include <lib60870/cs104_connection.h>
 #include <lib60870/tls_config.h>
 
+#include "iec104_token_bucket.h"
+#include "iec104_tls_cache.h"
+#include "iec104_reconnect_backoff.h"
+#include "iec104_path_health.h"
+#include "iec104_window_tuner.h"
+
 class IEC104Client;
 class IEC104ClientRedGroup;
 class IEC104ClientConfig;
@@ -24,6 +31,9 @@ public:
     void Stop();
     void Activate();
 
+    // Send STOP-DT to the active connection, another connection is activated (path switchover)
+    void Deactivate();
+
     void Disonnect();
     void Connect();
 
@@ -32,10 +42,39 @@ public:
     bool Connecting() {return m_connecting;};
     bool Connected() {return m_connected;};
     bool Active() {return m_active;};
+    bool ConnectRequested() {return m_connect;};
+
+    // Time in ms without active connection before this connection is tried as backup (backup_delay of the redundancy group)
+    int BackupDelay() const;
+
+    const std::string& PathLetter() const {return m_path_letter;};
+    std::shared_ptr<IEC104ClientRedGroup> RedGroup() const {return m_redGroup;};
+    std::shared_ptr<RedGroupCon> RedGroupConnection() const {return m_redGroupConnection;};
+
+    struct PathStats
+    {
+        uint64_t connectAttempts;
+        uint64_t connectFailures; /* attempts that timed out or were refused */
+        uint64_t connectionsLost; /* established connections closed */
+        uint64_t reconnectDelay; /* last delay in ms before an attempt */
+    };
+
+    PathStats getPathStats();
+
+    IEC104PathHealth::Metrics getPathHealth() const {return m_pathHealth.getMetrics();};
 
-    bool sendInterrogationCommand(int ca);
+    // Cost of the path for the choice of the active connection (-1 = RTT not measured)
+    int64_t PathCost() const {return m_pathHealth.cost();};
+
+    IEC104WindowTuner::Stats getWindowStats() const {return m_windowTuner.getStats();};
+
+    bool sendInterrogationCommand(int ca, QualifierOfInterrogation qoi = IEC60870_QOI_STATION);
+    bool sendReadCommand(int ca, int ioa);
     void startNewInterrogationCycle();
 
+    // Request a GI for the given CAs only, sent when no other GI is in progress
+    void requestInterrogation(const std::vector<int>& cas);
+
     bool sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long msTimestamp);
     bool sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool select, long msTimestamp);
     bool sendStepCommand(int ca, int ioa, int value, bool withTime, bool select, long msTimestamp);
@@ -43,22 +82,26 @@ public:
     bool sendSetpointScaled(int ca, int ioa, int value, bool withTime, long msTimestamp);
     bool sendSetpointShort(int ca, int ioa, float value, bool withTime, long msTimestamp);
 
-    // Getter and setter for m_giRequested
-    void setGiRequested(bool value){
-        m_giRequested = value;
-    }
+    // Token for a command paced by cmd_rate/cmd_burst of the redundancy group (false when the command has to wait)
+    bool takeCommandToken();
+
+    // Give back the token of a command that could not be sent
+    void refundCommandToken();
 
-    bool getGiRequested(){
-        return m_giRequested;
-    }
+    IEC104TokenBucket::State CommandPacing();
 
 private:
 
     void executePeriodicTasks();
     void prepareParameters();
     bool prepareConnection();
+    TLSConfiguration createTlsConfiguration(const std::string& privateKeyFile, const std::string& clientCertFile,
+                                            const std::vector<std::string>& remoteCertFiles, const std::vector<std::string>& caCertFiles);
     void closeConnection();
 
+    /* next attempt after the reconnect delay, immediate after a lost connection */
+    void scheduleReconnect(bool connectionLost);
+
     void m_sendConnectionStatusAudit(const std::string& auditType);
 
     typedef enum {
@@ -86,14 +129,13 @@ private:
 
     std::mutex m_conLock;
     CS104_Connection m_connection = nullptr;
-    TLSConfiguration m_tlsConfig = nullptr;
+    IEC104TlsCache m_tlsCache; /* TLS configuration reused by the next connections while its files are unchanged */
 
     ConState m_connectionState = CON_STATE_IDLE;
 
     bool m_started = false;
     bool m_startDtSent = false;
 
-    bool m_giRequested = false; /* Ask for a request GI to be sent. Triggered by the receptions of messages flagges gi". */
     bool m_cnxLostStatusSent = false; /* cnxLostStatus sent after reconnect */
 
     bool m_timeSynchronized = false;
@@ -108,12 +150,68 @@ private:
     uint64_t m_nextGIStartTime = 0;
     bool m_endOfInitReceived = false;
 
+    /* adaptive GI cycle (application_layer/gi_adaptive) */
+    uint64_t m_coverageWindowStart = 0; /* start of the last GI cycle, skipped or not */
+    int m_skippedGiCycles = 0; /* consecutive skipped GI cycles */
+
+    bool skipInterrogationCycle(uint64_t currentTime);
+
+    /* send the read commands of the stale data points (application_layer/read_refresh) */
+    void executeReadRefresh(uint64_t currentTime);
+
     uint64_t m_delayExpirationTime = 0;
 
+    bool m_opened = false; /* the current connection was established, cleared when it is closed */
+    IEC104ReconnectBackoff m_reconnectBackoff; /* reconnect_delay, reconnect_max_delay and reconnect_jitter of the redundancy group */
+
+    std::mutex m_pathStatsLock;
+    PathStats m_pathStats = {0, 0, 0, 0};
+
+    uint64_t m_connectStartTime = 0; /* the TCP connection time is the first RTT sample of the path */
+    IEC104PathHealth m_pathHealth;
+    IEC104WindowTuner m_windowTuner; /* k, w and t2 of the connections, tuned with apci_auto_tune of the redundancy group */
+
+    /* apply the tuned w and t2 to the current connection (apci_auto_tune) */
+    void tuneWindow(uint64_t currentTime);
+
     std::shared_ptr<std::thread> m_conThread;
     void _conThread();
 
-    std::vector<int>::iterator m_listOfCA_it;
+    std::vector<int> m_listOfCAs; /* CAs interrogated one by one in the current GI cycle */
+    std::vector<int>::const_iterator m_listOfCA_it; /* next CA to interrogate */
+    bool m_partialInterrogation = false; /* current GI cycle only interrogates the requested CAs */
+
+    /* interrogation of a CA in a GI cycle with one request per CA (gi_all_ca or partial GI) */
+    struct CaInterrogation {
+        int ca;
+        int state; /* 1 - waiting for ACT_CON, 2 - waiting for ACT_TERM */
+        uint64_t lastActivity; /* request sent, ACT_CON or last response received */
+    };
+
+    std::atomic<bool> m_perCaInterrogation{false}; /* current GI cycle sends one request per CA */
+    std::atomic<int> m_interrogationGroup{0}; /* group of the current GI cycle: 0 - station, 1..16 - group (QOI 21..36) */
+    std::mutex m_caInterrogationsLock;
+    std::vector<CaInterrogation> m_caInterrogations; /* outstanding CA interrogations, at most application_layer/gi_parallel */
+    bool m_caInterrogationFailed = false; /* a CA interrogation of the current GI cycle failed */
+    uint64_t m_interrogationCycleStart = 0;
+
+    void startCaInterrogations(const std::vector<int>& cas);
+    void executeCaInterrogations(uint64_t currentTime);
+    void handleCaInterrogationMessage(CS101_ASDU asdu, CS101_CauseOfTransmission cot);
+
+    std::mutex m_requestedCAsLock;
+    std::vector<int> m_requestedCAs; /* CAs to interrogate after a change of the exchanged data */
+
+    void startPartialInterrogationCycle(const std::vector<int>& cas);
+
+    /* group interrogations (application_layer/gi_group_cycles), sent when no other GI is in progress */
+    uint64_t m_nextGroupGIStartTime[17] = {}; /* next GI of each group 1..16 */
+
+    void scheduleGroupInterrogations(uint64_t currentTime);
+    int dueGroupInterrogation(uint64_t currentTime) const;
+    void startGroupInterrogationCycle(int group, uint64_t currentTime);
+
+    IEC104TokenBucket m_commandPacing; /* cmd_rate and cmd_burst of the redundancy group */
 
     std::string m_path_letter; // A or B
     std::string m_last_audit; // Used to avoid sending the same audit multiple times in a row
@@ -122,6 +220,8 @@ private:
 
     static void m_connectionHandler(void* parameter, CS104_Connection connection,
                                  CS104_ConnectionEvent event);
+
+    static void m_rawMessageHandler(void* parameter, uint8_t* msg, int msgSize, bool sent);
 };
 
 #endif /* IEC104_CLIENT_CONNECTION_H */
\ No newline at end of file
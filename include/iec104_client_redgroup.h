@@ -50,6 +50,18 @@ public:
     int T1() const {return m_t1;};
     int T2() const {return m_t2;};
     int T3() const {return m_t3;};
+    int CmdRate() const {return m_cmdRate;};
+    int CmdBurst() const {return m_cmdBurst;};
+    int ConnectTimeout() const {return m_connectTimeout;};
+    int ReconnectDelay() const {return m_reconnectDelay;};
+    int ReconnectMaxDelay() const {return m_reconnectMaxDelay;};
+    int ReconnectJitter() const {return m_reconnectJitter;};
+    int BackupDelay() const {return m_backupDelay;};
+    bool AutoTune() const {return m_autoTune;};
+    int AutoTuneWMin() const {return m_autoTuneWMin;};
+    int AutoTuneWMax() const {return m_autoTuneWMax;};
+    int AutoTuneT2Min() const {return m_autoTuneT2Min;};
+    int AutoTuneKMax() const {return m_autoTuneKMax;};
 
     void K(int k) {m_k = k;};
     void W(int w) {m_w = w;};
@@ -57,6 +69,18 @@ public:
     void T1(int t1) {m_t1 = t1;};
     void T2(int t2) {m_t2 = t2;};
     void T3(int t3) {m_t3 = t3;};
+    void CmdRate(int cmdRate) {m_cmdRate = cmdRate;};
+    void CmdBurst(int cmdBurst) {m_cmdBurst = cmdBurst;};
+    void ConnectTimeout(int connectTimeout) {m_connectTimeout = connectTimeout;};
+    void ReconnectDelay(int reconnectDelay) {m_reconnectDelay = reconnectDelay;};
+    void ReconnectMaxDelay(int reconnectMaxDelay) {m_reconnectMaxDelay = reconnectMaxDelay;};
+    void ReconnectJitter(int reconnectJitter) {m_reconnectJitter = reconnectJitter;};
+    void BackupDelay(int backupDelay) {m_backupDelay = backupDelay;};
+    void AutoTune(bool autoTune) {m_autoTune = autoTune;};
+    void AutoTuneWMin(int wMin) {m_autoTuneWMin = wMin;};
+    void AutoTuneWMax(int wMax) {m_autoTuneWMax = wMax;};
+    void AutoTuneT2Min(int t2Min) {m_autoTuneT2Min = t2Min;};
+    void AutoTuneKMax(int kMax) {m_autoTuneKMax = kMax;};
 
     void UseTLS(bool useTls) {m_useTls = useTls;};
 
@@ -76,6 +100,20 @@ private:
     int m_t1 = 15;
     int m_t2 = 10;
     int m_t3 = 20;
+    int m_cmdRate = 0; /* commands per second sent to the outstation, 0 = no pacing */
+    int m_cmdBurst = 1; /* commands sent at once before the rate applies */
+    int m_connectTimeout = 10000; /* time in ms to wait for the TCP connection */
+    int m_reconnectDelay = 1000; /* time in ms before the second attempt, the first one is immediate */
+    int m_reconnectMaxDelay = 10000; /* the delay is doubled after each failed attempt up to this time in ms */
+    int m_reconnectJitter = 20; /* random change of the delay in percent */
+    int m_backupDelay = 5000; /* time in ms without active connection before the other connections are tried */
+
+    /* apci_auto_tune: w and t2 chosen from the RTT and the received frame rate, k raised when the window of the client is full */
+    bool m_autoTune = false;
+    int m_autoTuneWMin = 1;
+    int m_autoTuneWMax = 0; /* 0 = 2/3 of k */
+    int m_autoTuneT2Min = 1; /* s, the maximum is t2_timeout */
+    int m_autoTuneKMax = 0; /* 0 = k is not changed */
 };
 
 
@@ -0,0 +1,80 @@
+#ifndef IEC104_COMMAND_LATENCY_H
+#define IEC104_COMMAND_LATENCY_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+/*
+ * Latencies of the completed commands, by command type and by CA.
+ *
+ * For each command the time from the send to the ACT-CON and from the ACT-CON
+ * to the ACT-TERM are added to histograms with fixed buckets (upper bounds of
+ * 10 ms to 10 s, and a last bucket above 10 s). The commands whose ACT-CON or
+ * ACT-TERM timed out are counted.
+ */
+class IEC104CommandLatency
+{
+public:
+
+    static const int BUCKETS = 11;
+
+    /* upper bound in ms of each bucket but the last one */
+    static const uint64_t bucketBounds[BUCKETS - 1];
+
+    /* "le_10", ... "le_10000", "gt_10000" */
+    static std::string bucketName(int bucket);
+
+    struct Histogram
+    {
+        uint64_t counts[BUCKETS];
+        uint64_t count;
+        uint64_t total; /* sum of the latencies in ms */
+        uint64_t max;
+
+        void add(uint64_t latency);
+    };
+
+    struct Latencies
+    {
+        Histogram actCon; /* send to ACT-CON */
+        Histogram actTerm; /* ACT-CON to ACT-TERM */
+        uint64_t timeouts;
+    };
+
+    /**
+     * Add the latencies of a completed command
+     *
+     * @param actConLatency time in ms from the send to the ACT-CON, -1 = no ACT-CON
+     * @param actTermLatency time in ms from the ACT-CON to the ACT-TERM, -1 = no ACT-TERM
+     * @param timeout the ACT-CON or ACT-TERM timed out
+     */
+    void record(int typeId, int ca, int64_t actConLatency, int64_t actTermLatency, bool timeout);
+
+    std::map<int, Latencies> byType() const;
+
+    std::map<int, Latencies> byCa() const;
+
+    void clear();
+
+private:
+
+    static void add(Latencies& latencies, int64_t actConLatency, int64_t actTermLatency, bool timeout);
+
+    mutable std::mutex m_mutex;
+
+    std::map<int, Latencies> m_byType;
+    std::map<int, Latencies> m_byCa;
+};
+
+#endif /* IEC104_COMMAND_LATENCY_H */
@@ -0,0 +1,137 @@
+#ifndef IEC104_COMMAND_QUEUE_H
+#define IEC104_COMMAND_QUEUE_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * Commands waiting for a free slot when application_layer/cmd_parallel commands
+ * are outstanding (waiting for their ACT-CON/ACT-TERM).
+ *
+ * The queue is bounded (application_layer/cmd_queue/size) and has one FIFO per
+ * priority class. Commands are released by class, protection commands first.
+ * When the queue is full a new command replaces the last queued command of a
+ * lower class, or is rejected. A command still queued after its deadline is
+ * removed. A command that could not be sent keeps its place at the head of its
+ * class.
+ *
+ * Commands also wait here for a token when the commands sent to the outstation
+ * are paced (cmd_rate of the redundancy group).
+ *
+ * A set point command can replace a queued set point command of the same type
+ * and address (application_layer/cmd_queue/coalesce_setpoints), only the
+ * latest value is sent.
+ */
+class IEC104CommandQueue
+{
+public:
+
+    enum class Priority
+    {
+        PROTECTION,
+        OPERATOR,
+        BULK,
+        COUNT
+    };
+
+    struct Command
+    {
+        int typeId = 0; /* C_xx type with or without time tag */
+        int ca = 0;
+        int ioa = 0;
+        double value = 0; /* converted to the value type of the command */
+        bool select = false;
+        bool sbo = false; /* select before operate: sent as a select, the execute follows its positive ACT-CON */
+        long time = 0; /* time tag in ms, only for the C_xx_Tx types */
+
+        Priority priority = Priority::OPERATOR;
+        uint64_t deadline = 0; /* monotonic time in ms the command is removed if still queued, 0 = no deadline */
+        uint64_t queuedAt = 0; /* monotonic time in ms the command was queued */
+
+        uint32_t batchId = 0; /* 0 = IEC104Command operation */
+        uint32_t index = 0; /* position of the command in its batch */
+        uint64_t sendFailedSince = 0; /* time in ms of the first failed send, 0 = not tried */
+    };
+
+    struct Counters
+    {
+        uint64_t queued;
+        uint64_t dropped; /* replaced by a command of a higher class */
+        uint64_t rejected; /* queue full */
+        uint64_t expired;
+        uint64_t superseded; /* replaced by a newer set point */
+        uint64_t released; /* sent */
+        uint64_t waitTotal; /* time in ms the sent commands were queued */
+        uint64_t waitMax;
+    };
+
+    static const char* priorityName(Priority priority);
+
+    /* "protection", "operator" or "bulk" */
+    static bool priorityFromString(const std::string& name, Priority& priority);
+
+    /**
+     * Queue a command
+     *
+     * @param maxSize maximum number of queued commands
+     * @param dropped command of a lower class removed to make room for this one
+     *
+     * @return false when the queue is full of commands of the same or a higher class
+     */
+    bool push(const Command& command, size_t maxSize, std::vector<Command>& dropped);
+
+    /**
+     * Replace the queued command with the same type, CA and IOA. The new command
+     * keeps the place of the queued one, or goes to the end of its class when it
+     * has a different priority.
+     *
+     * @param superseded the replaced command
+     *
+     * @return false when no such command is queued
+     */
+    bool replace(const Command& command, Command& superseded);
+
+    /* the command returned by pop() could not be sent, it is released first in its class at the next try */
+    void pushFront(const Command& command);
+
+    /* the first command of the highest non empty class */
+    bool pop(Command& command);
+
+    /* the command returned by pop() was sent, its time in the queue is counted */
+    void released(const Command& command, uint64_t currentTime);
+
+    /* remove the commands whose deadline elapsed */
+    void expire(uint64_t currentTime, std::vector<Command>& expired);
+
+    size_t Size() const;
+
+    size_t Size(Priority priority) const;
+
+    Counters getCounters() const;
+
+    /* remove all the commands */
+    std::vector<Command> clear();
+
+private:
+
+    mutable std::mutex m_mutex;
+
+    std::deque<Command> m_commands[static_cast<int>(Priority::COUNT)];
+    size_t m_size = 0;
+
+    Counters m_counters = {0, 0, 0, 0, 0, 0, 0, 0};
+};
+
+#endif /* IEC104_COMMAND_QUEUE_H */
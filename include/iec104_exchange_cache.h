@@ -0,0 +1,81 @@
+#ifndef IEC104_EXCHANGE_CACHE_H
+#define IEC104_EXCHANGE_CACHE_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <string>
+#include <cstdint>
+
+struct IEC104ExchangeTable;
+
+/*
+ * Binary cache of the exchange table built from exchanged_data.
+ *
+ * The file is keyed by a hash of the exchanged_data JSON: when the plugin starts
+ * again with the same configuration the table is loaded from the memory mapped
+ * file instead of parsing and validating the JSON.
+ *
+ * File layout (native byte order):
+ *   Header | Record[recordCount] | label arena (labelBytes)
+ * Identical labels are stored once in the label arena.
+ */
+class IEC104ExchangeCache
+{
+public:
+
+    static const uint32_t FORMAT_VERSION = 4;
+
+    /**
+     * Stable hash (FNV-1a 64) of the exchanged_data JSON
+     */
+    static uint64_t hash(const std::string& json);
+
+    /**
+     * Default cache file of a service, in the Fledge data directory
+     */
+    static std::string defaultFile(const std::string& serviceName);
+
+    /**
+     * Load the exchange table from the cache file
+     *
+     * @return false when the file does not exist, is invalid or was created for another JSON
+     */
+    static bool load(const std::string& path, uint64_t jsonHash, IEC104ExchangeTable& exchangeTable);
+
+    static bool save(const std::string& path, uint64_t jsonHash, const IEC104ExchangeTable& exchangeTable);
+
+private:
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordCount;
+        uint64_t jsonHash;
+        uint64_t labelBytes;
+        uint64_t checksum; /* hash of records and label arena */
+    };
+
+    struct Record {
+        int32_t ca;
+        int32_t ioa;
+        uint32_t giGroups;
+        int16_t typeId;
+        uint8_t flags; /* IEC104ExchangeTable data point flags */
+        uint8_t reserved;
+        uint32_t labelOffset;
+        uint32_t labelLength;
+        uint32_t staleAfter;
+        uint32_t maxAge;
+    };
+
+    static uint64_t hash(const char* data, size_t length, uint64_t seed);
+};
+
+#endif /* IEC104_EXCHANGE_CACHE_H */
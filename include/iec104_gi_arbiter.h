@@ -0,0 +1,111 @@
+#ifndef IEC104_GI_ARBITER_H
+#define IEC104_GI_ARBITER_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+/*
+ * Requests of station GIs from the different sources (GI cycle, end of
+ * initialization, north services, CG triggering TS, operations).
+ *
+ * The requests received while a GI is pending are merged into it, and a
+ * requested GI is not started before application_layer/gi_min_interval is
+ * elapsed since the start of the previous GI. The requests are counted by
+ * source.
+ */
+class IEC104GiArbiter
+{
+public:
+
+    enum class Source
+    {
+        CYCLE,
+        END_OF_INIT,
+        NORTH_STATUS,
+        TRIGGER_SOUTH_GI,
+        OPERATION,
+        COUNT
+    };
+
+    struct SourceCounters
+    {
+        uint64_t requests;
+        uint64_t merged; /* covered by a GI already pending or started for another reason */
+        uint64_t deferred; /* delayed by the minimum interval */
+    };
+
+    /* result of an interrogation command of a single CA (operation) */
+    enum class Admission
+    {
+        MERGED, /* covered by the pending station GI */
+        SEND, /* to be sent now */
+        DEFER /* minimum interval not elapsed, to be sent later */
+    };
+
+    static const char* sourceName(Source source);
+
+    /* names of the sources of a mask returned by acquire() */
+    static std::string sourceNames(uint32_t sources);
+
+    /**
+     * Request a station GI, merged into the pending one if any
+     */
+    void request(Source source);
+
+    bool isPending() const;
+
+    /**
+     * Start the pending station GI when the minimum interval is elapsed
+     *
+     * @param minInterval minimum time in ms between the start of two GIs
+     * @param sources mask (bit = Source) of the requests served by the GI
+     * @return false when no GI can be started now
+     */
+    bool acquire(uint64_t currentTime, uint64_t minInterval, uint32_t& sources);
+
+    /**
+     * A GI was started without request (first GI of a connection) or for some CAs only
+     *
+     * @param station true when the GI covers the pending requests
+     */
+    void started(uint64_t currentTime, bool station);
+
+    /**
+     * Interrogation command of a single CA
+     */
+    Admission admit(Source source, uint64_t currentTime, uint64_t minInterval);
+
+    bool isIntervalElapsed(uint64_t currentTime, uint64_t minInterval) const;
+
+    SourceCounters getCounters(Source source) const;
+
+    uint64_t StartedCount() const;
+
+private:
+
+    bool intervalElapsed(uint64_t currentTime, uint64_t minInterval) const;
+
+    mutable std::mutex m_mutex;
+
+    uint32_t m_pendingSources = 0; /* bit = Source */
+    Source m_pendingFirst = Source::CYCLE; /* source of the first request of the pending GI */
+    bool m_pendingDeferred = false; /* the pending GI already waited for the minimum interval */
+
+    bool m_hasStarted = false;
+    uint64_t m_lastStart = 0;
+    uint64_t m_startedCount = 0;
+
+    SourceCounters m_counters[static_cast<int>(Source::COUNT)] = {};
+};
+
+#endif /* IEC104_GI_ARBITER_H */
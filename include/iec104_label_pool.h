@@ -0,0 +1,71 @@
+#ifndef IEC104_LABEL_POOL_H
+#define IEC104_LABEL_POOL_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+/*
+ * Interned labels of an exchange table: each distinct label is stored once and
+ * identified by its label id (position in the pool).
+ *
+ * The labels are kept in a deque so that the references returned by Label() are
+ * never invalidated by later insertions. The index refers to the stored labels,
+ * it does not hold a copy of them.
+ */
+class IEC104LabelPool
+{
+public:
+
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+
+    IEC104LabelPool() = default;
+
+    /* the index refers to the stored labels: a copy would refer to the labels of the original pool */
+    IEC104LabelPool(const IEC104LabelPool&) = delete;
+    IEC104LabelPool& operator=(const IEC104LabelPool&) = delete;
+
+    IEC104LabelPool(IEC104LabelPool&&) = default;
+    IEC104LabelPool& operator=(IEC104LabelPool&&) = default;
+
+    /**
+     * Add a label to the pool if it is not already present
+     *
+     * @return the label id
+     */
+    uint32_t intern(const std::string& label);
+
+    /**
+     * @return the label id or NOT_FOUND
+     */
+    uint32_t find(const std::string& label) const;
+
+    const std::string& Label(uint32_t labelId) const {return m_labels[labelId];};
+
+    size_t Size() const {return m_labels.size();};
+
+    /* approximate heap memory used by the labels and the index */
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+
+    std::deque<std::string> m_labels;
+
+    std::unordered_map<std::reference_wrapper<const std::string>, uint32_t,
+                       std::hash<std::string>, std::equal_to<std::string>> m_index; /* label -> label id */
+};
+
+#endif /* IEC104_LABEL_POOL_H */
@@ -0,0 +1,84 @@
+#ifndef IEC104_PATH_HEALTH_H
+#define IEC104_PATH_HEALTH_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <cstdint>
+
+/*
+ * Round trip time and frame errors of a path (connection of a redundancy group).
+ *
+ * The RTT is measured with the U-frames sent by the client (STARTDT, STOPDT and
+ * the TESTFR sent by the protocol stack after t3 without traffic) and their
+ * confirmation, and with the time to establish the TCP connection. It is
+ * smoothed as the TCP retransmission timer (RFC 6298). A U-frame not confirmed
+ * and a malformed frame received are errors, the error rate is an average over
+ * the recent frames.
+ *
+ * The cost of a path grows with its smoothed RTT, its RTT variation and its
+ * error rate (transport_layer/path_selection).
+ */
+class IEC104PathHealth
+{
+public:
+
+    struct Metrics
+    {
+        uint64_t rttSamples;
+        int64_t rtt; /* last RTT in ms, -1 = not measured */
+        int64_t srtt; /* smoothed RTT in ms, -1 = not measured */
+        int64_t rttVar;
+        int64_t rttMin;
+        uint64_t probes; /* U-frames sent */
+        uint64_t probesLost; /* not confirmed */
+        uint64_t frames; /* received */
+        uint64_t frameErrors; /* malformed frames received */
+        double errorRate; /* 0..1 */
+    };
+
+    /* APDU sent or received on the connection (raw message handler) */
+    void frame(const uint8_t* msg, int msgSize, bool sent, uint64_t currentTime);
+
+    /* RTT measured otherwise (TCP connection time) */
+    void rttSample(int64_t rtt);
+
+    /* new TCP connection: the RTT is measured again */
+    void connectionOpened();
+
+    /* a U-frame still waiting for its confirmation is lost */
+    void connectionClosed();
+
+    /* -1 = RTT not measured */
+    int64_t cost() const;
+
+    Metrics getMetrics() const;
+
+    /**
+     * @param hysteresis percent the cost of the candidate path must be lower than the current one
+     *
+     * @return true when the candidate path is measured and better than the current one (or the current one is not measured)
+     */
+    static bool isBetter(int64_t candidateCost, int64_t currentCost, int hysteresis);
+
+private:
+
+    void addRttSample(int64_t rtt);
+    void addFrameResult(bool error);
+
+    mutable std::mutex m_mutex;
+
+    Metrics m_metrics = {0, -1, -1, 0, -1, 0, 0, 0, 0, 0.0};
+
+    uint8_t m_pendingProbe = 0; /* control field of the U-frame waiting for its confirmation, 0 = none */
+    uint64_t m_pendingProbeTime = 0;
+};
+
+#endif /* IEC104_PATH_HEALTH_H */
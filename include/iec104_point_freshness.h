@@ -0,0 +1,81 @@
+#ifndef IEC104_POINT_FRESHNESS_H
+#define IEC104_POINT_FRESHNESS_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+struct IEC104ExchangeTable;
+
+/*
+ * Time of the last value received for each data point of the exchange table,
+ * whatever the cause of transmission (spontaneous, periodic, GI or read response).
+ *
+ * The times are stored with a one second resolution, indexed by point id. When
+ * the exchange table is replaced the times of the addresses that still exist
+ * are kept.
+ */
+class IEC104PointFreshness
+{
+public:
+
+    struct StalePoint
+    {
+        int ca;
+        int ioa;
+        uint64_t lastRefresh; /* monotonic time in ms, 0 = never refreshed */
+    };
+
+    struct Coverage
+    {
+        size_t points; /* monitored data points of the station group */
+        size_t fresh; /* data points refreshed since the start of the window */
+        std::vector<StalePoint> stale; /* least recently refreshed data points first */
+    };
+
+    /**
+     * Record a value received for a data point
+     *
+     * @param time monotonic time in ms
+     */
+    void refresh(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint32_t pointId, uint64_t time);
+
+    /**
+     * @return monotonic time in ms of the last value received for a data point, 0 = never
+     */
+    uint64_t lastRefresh(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint32_t pointId);
+
+    /**
+     * Count the monitored data points of the station group refreshed since a given time
+     *
+     * @param since monotonic time in ms of the start of the window
+     * @param maxStale maximum number of stale data points returned
+     */
+    Coverage coverage(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint64_t since, size_t maxStale);
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+
+    /* keep the refresh times of the addresses that exist in the new table */
+    void setTable(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable);
+
+    mutable std::mutex m_mutex;
+
+    std::shared_ptr<const IEC104ExchangeTable> m_exchangeTable;
+    std::vector<uint32_t> m_lastRefresh; /* time in s + 1 (0 = never), indexed by point id of m_exchangeTable */
+};
+
+#endif /* IEC104_POINT_FRESHNESS_H */
@@ -0,0 +1,123 @@
+#ifndef IEC104_READ_SCHEDULER_H
+#define IEC104_READ_SCHEDULER_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "iec104_timer_wheel.h"
+
+struct IEC104ExchangeTable;
+class IEC104PointFreshness;
+
+/*
+ * Read commands (C_RD_NA_1) for the data points not refreshed for longer than
+ * their stale_after age.
+ *
+ * Each data point with a stale_after age is in a hashed timer wheel with one
+ * slot per second, at the time it becomes stale if no value is received. When
+ * its slot expires the time of the last value received is checked: the point
+ * is either moved to its new expiry time or queued for a read. A tick only
+ * visits the entries of the expired slots.
+ *
+ * Queued reads are released while the number of reads waiting for their
+ * response stays below the maximum. A read is complete when the value is
+ * received with COT=5 (request), when the read is rejected or on timeout, and
+ * the point goes back to the wheel.
+ */
+class IEC104ReadScheduler
+{
+public:
+
+    struct Read
+    {
+        int ca;
+        int ioa;
+    };
+
+    struct Counters
+    {
+        uint64_t sent;
+        uint64_t answered;
+        uint64_t rejected;
+        uint64_t timedOut;
+    };
+
+    explicit IEC104ReadScheduler(size_t wheelSlots = 256);
+
+    /**
+     * Queue a read of a data point, whatever its age
+     */
+    void request(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, int ca, int ioa, uint64_t currentTime);
+
+    /**
+     * Expire the slots of the wheel up to the current time and release the queued reads
+     *
+     * @param defaultStaleAfter age in s of the data points without stale_after (0 = not read)
+     * @param maxOutstanding maximum number of reads waiting for their response
+     * @param timeout time in ms to wait for the response of a read
+     * @param reads reads to send
+     */
+    void tick(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, IEC104PointFreshness& freshness, uint64_t currentTime,
+              int defaultStaleAfter, size_t maxOutstanding, uint64_t timeout, std::vector<Read>& reads);
+
+    /* a read returned by tick() could not be sent, it is released again at the next tick */
+    void sendFailed(const Read& read);
+
+    /* a value was received with COT=5 (request) */
+    void readAnswered(int ca, int ioa, uint64_t currentTime);
+
+    /* the read command was rejected by the server */
+    void readRejected(int ca, int ioa, uint64_t currentTime);
+
+    Counters getCounters() const;
+
+    size_t QueuedCount() const;
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+
+    struct OutstandingRead
+    {
+        int ca;
+        int ioa;
+        uint64_t sentTime;
+    };
+
+    void rebuild(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, IEC104PointFreshness& freshness, uint64_t currentTime);
+
+    uint32_t staleAfter(uint32_t pointId) const;
+
+    /* the read of a data point is complete, the point goes back to the wheel */
+    bool completeRead(int ca, int ioa, uint64_t currentTime);
+
+    mutable std::mutex m_mutex;
+
+    std::shared_ptr<const IEC104ExchangeTable> m_exchangeTable;
+    int m_defaultStaleAfter = 0;
+    uint32_t m_startTime = 0; /* time in s the wheel was built, data points never refreshed are stale after startTime + stale_after */
+
+    IEC104TimerWheel m_wheel; /* data points waiting to become stale */
+    std::vector<bool> m_queued; /* data points queued or waiting for the response of their read */
+
+    std::deque<Read> m_queue; /* data points to read */
+    std::vector<OutstandingRead> m_outstanding;
+
+    Counters m_counters = {0, 0, 0, 0};
+};
+
+#endif /* IEC104_READ_SCHEDULER_H */
@@ -0,0 +1,52 @@
+#ifndef IEC104_RECONNECT_BACKOFF_H
+#define IEC104_RECONNECT_BACKOFF_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <random>
+#include <cstdint>
+
+/*
+ * Delays between the connection attempts of a connection (reconnect_delay,
+ * reconnect_max_delay and reconnect_jitter of the redundancy group).
+ *
+ * The first attempt after a lost connection is immediate. The following
+ * attempts wait reconnect_delay, doubled after each failed attempt up to
+ * reconnect_max_delay. Each delay is randomly changed by up to
+ * reconnect_jitter percent so that the gateways connected to the same
+ * outstation do not reconnect all at the same time.
+ */
+class IEC104ReconnectBackoff
+{
+public:
+
+    IEC104ReconnectBackoff(int initialDelay, int maxDelay, int jitter);
+
+    /* delay in ms before the next attempt */
+    uint64_t nextDelay();
+
+    /* the connection was established, the next attempt is immediate */
+    void reset();
+
+    /* failed attempts since the last reset */
+    int Failures() const {return m_failures;};
+
+private:
+
+    uint64_t m_initialDelay;
+    uint64_t m_maxDelay;
+    int m_jitter; /* percent */
+
+    int m_failures = 0;
+
+    std::minstd_rand m_random;
+};
+
+#endif /* IEC104_RECONNECT_BACKOFF_H */
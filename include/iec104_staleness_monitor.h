@@ -0,0 +1,77 @@
+#ifndef IEC104_STALENESS_MONITOR_H
+#define IEC104_STALENESS_MONITOR_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "iec104_timer_wheel.h"
+
+struct IEC104ExchangeTable;
+class IEC104ClientConfig;
+class IEC104PointFreshness;
+
+/*
+ * Data points not refreshed for longer than their maximum age (max_age of the
+ * data point, or application_layer/max_age of its type).
+ *
+ * Each checked data point is in a timer wheel at the time it exceeds its
+ * maximum age if no value is received. When its slot expires the time of the
+ * last value received is checked: the point is either moved to its new expiry
+ * time or reported once as non topical. A reported point is checked again
+ * after its maximum age and reported again after it was refreshed and got
+ * stale again.
+ */
+class IEC104StalenessMonitor
+{
+public:
+
+    explicit IEC104StalenessMonitor(size_t wheelSlots = 256);
+
+    /**
+     * Expire the slots of the wheel up to the current time
+     *
+     * @param currentTime monotonic time in ms
+     * @param stalePoints point ids of exchangeTable that exceeded their maximum age since the last call
+     */
+    void tick(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, const IEC104ClientConfig& config,
+              IEC104PointFreshness& freshness, uint64_t currentTime, std::vector<uint32_t>& stalePoints);
+
+    /* the checks start again from the current time (new active connection) */
+    void restart();
+
+    uint64_t StaleCount() const;
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+
+    void rebuild(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, const IEC104ClientConfig& config,
+                 IEC104PointFreshness& freshness, uint32_t now);
+
+    mutable std::mutex m_mutex;
+
+    std::shared_ptr<const IEC104ExchangeTable> m_exchangeTable;
+    bool m_restart = false;
+    uint32_t m_startTime = 0; /* time in s the checks started, data points never refreshed exceed their age after startTime + max_age */
+
+    IEC104TimerWheel m_wheel;
+    std::vector<uint32_t> m_maxAge; /* effective maximum age in s, 0 = not checked */
+    std::vector<uint32_t> m_reportedAt; /* time in s + 1 the point was reported as non topical, 0 = not reported */
+
+    uint64_t m_staleCount = 0;
+};
+
+#endif /* IEC104_STALENESS_MONITOR_H */
@@ -0,0 +1,70 @@
+#ifndef IEC104_TIMER_WHEEL_H
+#define IEC104_TIMER_WHEEL_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <vector>
+#include <cstdint>
+
+/*
+ * Hashed timer wheel of data points, with one slot per second.
+ *
+ * A data point has at most one expiry time. Rescheduling or cancelling a point
+ * leaves its old entry in the wheel, the entry is dropped when its slot is
+ * visited. Expiring the wheel only visits the slots of the elapsed seconds.
+ *
+ * Not thread safe, the owner serializes the calls.
+ */
+class IEC104TimerWheel
+{
+public:
+
+    explicit IEC104TimerWheel(size_t slots = 256);
+
+    /**
+     * Remove all the entries
+     *
+     * @param points number of point ids
+     * @param currentTime time in s, the first expiry time is currentTime + 1
+     */
+    void reset(uint32_t points, uint32_t currentTime);
+
+    /* expiry time in s, moved to the next second when already elapsed */
+    void schedule(uint32_t pointId, uint32_t expiry);
+
+    void cancel(uint32_t pointId) {m_expiry[pointId] = 0;};
+
+    bool isScheduled(uint32_t pointId) const {return m_expiry[pointId] != 0;};
+
+    /**
+     * Get the data points expired up to the current time, they are no longer scheduled
+     *
+     * @param currentTime time in s
+     */
+    void expire(uint32_t currentTime, std::vector<uint32_t>& expired);
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+
+    struct Entry
+    {
+        uint32_t pointId;
+        uint32_t expiry; /* the entry is obsolete when it differs from m_expiry[pointId] */
+    };
+
+    std::vector<std::vector<Entry>> m_slots;
+    uint32_t m_time = 0; /* last expired second */
+    std::vector<uint32_t> m_expiry; /* expiry time in s of each data point, 0 = not scheduled */
+};
+
+#endif /* IEC104_TIMER_WHEEL_H */
@@ -0,0 +1,67 @@
+#ifndef IEC104_TLS_CACHE_H
+#define IEC104_TLS_CACHE_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <lib60870/tls_config.h>
+
+/*
+ * TLS configuration of a connection kept across reconnects.
+ *
+ * Building a TLS configuration reads and parses the private key and the
+ * certificates. The configuration is built once and reused by the next
+ * connections, which also keeps the TLS session to resume, until one of its
+ * files is replaced or modified (size, modification time or inode changed).
+ */
+class IEC104TlsCache
+{
+public:
+
+    IEC104TlsCache() = default;
+    ~IEC104TlsCache();
+
+    IEC104TlsCache(const IEC104TlsCache&) = delete;
+    IEC104TlsCache& operator=(const IEC104TlsCache&) = delete;
+
+    /**
+     * Configuration built from these files
+     *
+     * @return nullptr when no configuration is cached or one of the files changed since it was built
+     */
+    TLSConfiguration get(const std::vector<std::string>& files);
+
+    /* keep a configuration built from these files, the previous one is destroyed */
+    void set(TLSConfiguration tlsConfig, const std::vector<std::string>& files);
+
+    /* destroy the cached configuration */
+    void clear();
+
+    uint64_t Hits() const {return m_hits;};
+    uint64_t Loads() const {return m_loads;};
+
+    /* size, modification time and inode of a file, empty when it cannot be read */
+    static std::string fingerprint(const std::string& file);
+
+private:
+
+    TLSConfiguration m_tlsConfig = nullptr;
+
+    std::vector<std::string> m_files;
+    std::vector<std::string> m_fingerprints; /* of m_files when the configuration was built */
+
+    uint64_t m_hits = 0;
+    uint64_t m_loads = 0;
+};
+
+#endif /* IEC104_TLS_CACHE_H */
@@ -0,0 +1,68 @@
+#ifndef IEC104_TOKEN_BUCKET_H
+#define IEC104_TOKEN_BUCKET_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <cstdint>
+
+/*
+ * Pacing of the commands sent to the outstation of a redundancy group
+ * (cmd_rate and cmd_burst of the group).
+ *
+ * The bucket holds up to burst tokens and gets rate tokens per second. A
+ * command is sent only when it can take a token, otherwise it waits in the
+ * command queue. A rate of 0 disables the pacing.
+ */
+class IEC104TokenBucket
+{
+public:
+
+    struct State
+    {
+        int rate; /* tokens per second, 0 = no pacing */
+        int burst;
+        int tokens; /* whole tokens available */
+        uint64_t taken;
+        uint64_t refused; /* a command had to wait for a token */
+    };
+
+    IEC104TokenBucket(int rate, int burst);
+
+    /**
+     * Take a token for a command
+     *
+     * @param currentTime monotonic time in ms
+     * @return false when the bucket is empty
+     */
+    bool take(uint64_t currentTime);
+
+    /* the command that took a token could not be sent */
+    void refund();
+
+    State getState(uint64_t currentTime);
+
+private:
+
+    void refill(uint64_t currentTime);
+
+    std::mutex m_mutex;
+
+    int m_rate;
+    int m_burst;
+
+    uint64_t m_milliTokens; /* tokens in 1/1000, a rate of n tokens per second adds n per ms */
+    uint64_t m_lastRefill = 0; /* time in ms of the last refill, 0 = bucket not used yet (full) */
+
+    uint64_t m_taken = 0;
+    uint64_t m_refused = 0;
+};
+
+#endif /* IEC104_TOKEN_BUCKET_H */
@@ -0,0 +1,116 @@
+#ifndef IEC104_WINDOW_TUNER_H
+#define IEC104_WINDOW_TUNER_H
+
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <mutex>
+#include <cstdint>
+
+/*
+ * Window utilization and tuning of the k, w and t2 parameters of a path
+ * (apci_auto_tune of the redundancy group).
+ *
+ * The I-frames and S-frames of the connection give the number of I-frames
+ * received and not acknowledged yet (window of the outstation) and the number of
+ * I-frames sent and not acknowledged by the outstation (window of the client).
+ *
+ * Every tuning interval w is chosen from the received frame rate and the RTT of
+ * the path: the frames received during a round trip are subtracted from k so
+ * that the acknowledgement reaches the outstation before its window is full.
+ * t2 is the time to receive w frames, an acknowledgement is not delayed longer
+ * on a slow link. When the window of the client was full k is doubled, up to
+ * k_max.
+ *
+ * The tuned parameters are used by the next connection: the protocol stack
+ * reads them from its receive thread, they are not changed on a running
+ * connection.
+ */
+class IEC104WindowTuner
+{
+public:
+
+    struct Parameters
+    {
+        int k;
+        int w;
+        int t2; /* s */
+    };
+
+    struct Bounds
+    {
+        int wMin;
+        int wMax; /* 0 = 2/3 of k */
+        int t2Min;
+        int t2Max;
+        int kMax; /* 0 = k is not changed */
+    };
+
+    struct Stats
+    {
+        Parameters parameters; /* of the current connection */
+        Parameters next; /* of the next connection, tuned */
+        double rxRate; /* I-frames received per s in the last tuning interval */
+        uint64_t rxFrames; /* I-frames received */
+        uint64_t acksSent; /* S-frames sent, and I-frames sent acknowledging received frames */
+        uint64_t txFrames; /* I-frames sent */
+        uint64_t txWindowFull; /* I-frames sent that filled the window of the client */
+        double rxUtilization; /* average frames not acknowledged / k in percent, at each received I-frame */
+        double rxUtilizationMax;
+        double txUtilization; /* average frames not acknowledged / k in percent, at each sent I-frame */
+        double txUtilizationMax;
+    };
+
+    IEC104WindowTuner(const Parameters& parameters, const Bounds& bounds);
+
+    /* APDU sent or received on the connection (raw message handler) */
+    void frame(const uint8_t* msg, int msgSize, bool sent);
+
+    /* parameters of a new connection, the tuned ones */
+    Parameters connectionParameters();
+
+    /**
+     * Tune w and t2 of the next connection at the end of a tuning interval
+     *
+     * @param srtt smoothed RTT of the path in ms, -1 = not measured
+     * @param parameters new parameters of the next connection
+     *
+     * @return true when w or t2 changed
+     */
+    bool tune(uint64_t currentTime, int64_t srtt, Parameters& parameters);
+
+    /* the tuned parameters differ from the ones of the current connection */
+    bool isChangePending() const;
+
+    Stats getStats() const;
+
+    static const uint64_t TUNE_INTERVAL = 10000; /* ms */
+
+private:
+
+    mutable std::mutex m_mutex;
+
+    Parameters m_parameters; /* of the current connection */
+    Parameters m_next; /* of the next connection */
+    Bounds m_bounds;
+
+    uint64_t m_intervalStart = 0;
+    uint64_t m_intervalRxFrames = 0;
+    uint64_t m_intervalTxWindowFull = 0;
+
+    int m_rxUnacked = 0; /* I-frames received since the last acknowledgement sent */
+    int m_txNext = 0; /* send sequence number of the next I-frame */
+    int m_txAcked = 0; /* last receive sequence number from the outstation */
+
+    Stats m_stats;
+    double m_rxUtilizationTotal = 0.0;
+    double m_txUtilizationTotal = 0.0;
+};
+
+#endif /* IEC104_WINDOW_TUNER_H */
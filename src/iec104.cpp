@@ -18,6 +18,7 @@
 #include "iec104_client.h"
 #include "iec104_client_redgroup.h"
 #include "iec104_client_config.h"
+#include "iec104_exchange_cache.h"
 #include "iec104_utility.h"
 
 
@@ -35,9 +36,50 @@ void IEC104::setJsonConfig(const std::string& stack_configuration,
 {
     m_config = std::make_shared<IEC104ClientConfig>();
 
+    if (m_service_name.empty() == false) {
+        m_config->setExchangeTableCache(IEC104ExchangeCache::defaultFile(m_service_name));
+    }
+
     m_config->importProtocolConfig(stack_configuration);
     m_config->importExchangeConfig(msg_configuration);
     m_config->importTlsConfig(tls_configuration);
+
+    m_stackConfiguration = stack_configuration;
+    m_msgConfigurationHash = std::hash<std::string>()(msg_configuration);
+    m_tlsConfiguration = tls_configuration;
+}
+
+void IEC104::reconfigure(const std::string& stack_configuration,
+                         const std::string& msg_configuration,
+                         const std::string& tls_configuration)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104::reconfigure -";
+
+    if ((m_client == nullptr) || !m_config->isConfigComplete() ||
+        (stack_configuration != m_stackConfiguration) || (tls_configuration != m_tlsConfiguration)) {
+        Iec104Utility::log_info("%s protocol_stack or tls changed -> restart", beforeLog.c_str());
+
+        stop();
+        setJsonConfig(stack_configuration, msg_configuration, tls_configuration);
+        start();
+
+        return;
+    }
+
+    size_t msgConfigurationHash = std::hash<std::string>()(msg_configuration);
+
+    if (msgConfigurationHash == m_msgConfigurationHash) {
+        Iec104Utility::log_info("%s Configuration not changed", beforeLog.c_str());
+        return;
+    }
+
+    std::vector<int> changedCAs;
+
+    if (m_config->reloadExchangeConfig(msg_configuration, changedCAs)) {
+        m_msgConfigurationHash = msgConfigurationHash;
+
+        m_client->exchangeTableChanged(changedCAs);
+    }
 }
 
 void IEC104::start()
@@ -87,7 +129,7 @@ void IEC104::stop()
  * @param points    The points in the reading we must create
  */
 // void IEC104::ingest(Reading& reading) { (*m_ingest)(m_data, reading); }
-void IEC104::ingest(std::string assetName, std::vector<Datapoint*>& points)
+void IEC104::ingest(const std::string& assetName, std::vector<Datapoint*>& points)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104::ingest -";
     if (!m_ingest) {
@@ -125,6 +167,33 @@ enum CommandParameters{
     VALUE
 };
 
+// number of parameters of a command, the commands of a batch follow each other
+static const int COMMAND_PARAMETER_COUNT = VALUE + 1;
+
+// optional priority class of an IEC104Command operation, after the command parameters
+static const int PRIORITY = COMMAND_PARAMETER_COUNT;
+
+static IEC104CommandQueue::Priority commandPriority(int count, PLUGIN_PARAMETER** params)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104::commandPriority -";
+
+    IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR;
+
+    if ((count > PRIORITY) && (params[PRIORITY] != nullptr)) {
+        std::string name = params[PRIORITY]->value;
+
+        if(name[0] == '"'){
+            name = name.substr(1,name.length()-2);
+        }
+
+        if (!IEC104CommandQueue::priorityFromString(name, priority)) {
+            Iec104Utility::log_warn("%s invalid priority %s -> using default value (operator)", beforeLog.c_str(), name.c_str());
+        }
+    }
+
+    return priority;
+}
+
 bool
 IEC104::m_singleCommandOperation(int count, PLUGIN_PARAMETER** params, bool withTime) const
 {
@@ -163,7 +232,7 @@ IEC104::m_singleCommandOperation(int count, PLUGIN_PARAMETER** params, bool with
         Iec104Utility::log_debug("%s operate: single command - CA: %i IOA: %i value: %i select: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, select, time);
 
-        return m_client->sendSingleCommand(ca, ioa, value, withTime, select, time);
+        return m_client->sendSingleCommand(ca, ioa, value, withTime, select, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -209,7 +278,7 @@ IEC104::m_doubleCommandOperation(int count, PLUGIN_PARAMETER** params, bool with
         Iec104Utility::log_debug("%s operate: double command - CA: %i IOA: %i value: %i select: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, select, time);
 
-        return m_client->sendDoubleCommand(ca, ioa, value, withTime, select, time);
+        return m_client->sendDoubleCommand(ca, ioa, value, withTime, select, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -255,7 +324,7 @@ IEC104::m_stepCommandOperation(int count, PLUGIN_PARAMETER** params, bool withTi
         Iec104Utility::log_debug("%s operate: step command - CA: %i IOA: %i value: %i select: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, select, time);
 
-        return m_client->sendStepCommand(ca, ioa, value, withTime, select, time);
+        return m_client->sendStepCommand(ca, ioa, value, withTime, select, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -297,7 +366,7 @@ IEC104::m_setpointNormalized(int count, PLUGIN_PARAMETER** params, bool withTime
         Iec104Utility::log_debug("%s operate: setpoint command (normalized) - CA: %i IOA: %i value: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, time);
 
-        return m_client->sendSetpointNormalized(ca, ioa, value, withTime, time);
+        return m_client->sendSetpointNormalized(ca, ioa, value, withTime, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -339,7 +408,7 @@ IEC104::m_setpointScaled(int count, PLUGIN_PARAMETER** params, bool withTime) co
         Iec104Utility::log_debug("%s operate: setpoint command (scaled) - CA: %i IOA: %i value: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, time);
 
-        return m_client->sendSetpointScaled(ca, ioa, value, withTime, time);
+        return m_client->sendSetpointScaled(ca, ioa, value, withTime, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -380,7 +449,7 @@ IEC104::m_setpointShort(int count, PLUGIN_PARAMETER** params, bool withTime) con
         Iec104Utility::log_debug("%s operate: setpoint command (short) - CA: %i IOA: %i value: %i timestamp: %ld", beforeLog.c_str(),
                                 ca, ioa, value, time);
 
-        return m_client->sendSetpointShort(ca, ioa, value, withTime, time);
+        return m_client->sendSetpointShort(ca, ioa, value, withTime, time, commandPriority(count, params));
     }
     else {
         Iec104Utility::log_error("%s invalid number of parameters: %d, but expected 9", beforeLog.c_str(), count);
@@ -388,6 +457,136 @@ IEC104::m_setpointShort(int count, PLUGIN_PARAMETER** params, bool withTime) con
     }
 }
 
+bool
+IEC104::m_commandBatchOperation(int count, PLUGIN_PARAMETER** params) const
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104::m_commandBatchOperation -";
+
+    if ((count < COMMAND_PARAMETER_COUNT) || (count % COMMAND_PARAMETER_COUNT != 0)) {
+        Iec104Utility::log_error("%s invalid number of parameters: %d, but expected a multiple of %d", beforeLog.c_str(), count,
+                                COMMAND_PARAMETER_COUNT);
+        return false;
+    }
+
+    std::vector<IEC104CommandQueue::Command> commands;
+
+    for (int i = 0; i < count / COMMAND_PARAMETER_COUNT; i++) {
+        PLUGIN_PARAMETER** commandParams = params + (i * COMMAND_PARAMETER_COUNT);
+
+        if ((commandParams[TYPE] == nullptr) || (commandParams[CA] == nullptr) || (commandParams[IOA] == nullptr) ||
+            (commandParams[VALUE] == nullptr)) {
+            Iec104Utility::log_error("%s command %d: missing type, ca, ioa or value -> ignore batch", beforeLog.c_str(), i);
+            return false;
+        }
+
+        std::string type = commandParams[TYPE]->value;
+
+        if(type[0] == '"'){
+            type = type.substr(1,type.length()-2);
+        }
+
+        IEC104CommandQueue::Command command;
+
+        command.typeId = m_config->getTypeIdFromString(type);
+        command.ca = atoi(commandParams[CA]->value.c_str());
+        command.ioa = atoi(commandParams[IOA]->value.c_str());
+        command.value = atof(commandParams[VALUE]->value.c_str());
+        command.index = static_cast<uint32_t>(i);
+
+        // select or execute, 0 = execute, otherwise = select (single, double and step commands)
+        if (commandParams[SE] != nullptr) {
+            command.select = static_cast<bool>(atoi(commandParams[SE]->value.c_str()));
+        }
+
+        bool withTime = false;
+
+        switch (command.typeId) {
+            case C_SC_NA_1: case C_DC_NA_1: case C_RC_NA_1: case C_SE_NA_1: case C_SE_NB_1: case C_SE_NC_1:
+                break;
+            case C_SC_TA_1: case C_DC_TA_1: case C_RC_TA_1: case C_SE_TA_1: case C_SE_TB_1: case C_SE_TC_1:
+                withTime = true;
+                break;
+            default:
+                Iec104Utility::log_error("%s command %d: unrecognised command type %s -> ignore batch", beforeLog.c_str(), i, type.c_str());
+                return false;
+        }
+
+        if (withTime) {
+            try {
+                command.time = std::stol((commandParams[TS] != nullptr) ? commandParams[TS]->value : "");
+            } catch (const std::exception &e) {
+                Iec104Utility::log_error("%s command %d (CA: %i IOA: %i) Cannot convert time to integer: %s -> ignore batch",
+                                        beforeLog.c_str(), i, command.ca, command.ioa, e.what());
+                return false;
+            }
+        }
+
+        commands.push_back(command);
+    }
+
+    Iec104Utility::log_debug("%s operate: batch of %lu commands", beforeLog.c_str(), commands.size());
+
+    return m_client->sendCommandBatch(commands);
+}
+
+bool
+IEC104::m_selectBeforeOperateOperation(int count, PLUGIN_PARAMETER** params) const
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104::m_selectBeforeOperateOperation -";
+
+    if (count < COMMAND_PARAMETER_COUNT) {
+        Iec104Utility::log_error("%s invalid number of parameters: %d, but expected %d", beforeLog.c_str(), count, COMMAND_PARAMETER_COUNT);
+        return false;
+    }
+
+    if ((params[TYPE] == nullptr) || (params[CA] == nullptr) || (params[IOA] == nullptr) || (params[VALUE] == nullptr)) {
+        Iec104Utility::log_error("%s missing type, ca, ioa or value", beforeLog.c_str());
+        return false;
+    }
+
+    std::string type = params[TYPE]->value;
+
+    if(type[0] == '"'){
+        type = type.substr(1,type.length()-2);
+    }
+
+    IEC104CommandQueue::Command command;
+
+    command.typeId = m_config->getTypeIdFromString(type);
+    command.ca = atoi(params[CA]->value.c_str());
+    command.ioa = atoi(params[IOA]->value.c_str());
+    command.value = atof(params[VALUE]->value.c_str());
+    command.priority = commandPriority(count, params);
+
+    bool withTime = false;
+
+    switch (command.typeId) {
+        case C_SC_NA_1: case C_DC_NA_1: case C_RC_NA_1:
+            break;
+        case C_SC_TA_1: case C_DC_TA_1: case C_RC_TA_1:
+            withTime = true;
+            break;
+        default:
+            Iec104Utility::log_error("%s Unrecognised select before operate command type %s", beforeLog.c_str(), type.c_str());
+            return false;
+    }
+
+    if (withTime) {
+        try {
+            command.time = std::stol((params[TS] != nullptr) ? params[TS]->value : "");
+        } catch (const std::exception &e) {
+            Iec104Utility::log_error("%s (CA: %i IOA: %i) Cannot convert time to integer: %s",
+                                    beforeLog.c_str(), command.ca, command.ioa, e.what());
+            return false;
+        }
+    }
+
+    Iec104Utility::log_debug("%s operate: select before operate %s - CA: %i IOA: %i value: %i timestamp: %ld", beforeLog.c_str(),
+                            type.c_str(), command.ca, command.ioa, static_cast<int>(command.value), command.time);
+
+    return m_client->sendSelectBeforeOperate(command);
+}
+
 // Utility function for logging
 static std::pair<std::string, std::string> paramsToStr(PLUGIN_PARAMETER** params, int count) {
 	std::string namesStr("[");
@@ -430,9 +629,15 @@ IEC104::operation(const std::string& operation, int count, PLUGIN_PARAMETER** pa
         return false;
     }
 
-    auto namesParamsPair = paramsToStr(params, count);
-    Iec104Utility::log_info("%s Received operation: {type: \"%s\", nbParams=%d, names=%s, parameters=%s}",
-                            beforeLog.c_str(), operation.c_str(), count, namesParamsPair.first.c_str(), namesParamsPair.second.c_str());
+    if (operation == "IEC104CommandBatch") {
+        // a batch can hold hundreds of commands, the parameters are not logged
+        Iec104Utility::log_info("%s Received operation: {type: \"%s\", nbParams=%d}", beforeLog.c_str(), operation.c_str(), count);
+    }
+    else {
+        auto namesParamsPair = paramsToStr(params, count);
+        Iec104Utility::log_info("%s Received operation: {type: \"%s\", nbParams=%d, names=%s, parameters=%s}",
+                                beforeLog.c_str(), operation.c_str(), count, namesParamsPair.first.c_str(), namesParamsPair.second.c_str());
+    }
 
     if (operation == "CS104_Connection_sendInterrogationCommand")
     {
@@ -477,9 +682,27 @@ IEC104::operation(const std::string& operation, int count, PLUGIN_PARAMETER** pa
                 return false;
         }
     }
+    else if (operation == "IEC104CommandBatch") {
+        return m_commandBatchOperation(count, params);
+    }
+    else if (operation == "IEC104CommandSBO") {
+        return m_selectBeforeOperateOperation(count, params);
+    }
     else if (operation == "request_connection_status") {
         return m_client->sendConnectionStatus();
     }
+    else if (operation == "request_address_report") {
+        return m_client->sendAddressReport();
+    }
+    else if (operation == "request_memory_report") {
+        return m_client->sendMemoryReport();
+    }
+    else if (operation == "request_command_report") {
+        return m_client->sendCommandReport();
+    }
+    else if (operation == "request_path_report") {
+        return m_client->sendPathReport();
+    }
     else if (operation == "north_status") {
         std::string north_status_type = params[0]->value;
         if(north_status_type[0] == '"'){
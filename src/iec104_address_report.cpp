@@ -0,0 +1,133 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_address_report.h"
+#include "iec104_client_config.h"
+
+IEC104AddressReport::IEC104AddressReport(size_t capacity, int maxWarningsPerPeriod):
+    m_capacity(capacity),
+    m_maxWarningsPerPeriod(maxWarningsPerPeriod)
+{
+    m_entries.reserve(capacity);
+}
+
+bool
+IEC104AddressReport::add(Error error, int ca, int ioa, int typeId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_totalCount++;
+    m_periodCount++;
+
+    uint64_t entryKey = key(error, ca, ioa);
+
+    auto it = m_index.find(entryKey);
+
+    if (it != m_index.end()) {
+        Entry& entry = m_entries[it->second];
+
+        entry.count++;
+        entry.typeId = typeId;
+
+        return false;
+    }
+
+    if (m_entries.size() < m_capacity) {
+        m_index[entryKey] = m_entries.size();
+        m_entries.push_back({error, ca, ioa, typeId, 1});
+    }
+    else if (m_capacity > 0) {
+        /* replace the least frequent address, it inherits the count of the replaced one */
+        auto minEntry = std::min_element(m_entries.begin(), m_entries.end(),
+                                         [](const Entry& a, const Entry& b) { return a.count < b.count; });
+
+        m_index.erase(key(minEntry->error, minEntry->ca, minEntry->ioa));
+
+        size_t pos = static_cast<size_t>(minEntry - m_entries.begin());
+
+        *minEntry = {error, ca, ioa, typeId, minEntry->count + 1};
+        m_index[entryKey] = pos;
+    }
+
+    if (m_periodWarnings < m_maxWarningsPerPeriod) {
+        m_periodWarnings++;
+        return true;
+    }
+
+    return false;
+}
+
+std::vector<IEC104AddressReport::Entry>
+IEC104AddressReport::top(size_t n) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<Entry> entries(m_entries);
+
+    size_t count = std::min(n, entries.size());
+
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.count > b.count; });
+
+    entries.resize(count);
+
+    return entries;
+}
+
+uint64_t
+IEC104AddressReport::TotalCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_totalCount;
+}
+
+bool
+IEC104AddressReport::newPeriod()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool errorsInPeriod = (m_periodCount > 0);
+
+    m_periodCount = 0;
+    m_periodWarnings = 0;
+
+    return errorsInPeriod;
+}
+
+std::string
+IEC104AddressReport::summary(size_t n) const
+{
+    std::string result;
+
+    for (const Entry& entry : top(n)) {
+        if (!result.empty())
+            result += ", ";
+
+        result += std::to_string(entry.ca) + ":" + std::to_string(entry.ioa) +
+                  (entry.error == Error::NOT_FOUND ? " not found (" : " type mismatch (") +
+                  IEC104ClientConfig::getStringFromTypeID(entry.typeId) + ") x" + std::to_string(entry.count);
+    }
+
+    return result;
+}
+
+void
+IEC104AddressReport::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_index.clear();
+    m_totalCount = 0;
+    m_periodCount = 0;
+    m_periodWarnings = 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <chrono>
+
+#include "iec104_audit_queue.h"
+#include "iec104_utility.h"
+
+IEC104AuditQueue::IEC104AuditQueue(size_t maxSize, int batchDelay):
+    m_maxSize(maxSize),
+    m_batchDelay(batchDelay)
+{
+}
+
+IEC104AuditQueue::~IEC104AuditQueue()
+{
+    stop();
+}
+
+void
+IEC104AuditQueue::send(const Audit& audit)
+{
+    switch (audit.level) {
+        case Level::SUCCESS:
+            Iec104Utility::audit_success(audit.code, audit.message, false);
+            break;
+
+        case Level::FAILURE:
+            Iec104Utility::audit_fail(audit.code, audit.message, false);
+            break;
+
+        case Level::WARNING:
+            Iec104Utility::audit_warn(audit.code, audit.message, false);
+            break;
+
+        default:
+            Iec104Utility::audit_info(audit.code, audit.message, false);
+            break;
+    }
+}
+
+void
+IEC104AuditQueue::push(Level level, const std::string& code, const std::string& data, bool addQuotes)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104AuditQueue::push -";
+
+    Audit audit{level, code, Iec104Utility::m_addQuotes(data, addQuotes)};
+
+    std::unique_lock<std::mutex> lock(m_queueLock);
+
+    if (m_hasLastAudit && (audit == m_lastAudit)) {
+        m_coalescedCount++;
+        return;
+    }
+
+    m_lastAudit = audit;
+    m_hasLastAudit = true;
+
+    if (!m_running) {
+        lock.unlock();
+        send(audit);
+        m_sentCount++;
+        return;
+    }
+
+    if (m_queue.size() >= m_maxSize) {
+        Iec104Utility::log_warn("%s Audit queue full -> dropping oldest audit (%s)", beforeLog.c_str(), m_queue.front().message.c_str());
+        m_queue.pop_front();
+        m_droppedCount++;
+    }
+
+    m_queue.push_back(std::move(audit));
+
+    lock.unlock();
+
+    m_queueCond.notify_one();
+}
+
+void
+IEC104AuditQueue::start()
+{
+    std::lock_guard<std::mutex> lock(m_queueLock);
+
+    if (m_running)
+        return;
+
+    // the first audit after a (re)start always reports the initial state
+    m_hasLastAudit = false;
+
+    m_running = true;
+    m_senderThread = std::make_shared<std::thread>(&IEC104AuditQueue::_senderThread, this);
+}
+
+void
+IEC104AuditQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueLock);
+
+        if (!m_running)
+            return;
+
+        m_running = false;
+    }
+
+    m_queueCond.notify_one();
+
+    if (m_senderThread != nullptr) {
+        m_senderThread->join();
+        m_senderThread = nullptr;
+    }
+}
+
+void
+IEC104AuditQueue::_senderThread()
+{
+    std::deque<Audit> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_queueLock);
+
+            m_queueCond.wait(lock, [this] { return !m_queue.empty() || !m_running; });
+
+            if (m_queue.empty())
+                break; /* stopped and all audits sent */
+
+            if (m_batchDelay > 0) {
+                /* collect the following audits, stop() ends the wait */
+                m_queueCond.wait_for(lock, std::chrono::milliseconds(m_batchDelay), [this] { return !m_running; });
+            }
+
+            batch.swap(m_queue);
+        }
+
+        for (const Audit& audit : batch) {
+            send(audit);
+        }
+
+        m_sentCount += batch.size();
+        m_batchCount++;
+
+        batch.clear();
+    }
+}
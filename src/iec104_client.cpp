@@ -11,6 +11,8 @@
 #include <ctime>
 #include <algorithm>
 #include <map>
+#include <cstdio>
+#include <type_traits>
 
 #include <lib60870/hal_time.h>
 #include <lib60870/hal_thread.h>
@@ -24,7 +26,7 @@
 
 using namespace std;
 
-#define BACKUP_CONNECTION_TIMEOUT 5000 /* 5 seconds */
+#define ADDRESS_REPORT_TOP_N 10 /* number of addresses in the unknown address summary */
 
 static uint64_t
 getMonotonicTimeInMs()
@@ -59,13 +61,13 @@ Datapoint* IEC104Client::m_createDatapoint(const std::string& dataname, const T
     return new Datapoint(dataname, dp_value);
 }
 
-Datapoint* IEC104Client::m_createQualityUpdateForDataObject(std::shared_ptr<DataExchangeDefinition> dataDefinition, const QualityDescriptor* qd, CP56Time2a ts)
+Datapoint* IEC104Client::m_createQualityUpdateForDataObject(const IEC104ExchangeTable& exchangeTable, uint32_t pointId, const QualityDescriptor* qd, CP56Time2a ts)
 {
     auto* attributes = new vector<Datapoint*>;
 
-    attributes->push_back(m_createDatapoint("do_type", IEC104ClientConfig::getStringFromTypeID(dataDefinition->typeId)));
+    attributes->push_back(m_createDatapoint("do_type", IEC104ClientConfig::getStringFromTypeID(exchangeTable.typeIds[pointId])));
 
-    attributes->push_back(m_createDatapoint("do_ca", (long)dataDefinition->ca));
+    attributes->push_back(m_createDatapoint("do_ca", (long)exchangeTable.cas[pointId]));
 
     attributes->push_back(m_createDatapoint("do_oa", (long)0));
 
@@ -75,7 +77,7 @@ Datapoint* IEC104Client::m_createQualityUpdateForDataObject(std::shared_ptr<Data
 
     attributes->push_back(m_createDatapoint("do_negative", (long)0));
 
-    attributes->push_back(m_createDatapoint("do_ioa", (long)dataDefinition->ioa));
+    attributes->push_back(m_createDatapoint("do_ioa", (long)exchangeTable.ioas[pointId]));
 
     if (qd) {
         attributes->push_back(m_createDatapoint("do_quality_iv", (*qd & IEC60870_QUALITY_INVALID) ? 1L : 0L));
@@ -104,9 +106,9 @@ Datapoint* IEC104Client::m_createQualityUpdateForDataObject(std::shared_ptr<Data
     return new Datapoint("data_object", dpv);
 }
 
-static bool isDataPointInMonitoringDirection(std::shared_ptr<DataExchangeDefinition> dp)
+static bool isDataPointInMonitoringDirection(int typeId)
 {
-    if (dp->typeId < 41) {
+    if (typeId < 41) {
         return true;
     }
     else {
@@ -141,7 +143,7 @@ std::shared_ptr<IEC104Client::OutstandingCommand> IEC104Client::checkForOutstand
 void IEC104Client::checkOutstandingCommandTimeouts()
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::checkOutstandingCommandTimeouts -";
-    std::lock_guard<std::mutex> lock(m_outstandingCommandsMtx);
+    std::unique_lock<std::mutex> lock(m_outstandingCommandsMtx);
     uint64_t currentTime = getMonotonicTimeInMs();
 
     std::vector<std::shared_ptr<OutstandingCommand>> listOfTimedoutCommands;
@@ -171,6 +173,12 @@ void IEC104Client::checkOutstandingCommandTimeouts()
         // remove object command from m_outstandingCommands
         m_outstandingCommands.erase(std::remove(m_outstandingCommands.begin(), m_outstandingCommands.end(), commandToRemove), m_outstandingCommands.end());
     }
+
+    lock.unlock();
+
+    for (std::shared_ptr<OutstandingCommand> timedoutCommand : listOfTimedoutCommands) {
+        reportOutstandingCommand(*timedoutCommand, timedoutCommand->execute ? "select_timeout" : "timeout");
+    }
 }
 
 void IEC104Client::removeOutstandingCommand(std::shared_ptr<OutstandingCommand> command)
@@ -181,27 +189,33 @@ void IEC104Client::removeOutstandingCommand(std::shared_ptr<OutstandingCommand>
     m_outstandingCommands.erase(std::remove(m_outstandingCommands.begin(), m_outstandingCommands.end(), command), m_outstandingCommands.end());
 }
 
+void IEC104Client::commandNotSent(std::shared_ptr<OutstandingCommand> command)
+{
+    removeOutstandingCommand(command);
+
+    /* the token is only used by a command sent to the outstation */
+    if (command->clientCon) {
+        command->clientCon->refundCommandToken();
+    }
+}
+
 void IEC104Client::updateQualityForAllDataObjects(QualityDescriptor qd)
 {
     vector<Datapoint*> datapoints;
-    vector<string> labels;
+    vector<const string*> labels;
 
-    for (auto const& exchangeDefintions : m_config->ExchangeDefinition()) {
-        for (auto const& dpPair : exchangeDefintions.second) {
-            std::shared_ptr<DataExchangeDefinition> dp = dpPair.second;
+    auto exchangeTable = m_config->ExchangeTable();
 
-            if (dp) {
-                if (isDataPointInMonitoringDirection(dp))
-                {
-                    //TODO also add timestamp?
+    for (uint32_t pointId = 0; pointId < exchangeTable->Size(); pointId++) {
+        if (isDataPointInMonitoringDirection(exchangeTable->typeIds[pointId]))
+        {
+            //TODO also add timestamp?
 
-                    Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(dp, &qd, nullptr);
+            Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(*exchangeTable, pointId, &qd, nullptr);
 
-                    if (qualityUpdateDp) {
-                        datapoints.push_back(qualityUpdateDp);
-                        labels.push_back(dp->label);
-                    }
-                }
+            if (qualityUpdateDp) {
+                datapoints.push_back(qualityUpdateDp);
+                labels.push_back(&exchangeTable->label(pointId));
             }
         }
     }
@@ -211,13 +225,34 @@ void IEC104Client::updateQualityForAllDataObjects(QualityDescriptor qd)
     }
 }
 
-static bool isInStationGroup(std::shared_ptr<DataExchangeDefinition> dp)
+void IEC104Client::updateQualityForStaleDataObjects()
 {
-    if (dp->giGroups & 1) {
-        return true;
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::updateQualityForStaleDataObjects -";
+
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
+
+    auto exchangeTable = m_config->ExchangeTable();
+
+    std::vector<uint32_t> stalePoints;
+
+    m_stalenessMonitor.tick(exchangeTable, *m_config, m_pointFreshness, getMonotonicTimeInMs(), stalePoints);
+
+    QualityDescriptor qd = IEC60870_QUALITY_NON_TOPICAL;
+
+    for (uint32_t pointId : stalePoints) {
+        Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(*exchangeTable, pointId, &qd, nullptr);
+
+        if (qualityUpdateDp) {
+            datapoints.push_back(qualityUpdateDp);
+            labels.push_back(&exchangeTable->label(pointId));
+        }
     }
-    else {
-        return false;
+
+    if (datapoints.empty() == false) {
+        Iec104Utility::log_info("%s %lu data object(s) not refreshed within max_age, sent with non topical quality", beforeLog.c_str(),
+                                datapoints.size());
+        sendData(datapoints, labels);
     }
 }
 
@@ -225,23 +260,18 @@ static bool isInStationGroup(std::shared_ptr<DataExchangeDefinition> dp)
 void IEC104Client::updateQualityForAllDataObjectsInStationGroup(QualityDescriptor qd)
 {
     vector<Datapoint*> datapoints;
-    vector<string> labels;
+    vector<const string*> labels;
 
-    for (auto const& exchangeDefintions : m_config->ExchangeDefinition()) {
-        for (auto const& dpPair : exchangeDefintions.second) {
-            std::shared_ptr<DataExchangeDefinition> dp = dpPair.second;
+    auto exchangeTable = m_config->ExchangeTable();
 
-            if (dp && isInStationGroup(dp)) {
-
-                if (isDataPointInMonitoringDirection(dp))
-                {
-                    Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(dp, &qd, nullptr);
+    for (uint32_t pointId = 0; pointId < exchangeTable->Size(); pointId++) {
+        if (exchangeTable->isInStationGroup(pointId) && isDataPointInMonitoringDirection(exchangeTable->typeIds[pointId]))
+        {
+            Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(*exchangeTable, pointId, &qd, nullptr);
 
-                    if (qualityUpdateDp) {
-                        datapoints.push_back(qualityUpdateDp);
-                        labels.push_back(dp->label);
-                    }
-                }
+            if (qualityUpdateDp) {
+                datapoints.push_back(qualityUpdateDp);
+                labels.push_back(&exchangeTable->label(pointId));
             }
         }
     }
@@ -252,17 +282,41 @@ void IEC104Client::updateQualityForAllDataObjectsInStationGroup(QualityDescripto
 }
 //LCOV_EXCL_STOP
 
-void IEC104Client::updateQualityForDataObjectsNotReceivedInGIResponse(QualityDescriptor qd)
+void IEC104Client::updateQualityForDataObjectsNotReceivedInGIResponse(QualityDescriptor qd, int ca)
 {
     vector<Datapoint*> datapoints;
-    vector<string> labels;
+    vector<const string*> labels;
 
-    for (auto dp : m_listOfStationGroupDatapoints) {
-        Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(dp, &qd, nullptr);
+    /* keeps the labels valid when the list is created again before the data is sent */
+    std::shared_ptr<const IEC104ExchangeTable> giPendingTable;
 
-        if (qualityUpdateDp) {
-            datapoints.push_back(qualityUpdateDp);
-            labels.push_back(dp->label);
+    {
+        std::lock_guard<std::mutex> lock(m_giPendingMtx);
+
+        giPendingTable = m_giPendingTable;
+
+        if (giPendingTable == nullptr)
+            return;
+
+        uint32_t first = 0;
+        uint32_t last = static_cast<uint32_t>(m_giPending.size());
+
+        if ((ca != -1) && !giPendingTable->caRange(ca, first, last))
+            return;
+
+        for (uint32_t pointId = first; pointId < last; pointId++) {
+            if (!m_giPending[pointId])
+                continue;
+
+            /* reported once per GI cycle */
+            m_giPending[pointId] = false;
+
+            Datapoint* qualityUpdateDp = m_createQualityUpdateForDataObject(*giPendingTable, pointId, &qd, nullptr);
+
+            if (qualityUpdateDp) {
+                datapoints.push_back(qualityUpdateDp);
+                labels.push_back(&giPendingTable->label(pointId));
+            }
         }
     }
 
@@ -271,22 +325,42 @@ void IEC104Client::updateQualityForDataObjectsNotReceivedInGIResponse(QualityDes
     }
 }
 
-void IEC104Client::removeFromListOfDatapoints(std::shared_ptr<DataExchangeDefinition> toRemove)
+bool IEC104Client::removeFromListOfDatapoints(const IEC104ExchangeTable& exchangeTable, uint32_t pointId)
 {
-    auto& list = m_listOfStationGroupDatapoints;
-    list.erase(std::remove(list.begin(), list.end(), toRemove), list.end());
+    std::lock_guard<std::mutex> lock(m_giPendingMtx);
+
+    if (m_giPendingTable == nullptr)
+        return false;
+
+    // the list may have been created from a previous exchange table
+    if (m_giPendingTable.get() != &exchangeTable) {
+        pointId = m_giPendingTable->find(exchangeTable.cas[pointId], exchangeTable.ioas[pointId]);
+    }
+
+    if ((pointId < m_giPending.size()) && m_giPending[pointId]) {
+        m_giPending[pointId] = false;
+        return true;
+    }
+
+    return false;
 }
 
-void IEC104Client::createListOfDatapointsInStationGroup()
+void IEC104Client::createListOfDatapointsInGroup(int group, const std::vector<int>& cas)
 {
-    m_listOfStationGroupDatapoints.clear();
+    auto exchangeTable = m_config->ExchangeTable();
 
-    for (auto const& exchangeDefintions : m_config->ExchangeDefinition()) {
-        for (auto const& dpPair : exchangeDefintions.second) {
-            std::shared_ptr<DataExchangeDefinition> dp = dpPair.second;
+    std::lock_guard<std::mutex> lock(m_giPendingMtx);
 
-            if (dp && isInStationGroup(dp)) {
-                m_listOfStationGroupDatapoints.push_back(dp);
+    m_giPendingTable = exchangeTable;
+    m_giPending.assign(exchangeTable->Size(), false);
+
+    for (size_t i = 0; i < exchangeTable->listOfCAs.size(); i++) {
+        if (!cas.empty() && (std::find(cas.begin(), cas.end(), exchangeTable->listOfCAs[i]) == cas.end()))
+            continue;
+
+        for (uint32_t pointId = exchangeTable->caFirstPoints[i]; pointId < exchangeTable->caFirstPoints[i + 1]; pointId++) {
+            if (exchangeTable->isInGroup(pointId, group)) {
+                m_giPending[pointId] = true;
             }
         }
     }
@@ -341,9 +415,200 @@ Datapoint* IEC104Client::m_createDataObject(CS101_ASDU asdu, int64_t ioa, const
     return new Datapoint("data_object", dpv);
 }
 
+static std::string stepPositionToString(StepPositionInformation io)
+{
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "[%d,%s]", StepPositionInformation_getValue(io),
+             StepPositionInformation_isTransient(io) ? "true" : "false");
+
+    return std::string(buf);
+}
+
+static QualityDescriptor integratedTotalsQuality(IntegratedTotals io)
+{
+    BinaryCounterReading bcr = IntegratedTotals_getBCR(io);
+    QualityDescriptor qd = IEC60870_QUALITY_GOOD;
+
+    if (BinaryCounterReading_isInvalid(bcr))
+        qd |= IEC60870_QUALITY_INVALID;
+
+    if (BinaryCounterReading_hasCarry(bcr))
+        qd |= IEC60870_QUALITY_OVERFLOW;
+
+    return qd;
+}
+
+static long packedSinglePointValue(PackedSinglePointWithSCD io)
+{
+    StatusAndStatusChangeDetection scd = PackedSinglePointWithSCD_getSCD(io);
+
+    return ((long)StatusAndStatusChangeDetection_getSTn(scd) << 16) | StatusAndStatusChangeDetection_getCDn(scd);
+}
+
+// Traits describing how the data object of each supported ASDU type is built:
+// the information object type to cast to, the do_value type and accessors for
+// value, quality and CP56Time2a timestamp (nullptr when the type carries none).
+// Types without a specialization are not supported by handleASDU.
+template <int typeId>
+struct AsduTypeTraits
+{
+    static const bool supported = false;
+    static const bool isCommand = false;
+};
+
+#define IEC104_MONITORING_TYPE(TYPE, IO, VALUE_T, VALUE, QUALITY, TIMESTAMP) \
+    template <> struct AsduTypeTraits<TYPE> { \
+        typedef IO IoType; \
+        static const bool supported = true; \
+        static const bool isCommand = false; \
+        static VALUE_T value(IoType io) { (void)io; return VALUE; } \
+        static QualityDescriptor quality(IoType io) { (void)io; return QUALITY; } \
+        static CP56Time2a timestamp(IoType io) { (void)io; return TIMESTAMP; } \
+    };
+
+// HAS_ACT_TERM is false for set point commands, they are completed by the ACT-CON
+#define IEC104_COMMAND_TYPE(TYPE, IO, VALUE_T, VALUE, TIMESTAMP, HAS_ACT_TERM) \
+    template <> struct AsduTypeTraits<TYPE> { \
+        typedef IO IoType; \
+        static const bool supported = true; \
+        static const bool isCommand = true; \
+        static const bool hasActTerm = HAS_ACT_TERM; \
+        static VALUE_T value(IoType io) { (void)io; return VALUE; } \
+        static CP56Time2a timestamp(IoType io) { (void)io; return TIMESTAMP; } \
+    };
+
+// Types with a CP24Time2a time tag are decoded without do_ts as the time tag lacks the date part
+IEC104_MONITORING_TYPE(M_SP_NA_1, SinglePointInformation, long, SinglePointInformation_getValue(io), SinglePointInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_SP_TA_1, SinglePointInformation, long, SinglePointInformation_getValue(io), SinglePointInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_SP_TB_1, SinglePointInformation, long, SinglePointInformation_getValue(io), SinglePointInformation_getQuality(io), SinglePointWithCP56Time2a_getTimestamp((SinglePointWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_DP_NA_1, DoublePointInformation, long, DoublePointInformation_getValue(io), DoublePointInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_DP_TA_1, DoublePointInformation, long, DoublePointInformation_getValue(io), DoublePointInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_DP_TB_1, DoublePointInformation, long, DoublePointInformation_getValue(io), DoublePointInformation_getQuality(io), DoublePointWithCP56Time2a_getTimestamp((DoublePointWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_ST_NA_1, StepPositionInformation, std::string, stepPositionToString(io), StepPositionInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ST_TA_1, StepPositionInformation, std::string, stepPositionToString(io), StepPositionInformation_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ST_TB_1, StepPositionInformation, std::string, stepPositionToString(io), StepPositionInformation_getQuality(io), StepPositionWithCP56Time2a_getTimestamp((StepPositionWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_BO_NA_1, BitString32, long, BitString32_getValue(io), BitString32_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_BO_TA_1, BitString32, long, BitString32_getValue(io), BitString32_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_BO_TB_1, BitString32, long, BitString32_getValue(io), BitString32_getQuality(io), Bitstring32WithCP56Time2a_getTimestamp((Bitstring32WithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_ME_NA_1, MeasuredValueNormalized, float, MeasuredValueNormalized_getValue(io), MeasuredValueNormalized_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TA_1, MeasuredValueNormalized, float, MeasuredValueNormalized_getValue(io), MeasuredValueNormalized_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TD_1, MeasuredValueNormalized, float, MeasuredValueNormalized_getValue(io), MeasuredValueNormalized_getQuality(io), MeasuredValueNormalizedWithCP56Time2a_getTimestamp((MeasuredValueNormalizedWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_ME_ND_1, MeasuredValueNormalizedWithoutQuality, float, MeasuredValueNormalizedWithoutQuality_getValue(io), IEC60870_QUALITY_GOOD, nullptr)
+IEC104_MONITORING_TYPE(M_ME_NB_1, MeasuredValueScaled, long, MeasuredValueScaled_getValue(io), MeasuredValueScaled_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TB_1, MeasuredValueScaled, long, MeasuredValueScaled_getValue(io), MeasuredValueScaled_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TE_1, MeasuredValueScaled, long, MeasuredValueScaled_getValue(io), MeasuredValueScaled_getQuality(io), MeasuredValueScaledWithCP56Time2a_getTimestamp((MeasuredValueScaledWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_ME_NC_1, MeasuredValueShort, float, MeasuredValueShort_getValue(io), MeasuredValueShort_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TC_1, MeasuredValueShort, float, MeasuredValueShort_getValue(io), MeasuredValueShort_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_ME_TF_1, MeasuredValueShort, float, MeasuredValueShort_getValue(io), MeasuredValueShort_getQuality(io), MeasuredValueShortWithCP56Time2a_getTimestamp((MeasuredValueShortWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_IT_NA_1, IntegratedTotals, long, BinaryCounterReading_getValue(IntegratedTotals_getBCR(io)), integratedTotalsQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_IT_TA_1, IntegratedTotals, long, BinaryCounterReading_getValue(IntegratedTotals_getBCR(io)), integratedTotalsQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_IT_TB_1, IntegratedTotals, long, BinaryCounterReading_getValue(IntegratedTotals_getBCR(io)), integratedTotalsQuality(io), IntegratedTotalsWithCP56Time2a_getTimestamp((IntegratedTotalsWithCP56Time2a)io))
+IEC104_MONITORING_TYPE(M_EP_TA_1, EventOfProtectionEquipment, long, SingleEvent_getEventState(EventOfProtectionEquipment_getEvent(io)), SingleEvent_getQDP(EventOfProtectionEquipment_getEvent(io)), nullptr)
+IEC104_MONITORING_TYPE(M_EP_TD_1, EventOfProtectionEquipmentWithCP56Time2a, long, SingleEvent_getEventState(EventOfProtectionEquipmentWithCP56Time2a_getEvent(io)), SingleEvent_getQDP(EventOfProtectionEquipmentWithCP56Time2a_getEvent(io)), EventOfProtectionEquipmentWithCP56Time2a_getTimestamp(io))
+IEC104_MONITORING_TYPE(M_EP_TB_1, PackedStartEventsOfProtectionEquipment, long, PackedStartEventsOfProtectionEquipment_getEvent(io), PackedStartEventsOfProtectionEquipment_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_EP_TE_1, PackedStartEventsOfProtectionEquipmentWithCP56Time2a, long, PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getEvent(io), PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getQuality(io), PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getTimestamp(io))
+IEC104_MONITORING_TYPE(M_EP_TC_1, PackedOutputCircuitInfo, long, PackedOutputCircuitInfo_getOCI(io), PackedOutputCircuitInfo_getQuality(io), nullptr)
+IEC104_MONITORING_TYPE(M_EP_TF_1, PackedOutputCircuitInfoWithCP56Time2a, long, PackedOutputCircuitInfoWithCP56Time2a_getOCI(io), PackedOutputCircuitInfoWithCP56Time2a_getQuality(io), PackedOutputCircuitInfoWithCP56Time2a_getTimestamp(io))
+IEC104_MONITORING_TYPE(M_PS_NA_1, PackedSinglePointWithSCD, long, packedSinglePointValue(io), PackedSinglePointWithSCD_getQuality(io), nullptr)
+
+// commands and setpoint commands (for ACKs)
+IEC104_COMMAND_TYPE(C_SC_NA_1, SingleCommand, long, SingleCommand_getState(io), nullptr, true)
+IEC104_COMMAND_TYPE(C_SC_TA_1, SingleCommand, long, SingleCommand_getState(io), SingleCommandWithCP56Time2a_getTimestamp((SingleCommandWithCP56Time2a)io), true)
+IEC104_COMMAND_TYPE(C_DC_NA_1, DoubleCommand, long, DoubleCommand_getState(io), nullptr, true)
+IEC104_COMMAND_TYPE(C_DC_TA_1, DoubleCommand, long, DoubleCommand_getState(io), DoubleCommandWithCP56Time2a_getTimestamp((DoubleCommandWithCP56Time2a)io), true)
+IEC104_COMMAND_TYPE(C_RC_NA_1, StepCommand, long, StepCommand_getState(io), nullptr, true)
+IEC104_COMMAND_TYPE(C_RC_TA_1, StepCommand, long, StepCommand_getState(io), StepCommandWithCP56Time2a_getTimestamp((StepCommandWithCP56Time2a)io), true)
+IEC104_COMMAND_TYPE(C_SE_NA_1, SetpointCommandNormalized, float, SetpointCommandNormalized_getValue(io), nullptr, false)
+IEC104_COMMAND_TYPE(C_SE_TA_1, SetpointCommandNormalized, float, SetpointCommandNormalized_getValue(io), SetpointCommandNormalizedWithCP56Time2a_getTimestamp((SetpointCommandNormalizedWithCP56Time2a)io), false)
+IEC104_COMMAND_TYPE(C_SE_NB_1, SetpointCommandScaled, long, SetpointCommandScaled_getValue(io), nullptr, false)
+IEC104_COMMAND_TYPE(C_SE_TB_1, SetpointCommandScaled, long, SetpointCommandScaled_getValue(io), SetpointCommandScaledWithCP56Time2a_getTimestamp((SetpointCommandScaledWithCP56Time2a)io), false)
+IEC104_COMMAND_TYPE(C_SE_NC_1, SetpointCommandShort, float, SetpointCommandShort_getValue(io), nullptr, false)
+IEC104_COMMAND_TYPE(C_SE_TC_1, SetpointCommandShort, float, SetpointCommandShort_getValue(io), SetpointCommandShortWithCP56Time2a_getTimestamp((SetpointCommandShortWithCP56Time2a)io), false)
+
+#undef IEC104_MONITORING_TYPE
+#undef IEC104_COMMAND_TYPE
+
+template <int... typeIds>
+struct TypeIdList {};
+
+template <int count, int... typeIds>
+struct MakeTypeIdList : MakeTypeIdList<count - 1, count - 1, typeIds...> {};
+
+template <int... typeIds>
+struct MakeTypeIdList<0, typeIds...>
+{
+    typedef TypeIdList<typeIds...> type;
+};
+
+// Decoders generated from AsduTypeTraits, looked up by type ID in a table built at compile time
+struct IEC104Client::AsduDecoders
+{
+    typedef Datapoint* (*Decoder)(IEC104Client* client, CS101_ASDU asdu, InformationObject io, int ioa,
+                                  const std::string& label, const std::shared_ptr<OutstandingCommand>& outstandingCommand);
+
+    static const int TYPE_ID_COUNT = 128;
+
+    static Decoder get(int typeId)
+    {
+        if ((typeId < 0) || (typeId >= TYPE_ID_COUNT))
+            return nullptr;
+
+        return table(MakeTypeIdList<TYPE_ID_COUNT>::type())[typeId];
+    }
+
+private:
+
+    template <int typeId>
+    static typename std::enable_if<!AsduTypeTraits<typeId>::isCommand, Datapoint*>::type
+    decode(IEC104Client* client, CS101_ASDU asdu, InformationObject io, int ioa,
+           const std::string& label, const std::shared_ptr<OutstandingCommand>& /*outstandingCommand*/)
+    {
+        typedef AsduTypeTraits<typeId> Traits;
+        auto io_casted = (typename Traits::IoType)io;
+        QualityDescriptor qd = Traits::quality(io_casted);
+
+        return client->m_createDataObject(asdu, ioa, label, Traits::value(io_casted), &qd, Traits::timestamp(io_casted));
+    }
+
+    template <int typeId>
+    static typename std::enable_if<AsduTypeTraits<typeId>::isCommand, Datapoint*>::type
+    decode(IEC104Client* client, CS101_ASDU asdu, InformationObject io, int ioa,
+           const std::string& label, const std::shared_ptr<OutstandingCommand>& outstandingCommand)
+    {
+        typedef AsduTypeTraits<typeId> Traits;
+        auto io_casted = (typename Traits::IoType)io;
+
+        if (outstandingCommand)
+            client->handleCommandResponse(asdu, outstandingCommand, Traits::hasActTerm);
+
+        return client->m_createDataObject(asdu, ioa, label, Traits::value(io_casted), nullptr, Traits::timestamp(io_casted));
+    }
+
+    template <int typeId>
+    static constexpr typename std::enable_if<AsduTypeTraits<typeId>::supported, Decoder>::type entry()
+    {
+        return &decode<typeId>;
+    }
+
+    template <int typeId>
+    static constexpr typename std::enable_if<!AsduTypeTraits<typeId>::supported, Decoder>::type entry()
+    {
+        return nullptr;
+    }
+
+    template <int... typeIds>
+    static const Decoder* table(TypeIdList<typeIds...>)
+    {
+        static const Decoder decoders[] = { entry<typeIds>()... };
+
+        return decoders;
+    }
+};
+
 void
-IEC104Client::sendData(vector<Datapoint*> datapoints,
-                            const vector<std::string> labels)
+IEC104Client::sendData(const vector<Datapoint*>& datapoints,
+                            const vector<const std::string*>& labels)
 {
     int i = 0;
 
@@ -352,7 +617,7 @@ IEC104Client::sendData(vector<Datapoint*> datapoints,
         std::vector<Datapoint*> points;
         points.push_back(item_dp);
 
-        m_iec104->ingest(labels.at(i), points);
+        m_iec104->ingest(*labels.at(i), points);
         i++;
     }
 }
@@ -362,10 +627,18 @@ IEC104Client::OutstandingCommand::OutstandingCommand(int typeId, int ca, int ioa
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::OutstandingCommand::OutstandingCommand -";
     timeout = getMonotonicTimeInMs();
+    sentTime = timeout;
     Iec104Utility::log_debug("%s Created outstanding command: typeId=%s, CA=%d, IOA=%d, timeout=%d", beforeLog.c_str(),
                             IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa, timeout);
 }
 
+void IEC104Client::OutstandingCommand::selectBeforeOperate(const IEC104CommandQueue::Command& command)
+{
+    sbo = true;
+    execute = std::make_shared<IEC104CommandQueue::Command>(command);
+    execute->select = false;
+}
+
 void
 IEC104Client::sendSouthMonitoringEvent(bool connxStatus, bool giStatus)
 {
@@ -442,681 +715,642 @@ IEC104Client::sendSouthMonitoringEvent(bool connxStatus, bool giStatus)
     Datapoint* southEvent = new Datapoint("south_event", dpv);
 
     vector<Datapoint*> datapoints;
-    vector<string> labels;
+    vector<const string*> labels;
 
     datapoints.push_back(southEvent);
 
-    labels.push_back(m_config->GetConnxStatusSignal());
+    labels.push_back(&m_config->GetConnxStatusSignal());
 
     sendData(datapoints, labels);
 }
 
 void
-IEC104Client::updateConnectionStatus(ConnectionStatus newState)
+IEC104Client::logAddressReport()
 {
-    if (m_connStatus == newState)
-        return;
-
-    m_connStatus = newState;
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::logAddressReport -";
+    IEC104AddressReport& report = m_config->AddressReport();
 
-    sendSouthMonitoringEvent(true, false);
-
-    // Send audit for connection status
-    if (m_connStatus == ConnectionStatus::STARTED) {
-        Iec104Utility::audit_success("SRVFL", m_iec104->getServiceName() + "-connected");
-    }
-    else {
-        Iec104Utility::audit_fail("SRVFL", m_iec104->getServiceName() + "-disconnected");
-    }
+    Iec104Utility::log_warn("%s Received data for unknown or type mismatching addresses (total: %llu), most frequent: %s", beforeLog.c_str(),
+                            (unsigned long long)report.TotalCount(), report.summary(ADDRESS_REPORT_TOP_N).c_str());
 }
 
-void
-IEC104Client::updateGiStatus(GiStatus newState)
+bool
+IEC104Client::sendAddressReport()
 {
-    if (m_giStatus == newState)
-        return;
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendAddressReport -";
+    IEC104AddressReport& report = m_config->AddressReport();
 
-    m_giStatus = newState;
+    logAddressReport();
 
-    sendSouthMonitoringEvent(false, true);
+    if (m_config->GetConnxStatusSignal().empty()) {
+        Iec104Utility::log_warn("%s Cannot send address report: Connexion status signal is not defined", beforeLog.c_str());
+        return false;
+    }
 
-    #ifdef UNIT_TEST
-        // Simulated longer GI
-        if(newState == GiStatus::STARTED) {
-            Thread_sleep(200);
-        }
-    #endif
-}
+    auto* rejected = new vector<Datapoint*>;
 
-IEC104Client::GiStatus
-IEC104Client::getGiStatus()
-{
-    return m_giStatus;
-}
+    rejected->push_back(m_createDatapoint("unknown_ca", (long)getRejectedAsduCount(AsduRejectReason::UNKNOWN_CA)));
+    rejected->push_back(m_createDatapoint("cot", (long)getRejectedAsduCount(AsduRejectReason::COT_NOT_ALLOWED)));
+    rejected->push_back(m_createDatapoint("type", (long)getRejectedAsduCount(AsduRejectReason::TYPE_NOT_ALLOWED)));
+    rejected->push_back(m_createDatapoint("test", (long)getRejectedAsduCount(AsduRejectReason::TEST_ASDU)));
 
-IEC104Client::IEC104Client(IEC104* iec104, std::shared_ptr<IEC104ClientConfig> config)
-        : m_iec104(iec104),
-          m_config(config)
-{
-}
+    auto* addresses = new vector<Datapoint*>;
 
-IEC104Client::~IEC104Client()
-{
-    stop();
-}
+    for (const IEC104AddressReport::Entry& entry : report.top(ADDRESS_REPORT_TOP_N)) {
+        auto* address = new vector<Datapoint*>;
 
-static bool
-isInterrogationResponse(CS101_ASDU asdu)
-{
-    if (CS101_ASDU_getCOT(asdu) == CS101_COT_INTERROGATED_BY_STATION)
-        return true;
-    else
-        return false;
-}
+        address->push_back(m_createDatapoint("ca", (long)entry.ca));
+        address->push_back(m_createDatapoint("ioa", (long)entry.ioa));
+        address->push_back(m_createDatapoint("type", IEC104ClientConfig::getStringFromTypeID(entry.typeId)));
+        address->push_back(m_createDatapoint("error", std::string((entry.error == IEC104AddressReport::Error::NOT_FOUND) ? "not found" : "type mismatch")));
+        address->push_back(m_createDatapoint("count", (long)entry.count));
 
-bool
-IEC104Client::handleASDU(const IEC104ClientConnection* connection, CS101_ASDU asdu)
-{
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handleASDU -";
-    bool handledAsdu = true;
+        DatapointValue addressDpv(address, true);
+        addresses->push_back(new Datapoint("address", addressDpv));
+    }
 
-    vector<Datapoint*> datapoints;
-    vector<string> labels;
+    auto* attributes = new vector<Datapoint*>;
 
-    IEC60870_5_TypeID typeId = CS101_ASDU_getTypeID(asdu);
-    int ca = CS101_ASDU_getCA(asdu);
+    attributes->push_back(m_createDatapoint("total", (long)report.TotalCount()));
 
-    bool isResponse = isInterrogationResponse(asdu);
-    if (isResponse) {
-        if (getGiStatus() == GiStatus::STARTED)
-            updateGiStatus(GiStatus::IN_PROGRESS);
-    }
+    DatapointValue addressesDpv(addresses, false);
+    attributes->push_back(new Datapoint("addresses", addressesDpv));
 
-    Iec104Utility::log_debug("%s Received ASDU with CA: %i, interrogation response: %s", beforeLog.c_str(), ca, isResponse?"true":"false");
+    DatapointValue rejectedDpv(rejected, true);
+    attributes->push_back(new Datapoint("rejected_asdus", rejectedDpv));
 
-    for (int i = 0; i < CS101_ASDU_getNumberOfElements(asdu); i++)
-    {
-        InformationObject io = CS101_ASDU_getElement(asdu, i);
+    DatapointValue dpv(attributes, true);
 
-        if (io)
-        {
-            int ioa = InformationObject_getObjectAddress(io);
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
 
-            std::string* label = m_config->checkExchangeDataLayer(typeId, ca, ioa);
+    datapoints.push_back(new Datapoint("address_report", dpv));
 
-            std::shared_ptr<OutstandingCommand> outstandingCommand;
+    labels.push_back(&m_config->GetConnxStatusSignal());
 
-            if (isSupportedCommand(typeId)) {
-                outstandingCommand = checkForOutstandingCommand(typeId, ca, ioa, connection);
-                Iec104Utility::log_debug("%s Found supported command type: %s (%d) (CA: %i IOA: %i)", beforeLog.c_str(),
-                                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
-            }
+    sendData(datapoints, labels);
 
-            if ((label != nullptr) && isResponse) {
-                std::shared_ptr<DataExchangeDefinition> exgDef = m_config->ExchangeDefinition()[ca][ioa];
+    return true;
+}
 
-                if (exgDef) {
-                    if (isInStationGroup(exgDef)) {
-                        removeFromListOfDatapoints(exgDef);
-                        Iec104Utility::log_debug("%s Removed station group datapoint for type %s (%d) with CA: %i IOA: %i", beforeLog.c_str(),
-                                                IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, label->c_str(), ca, ioa);
-                    }
-                }
-            }
+bool
+IEC104Client::sendMemoryReport()
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendMemoryReport -";
 
-            switch (typeId)
-            {
-                case M_ME_NB_1:
-                    if (label)
-                        handle_M_ME_NB_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_SP_NA_1:
-                    if (label)
-                        handle_M_SP_NA_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_SP_TB_1:
-                    if (label)
-                        handle_M_SP_TB_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_DP_NA_1:
-                    if (label)
-                        handle_M_DP_NA_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_DP_TB_1:
-                    if (label)
-                        handle_M_DP_TB_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ST_NA_1:
-                    if (label)
-                        handle_M_ST_NA_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ST_TB_1:
-                    if (label)
-                        handle_M_ST_TB_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ME_NA_1:
-                    if (label)
-                        handle_M_ME_NA_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ME_TD_1:
-                    if (label)
-                        handle_M_ME_TD_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ME_TE_1:
-                    if (label)
-                        handle_M_ME_TE_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ME_NC_1:
-                    if (label)
-                        handle_M_ME_NC_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case M_ME_TF_1:
-                    if (label)
-                        handle_M_ME_TF_1(datapoints, *label, ca, asdu, io, ioa);
-                    break;
-
-                case C_SC_NA_1:
-                case C_SC_TA_1:
-                    if (label)
-                        handle_C_SC_NA_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                case C_DC_TA_1:
-                case C_DC_NA_1:
-                    if (label)
-                        handle_C_DC_NA_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                case C_RC_NA_1:
-                case C_RC_TA_1:
-                    if (label)
-                        handle_C_RC_NA_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                case C_SE_NA_1:
-                case C_SE_TA_1:
-                    if (label)
-                        handle_C_SE_NA_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                case C_SE_NB_1:
-                case C_SE_TB_1:
-                    if (label)
-                        handle_C_SE_NB_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                case C_SE_NC_1:
-                case C_SE_TC_1:
-                    if (label)
-                        handle_C_SE_NC_1(datapoints, *label, ca, asdu, io, ioa, outstandingCommand);
-                    break;
-
-                default:
-                    handledAsdu = false;
-                    break;
-            }
+    auto exchangeTable = m_config->ExchangeTable();
 
-            if (label) {
-                if (handledAsdu) {
-                    labels.push_back(*label);
-                    Iec104Utility::log_info("%s Created data object for ASDU of type %s (%d) with CA: %i IOA: %i", beforeLog.c_str(),
-                                            IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
-                    if(isAsduTriggerGi(datapoints, ca, asdu, ioa, typeId)){
-                        m_activeConnection->setGiRequested(true);
-                    }
-                }
-                else {
-                    Iec104Utility::log_warn("%s ASDU type %s (%d) not supported for %s (CA: %i IOA: %i)", beforeLog.c_str(),
-                                            IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, label->c_str(), ca, ioa);
-                }
-            }
-            else {
-                if (handledAsdu) {
-                    Iec104Utility::log_debug("%s No data point found in exchange configuration for type %s (%d) with CA: %i IOA: %i",
-                                            beforeLog.c_str(), IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
-                }
-            }
+    IEC104ExchangeTable::MemoryUsage usage = exchangeTable->memoryUsage();
 
-            InformationObject_destroy(io);
-        }
-        else {
-            Iec104Utility::log_error("%s Received ASDU with invalid or unknown information object for type %s (%d) CA: %i", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca);
-        }
-    }
+    size_t giPendingBytes = 0;
 
-    if (labels.empty() == false)
     {
-        sendData(datapoints, labels);
+        std::lock_guard<std::mutex> lock(m_giPendingMtx);
+        giPendingBytes = m_giPending.capacity() / 8;
     }
 
-    return handledAsdu;
-}
+    size_t freshnessBytes = m_pointFreshness.memoryUsage();
+    size_t readSchedulerBytes = m_readScheduler.memoryUsage();
+    size_t stalenessBytes = m_stalenessMonitor.memoryUsage();
+    size_t totalBytes = usage.pointBytes + usage.labelBytes + usage.indexBytes + giPendingBytes + freshnessBytes + readSchedulerBytes +
+                        stalenessBytes;
 
-bool IEC104Client::isAsduTriggerGi(vector<Datapoint*>& datapoints,
-                            unsigned int ca,
-                            CS101_ASDU asdu,
-                            uint64_t ioa,
-                            IEC60870_5_TypeID typeId) {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::isAsduTriggerGi -";
-    if (m_config->isTsAddressCgTriggering(ca, ioa) && isTypeIdSP(typeId) && (CS101_ASDU_getCOT(asdu) != CS101_CauseOfTransmission::CS101_COT_INTERROGATED_BY_STATION)) {
-        int valueTriggering = isTypeIdSingleSP(typeId) ? 0 : 1; // if it is a simple TS 0 is 0 if it is a double 0 is 1 because 01 is 0, 10 is 1, 11 is transient
-        for (auto datapoint : *(datapoints.back()->getData().getDpVec())) {
-            if (datapoint->getName() == "do_value" && datapoint->getData().toInt() == valueTriggering) {
-                if (m_activeConnection.get() == nullptr) {
-                    Iec104Utility::log_info("%s No active connexion, skip GI request.", beforeLog.c_str());
-                    return false;
-                }
-                if(!m_activeConnection->getGiRequested()){
-                    return true;
-                }
-            }
-        }
+    Iec104Utility::log_info("%s Exchange table: %lu data points, %lu labels, %lu bytes (points: %lu, labels: %lu, indexes: %lu, GI pending: %lu, freshness: %lu, read scheduler: %lu, staleness: %lu)",
+                            beforeLog.c_str(), usage.points, usage.labels, totalBytes, usage.pointBytes, usage.labelBytes,
+                            usage.indexBytes, giPendingBytes, freshnessBytes, readSchedulerBytes, stalenessBytes);
+
+    if (m_config->GetConnxStatusSignal().empty()) {
+        Iec104Utility::log_warn("%s Cannot send memory report: Connexion status signal is not defined", beforeLog.c_str());
+        return false;
     }
-    return false;
-}
 
-// Each of the following function handle a specific type of ASDU. They cast the
-// contained IO into a specific object that is strictly linked to the type
-// for example a MeasuredValueScaled is type M_ME_NB_1
-void IEC104Client::handle_M_ME_NB_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
-{
-    auto io_casted = (MeasuredValueScaled)io;
-    int64_t value = MeasuredValueScaled_getValue((MeasuredValueScaled)io_casted);
-    QualityDescriptor qd = MeasuredValueScaled_getQuality(io_casted);
+    auto* attributes = new vector<Datapoint*>;
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
-}
+    attributes->push_back(m_createDatapoint("points", (long)usage.points));
+    attributes->push_back(m_createDatapoint("labels", (long)usage.labels));
+    attributes->push_back(m_createDatapoint("point_bytes", (long)usage.pointBytes));
+    attributes->push_back(m_createDatapoint("label_bytes", (long)usage.labelBytes));
+    attributes->push_back(m_createDatapoint("index_bytes", (long)usage.indexBytes));
+    attributes->push_back(m_createDatapoint("gi_pending_bytes", (long)giPendingBytes));
+    attributes->push_back(m_createDatapoint("freshness_bytes", (long)freshnessBytes));
+    attributes->push_back(m_createDatapoint("read_scheduler_bytes", (long)readSchedulerBytes));
+    attributes->push_back(m_createDatapoint("staleness_bytes", (long)stalenessBytes));
+    attributes->push_back(m_createDatapoint("total_bytes", (long)totalBytes));
 
-void IEC104Client::handle_M_SP_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
-{
-    auto io_casted = (SinglePointInformation)io;
-    int64_t value = SinglePointInformation_getValue((SinglePointInformation)io_casted);
-    QualityDescriptor qd = SinglePointInformation_getQuality((SinglePointInformation)io_casted);
+    DatapointValue dpv(attributes, true);
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
-}
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
 
-void IEC104Client::handle_M_SP_TB_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
-{
-    auto io_casted = (SinglePointWithCP56Time2a)io;
-    int64_t value = SinglePointInformation_getValue((SinglePointInformation)io_casted);
-    QualityDescriptor qd = SinglePointInformation_getQuality((SinglePointInformation)io_casted);
+    datapoints.push_back(new Datapoint("memory_report", dpv));
 
-    CP56Time2a ts = SinglePointWithCP56Time2a_getTimestamp(io_casted);
+    labels.push_back(&m_config->GetConnxStatusSignal());
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
-}
+    sendData(datapoints, labels);
 
-void IEC104Client::handle_M_DP_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
-{
-    auto io_casted = (DoublePointInformation)io;
-    int64_t value = DoublePointInformation_getValue((DoublePointInformation)io_casted);
-    QualityDescriptor qd = DoublePointInformation_getQuality((DoublePointInformation)io_casted);
-
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
+    return true;
 }
 
-void IEC104Client::handle_M_DP_TB_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+bool
+IEC104Client::sendCommandReport()
 {
-    auto io_casted = (DoublePointWithCP56Time2a)io;
-    int64_t value = DoublePointInformation_getValue((DoublePointInformation)io_casted);
-    QualityDescriptor qd = DoublePointInformation_getQuality((DoublePointInformation)io_casted);
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendCommandReport -";
+
+    IEC104CommandQueue::Counters counters = m_commandQueue.getCounters();
+
+    std::shared_ptr<IEC104ClientConnection> activeConnection;
+
+    {
+        std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+        activeConnection = m_activeConnection;
+    }
+
+    IEC104TokenBucket::State pacing = {0, 0, 0, 0, 0};
+
+    if (activeConnection) {
+        pacing = activeConnection->CommandPacing();
+    }
+
+    uint64_t waitAverage = (counters.released > 0) ? counters.waitTotal / counters.released : 0;
+
+    Iec104Utility::log_info("%s Command queue: %lu queued now, %lu queued, %lu sent (wait avg: %lu ms, max: %lu ms), %lu dropped, %lu rejected, %lu expired, %lu superseded - pacing: rate %d/s, burst %d, %d tokens, %lu refused",
+                            beforeLog.c_str(), m_commandQueue.Size(), counters.queued, counters.released, waitAverage, counters.waitMax,
+                            counters.dropped, counters.rejected, counters.expired, counters.superseded, pacing.rate, pacing.burst,
+                            pacing.tokens, pacing.refused);
+
+    if (m_config->GetConnxStatusSignal().empty()) {
+        Iec104Utility::log_warn("%s Cannot send command report: Connexion status signal is not defined", beforeLog.c_str());
+        return false;
+    }
 
-    CP56Time2a ts = DoublePointWithCP56Time2a_getTimestamp(io_casted);
-    bool is_invalid = CP56Time2a_isInvalid(ts);
+    auto* attributes = new vector<Datapoint*>;
+
+    attributes->push_back(m_createDatapoint("queue_size", (long)m_commandQueue.Size()));
+    attributes->push_back(m_createDatapoint("queued", (long)counters.queued));
+    attributes->push_back(m_createDatapoint("sent", (long)counters.released));
+    attributes->push_back(m_createDatapoint("wait_avg_ms", (long)waitAverage));
+    attributes->push_back(m_createDatapoint("wait_max_ms", (long)counters.waitMax));
+    attributes->push_back(m_createDatapoint("dropped", (long)counters.dropped));
+    attributes->push_back(m_createDatapoint("rejected", (long)counters.rejected));
+    attributes->push_back(m_createDatapoint("expired", (long)counters.expired));
+    attributes->push_back(m_createDatapoint("superseded", (long)counters.superseded));
+    attributes->push_back(m_createDatapoint("pacing_rate", (long)pacing.rate));
+    attributes->push_back(m_createDatapoint("pacing_burst", (long)pacing.burst));
+    attributes->push_back(m_createDatapoint("pacing_tokens", (long)pacing.tokens));
+    attributes->push_back(m_createDatapoint("pacing_refused", (long)pacing.refused));
+
+    auto* latencyByType = new vector<Datapoint*>;
+
+    for (const auto& latencies : m_commandLatency.byType()) {
+        latencyByType->push_back(m_createLatencyDatapoint(IEC104ClientConfig::getStringFromTypeID(latencies.first), latencies.second));
+    }
+
+    DatapointValue latencyByTypeValue(latencyByType, true);
+    attributes->push_back(new Datapoint("latency_by_type", latencyByTypeValue));
+
+    auto* latencyByCa = new vector<Datapoint*>;
+
+    for (const auto& latencies : m_commandLatency.byCa()) {
+        latencyByCa->push_back(m_createLatencyDatapoint(std::to_string(latencies.first), latencies.second));
+    }
+
+    DatapointValue latencyByCaValue(latencyByCa, true);
+    attributes->push_back(new Datapoint("latency_by_ca", latencyByCaValue));
+
+    DatapointValue dpv(attributes, true);
+
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
+
+    datapoints.push_back(new Datapoint("command_report", dpv));
+
+    labels.push_back(&m_config->GetConnxStatusSignal());
+
+    sendData(datapoints, labels);
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
+    return true;
 }
 
-void IEC104Client::handle_M_ST_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+bool
+IEC104Client::sendPathReport()
 {
-    auto io_casted = (StepPositionInformation)io;
-    int64_t posValue = StepPositionInformation_getValue((StepPositionInformation)io_casted);
-    bool transient = StepPositionInformation_isTransient((StepPositionInformation)io_casted);
-    std::string value = "[" + std::to_string(posValue) + "," + (transient ? "true" : "false") + "]";
-    QualityDescriptor qd = StepPositionInformation_getQuality((StepPositionInformation)io_casted);
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendPathReport -";
+
+    if (m_config->GetConnxStatusSignal().empty()) {
+        Iec104Utility::log_warn("%s Cannot send path report: Connexion status signal is not defined", beforeLog.c_str());
+        return false;
+    }
+
+    Iec104Utility::log_info("%s Path selection: %s, %lu switchovers of the active connection", beforeLog.c_str(),
+                            m_config->isRttPathSelection() ? "rtt" : "first", (unsigned long)m_pathSwitchovers);
+
+    auto* attributes = new vector<Datapoint*>;
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
+    {
+        std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+
+        for (auto clientConnection : m_connections)
+        {
+            IEC104ClientConnection::PathStats stats = clientConnection->getPathStats();
+            std::string pathName = clientConnection->RedGroup()->Name() + "-" + clientConnection->PathLetter();
+            std::string server = clientConnection->RedGroupConnection()->ServerIP() + ":" +
+                                 std::to_string(clientConnection->RedGroupConnection()->TcpPort());
+            std::string state = "disconnected";
+
+            if (clientConnection == m_activeConnection) {
+                state = "active";
+            }
+            else if (clientConnection->Connected()) {
+                state = "passive";
+            }
+            else if (clientConnection->Connecting()) {
+                state = "connecting";
+            }
+
+            IEC104PathHealth::Metrics health = clientConnection->getPathHealth();
+            int64_t cost = clientConnection->PathCost();
+            IEC104WindowTuner::Stats window = clientConnection->getWindowStats();
+
+            Iec104Utility::log_info("%s Path %s (%s): %s, %lu connection attempts, %lu failed, %lu connections lost, last reconnect delay: %lu ms - RTT: %ld ms (smoothed: %ld ms, var: %ld ms, min: %ld ms, %lu samples), %lu/%lu U-frames lost, %lu/%lu frames malformed, error rate: %.3f, cost: %ld",
+                                    beforeLog.c_str(), pathName.c_str(), server.c_str(), state.c_str(), stats.connectAttempts,
+                                    stats.connectFailures, stats.connectionsLost, stats.reconnectDelay, (long)health.rtt, (long)health.srtt,
+                                    (long)health.rttVar, (long)health.rttMin, health.rttSamples, health.probesLost, health.probes,
+                                    health.frameErrors, health.frames, health.errorRate, (long)cost);
+
+            Iec104Utility::log_info("%s Path %s: k=%d, w=%d, t2=%d (next connection: k=%d, w=%d, t2=%d), %.1f I-frames/s, %lu I-frames received, %lu acknowledgements, %lu I-frames sent (%lu with full window) - window utilization: received %.1f %% (max %.1f %%), sent %.1f %% (max %.1f %%)",
+                                    beforeLog.c_str(), pathName.c_str(), window.parameters.k, window.parameters.w, window.parameters.t2,
+                                    window.next.k, window.next.w, window.next.t2, window.rxRate, window.rxFrames, window.acksSent, window.txFrames, window.txWindowFull,
+                                    window.rxUtilization, window.rxUtilizationMax, window.txUtilization, window.txUtilizationMax);
+
+            auto* pathAttributes = new vector<Datapoint*>;
+
+            pathAttributes->push_back(m_createDatapoint("server", server));
+            pathAttributes->push_back(m_createDatapoint("state", state));
+            pathAttributes->push_back(m_createDatapoint("connect_attempts", (long)stats.connectAttempts));
+            pathAttributes->push_back(m_createDatapoint("connect_failures", (long)stats.connectFailures));
+            pathAttributes->push_back(m_createDatapoint("connections_lost", (long)stats.connectionsLost));
+            pathAttributes->push_back(m_createDatapoint("reconnect_delay_ms", (long)stats.reconnectDelay));
+            pathAttributes->push_back(m_createDatapoint("rtt_ms", (long)health.rtt));
+            pathAttributes->push_back(m_createDatapoint("srtt_ms", (long)health.srtt));
+            pathAttributes->push_back(m_createDatapoint("rtt_var_ms", (long)health.rttVar));
+            pathAttributes->push_back(m_createDatapoint("rtt_min_ms", (long)health.rttMin));
+            pathAttributes->push_back(m_createDatapoint("rtt_samples", (long)health.rttSamples));
+            pathAttributes->push_back(m_createDatapoint("probes", (long)health.probes));
+            pathAttributes->push_back(m_createDatapoint("probes_lost", (long)health.probesLost));
+            pathAttributes->push_back(m_createDatapoint("frames", (long)health.frames));
+            pathAttributes->push_back(m_createDatapoint("frame_errors", (long)health.frameErrors));
+            pathAttributes->push_back(m_createDatapoint("error_rate", health.errorRate));
+            pathAttributes->push_back(m_createDatapoint("cost", (long)cost));
+            pathAttributes->push_back(m_createDatapoint("k", (long)window.parameters.k));
+            pathAttributes->push_back(m_createDatapoint("w", (long)window.parameters.w));
+            pathAttributes->push_back(m_createDatapoint("t2", (long)window.parameters.t2));
+            pathAttributes->push_back(m_createDatapoint("next_k", (long)window.next.k));
+            pathAttributes->push_back(m_createDatapoint("next_w", (long)window.next.w));
+            pathAttributes->push_back(m_createDatapoint("next_t2", (long)window.next.t2));
+            pathAttributes->push_back(m_createDatapoint("rx_rate", window.rxRate));
+            pathAttributes->push_back(m_createDatapoint("rx_frames", (long)window.rxFrames));
+            pathAttributes->push_back(m_createDatapoint("acks_sent", (long)window.acksSent));
+            pathAttributes->push_back(m_createDatapoint("tx_frames", (long)window.txFrames));
+            pathAttributes->push_back(m_createDatapoint("tx_window_full", (long)window.txWindowFull));
+            pathAttributes->push_back(m_createDatapoint("rx_window_utilization", window.rxUtilization));
+            pathAttributes->push_back(m_createDatapoint("rx_window_utilization_max", window.rxUtilizationMax));
+            pathAttributes->push_back(m_createDatapoint("tx_window_utilization", window.txUtilization));
+            pathAttributes->push_back(m_createDatapoint("tx_window_utilization_max", window.txUtilizationMax));
+
+            DatapointValue pathValue(pathAttributes, true);
+            attributes->push_back(new Datapoint(pathName, pathValue));
+        }
+    }
+
+    DatapointValue dpv(attributes, true);
+
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
+
+    datapoints.push_back(new Datapoint("path_report", dpv));
+
+    labels.push_back(&m_config->GetConnxStatusSignal());
+
+    sendData(datapoints, labels);
+
+    return true;
 }
 
-void IEC104Client::handle_M_ST_TB_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+Datapoint*
+IEC104Client::m_createLatencyDatapoint(const std::string& name, const IEC104CommandLatency::Latencies& latencies)
 {
-    auto io_casted = (StepPositionWithCP56Time2a)io;
-    int64_t posValue = StepPositionInformation_getValue((StepPositionInformation)io_casted);
-    bool transient = StepPositionInformation_isTransient((StepPositionInformation)io_casted);
-    std::string value = "[" + std::to_string(posValue) + "," + (transient ? "true" : "false") + "]";
-    QualityDescriptor qd = StepPositionInformation_getQuality((StepPositionInformation)io_casted);
+    auto histogramDatapoint = [](const std::string& histogramName, const IEC104CommandLatency::Histogram& histogram) {
+        auto* attributes = new vector<Datapoint*>;
+
+        attributes->push_back(m_createDatapoint("count", (long)histogram.count));
+        attributes->push_back(m_createDatapoint("avg_ms", (long)((histogram.count > 0) ? histogram.total / histogram.count : 0)));
+        attributes->push_back(m_createDatapoint("max_ms", (long)histogram.max));
+
+        for (int i = 0; i < IEC104CommandLatency::BUCKETS; i++) {
+            attributes->push_back(m_createDatapoint(IEC104CommandLatency::bucketName(i), (long)histogram.counts[i]));
+        }
+
+        DatapointValue dpv(attributes, true);
 
-    CP56Time2a ts = StepPositionWithCP56Time2a_getTimestamp(io_casted);
-    bool is_invalid = CP56Time2a_isInvalid(ts);
+        return new Datapoint(histogramName, dpv);
+    };
+
+    auto* attributes = new vector<Datapoint*>;
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
+    attributes->push_back(histogramDatapoint("act_con", latencies.actCon));
+    attributes->push_back(histogramDatapoint("act_term", latencies.actTerm));
+    attributes->push_back(m_createDatapoint("timeouts", (long)latencies.timeouts));
+
+    DatapointValue dpv(attributes, true);
+
+    return new Datapoint(name, dpv);
 }
 
-void IEC104Client::handle_M_ME_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+void
+IEC104Client::exchangeTableChanged(const std::vector<int>& changedCAs)
 {
-    auto io_casted = (MeasuredValueNormalized)io;
-    float value = MeasuredValueNormalized_getValue((MeasuredValueNormalized)io_casted);
-    QualityDescriptor qd = MeasuredValueNormalized_getQuality((MeasuredValueNormalized)io_casted);
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::exchangeTableChanged -";
+
+    if (changedCAs.empty() || !m_config->GiEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+
+    if (m_activeConnection == nullptr) {
+        Iec104Utility::log_debug("%s No active connection, changed CAs will be interrogated with the next GI", beforeLog.c_str());
+        return;
+    }
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
+    m_activeConnection->requestInterrogation(changedCAs);
 }
 
-void IEC104Client::handle_M_ME_TD_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+void
+IEC104Client::updateConnectionStatus(ConnectionStatus newState)
 {
-    auto io_casted = (MeasuredValueNormalizedWithCP56Time2a)io;
-    float value = MeasuredValueNormalized_getValue((MeasuredValueNormalized)io_casted);
-    QualityDescriptor qd = MeasuredValueNormalized_getQuality((MeasuredValueNormalized)io_casted);
+    if (m_connStatus == newState)
+        return;
+
+    m_connStatus = newState;
 
-    CP56Time2a ts = MeasuredValueNormalizedWithCP56Time2a_getTimestamp(io_casted);
-    bool is_invalid = CP56Time2a_isInvalid(ts);
+    sendSouthMonitoringEvent(true, false);
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
+    // Send audit for connection status
+    if (m_connStatus == ConnectionStatus::STARTED) {
+        m_auditQueue.push(IEC104AuditQueue::Level::SUCCESS, "SRVFL", m_iec104->getServiceName() + "-connected");
+    }
+    else {
+        m_auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", m_iec104->getServiceName() + "-disconnected");
+    }
 }
 
-void IEC104Client::handle_M_ME_TE_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+void
+IEC104Client::updateGiStatus(GiStatus newState)
 {
-    auto io_casted = (MeasuredValueScaledWithCP56Time2a)io;
-    int64_t value = MeasuredValueScaled_getValue((MeasuredValueScaled)io_casted);
-    QualityDescriptor qd = MeasuredValueScaled_getQuality((MeasuredValueScaled)io_casted);
+    if (m_giStatus == newState)
+        return;
 
-    CP56Time2a ts = MeasuredValueScaledWithCP56Time2a_getTimestamp(io_casted);
-    bool is_invalid = CP56Time2a_isInvalid(ts);
+    m_giStatus = newState;
+
+    sendSouthMonitoringEvent(false, true);
+
+    #ifdef UNIT_TEST
+        // Simulated longer GI
+        if(newState == GiStatus::STARTED) {
+            Thread_sleep(200);
+        }
+    #endif
+}
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
+IEC104Client::GiStatus
+IEC104Client::getGiStatus()
+{
+    return m_giStatus;
 }
 
-void IEC104Client::handle_M_ME_NC_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+IEC104Client::IEC104Client(IEC104* iec104, std::shared_ptr<IEC104ClientConfig> config)
+        : m_iec104(iec104),
+          m_config(config)
 {
-    auto io_casted = (MeasuredValueShort)io;
-    float value = MeasuredValueShort_getValue((MeasuredValueShort)io_casted);
-    QualityDescriptor qd = MeasuredValueShort_getQuality((MeasuredValueShort)io_casted);
+}
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd));
+IEC104Client::~IEC104Client()
+{
+    stop();
 }
 
-void IEC104Client::handle_M_ME_TF_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa)
+static bool
+isInterrogationResponse(CS101_ASDU asdu)
 {
-    auto io_casted = (MeasuredValueShortWithCP56Time2a)io;
-    float value = MeasuredValueShort_getValue((MeasuredValueShort)io_casted);
-    QualityDescriptor qd = MeasuredValueShort_getQuality((MeasuredValueShort)io_casted);
+    /* station (20) or group 1..16 (21..36) interrogation */
+    int cot = CS101_ASDU_getCOT(asdu);
 
-    CP56Time2a ts = MeasuredValueShortWithCP56Time2a_getTimestamp(io_casted);
-    bool is_invalid = CP56Time2a_isInvalid(ts);
+    return (cot >= CS101_COT_INTERROGATED_BY_STATION) && (cot <= CS101_COT_INTERROGATED_BY_GROUP_16);
+}
 
-    datapoints.push_back(m_createDataObject(asdu, ioa, label, value, &qd, ts));
+uint64_t IEC104Client::getRejectedAsduCount(AsduRejectReason reason) const
+{
+    return m_rejectedAsdus[static_cast<int>(reason)];
 }
 
-void IEC104Client::handle_C_SC_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
+bool IEC104Client::isAsduRejectedByFilter(CS101_ASDU asdu)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_SC_NA_1 -";
-    auto io_casted = (SingleCommandWithCP56Time2a)io;
-    int64_t state = SingleCommand_getState((SingleCommand)io_casted);
+    IEC60870_5_TypeID typeId = CS101_ASDU_getTypeID(asdu);
 
-    QualifierOfCommand qu = SingleCommand_getQU((SingleCommand)io_casted);
+    // only data in monitoring direction is filtered, system and command ASDUs are always processed
+    if (typeId >= 41)
+        return false;
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                                    CS101_CauseOfTransmission_toString(cot), cot);
-            outstandingCommand->actConReceived = true;
-            outstandingCommand->timeout = getMonotonicTimeInMs();
-        }
-        else if (cot == CS101_COT_ACTIVATION_TERMINATION) {
-            Iec104Utility::log_debug("%s Received ACT-TERM for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                                    CS101_CauseOfTransmission_toString(cot), cot);
-            removeOutstandingCommand(outstandingCommand);
-        }
+    if (!m_config->isCaAllowed(CS101_ASDU_getCA(asdu))) {
+        m_rejectedAsdus[static_cast<int>(AsduRejectReason::UNKNOWN_CA)]++;
+        return true;
     }
 
-    if (typeId == C_SC_TA_1)
-    {
-        CP56Time2a ts = SingleCommandWithCP56Time2a_getTimestamp(io_casted);
-        bool is_invalid = CP56Time2a_isInvalid(ts);
+    if (!m_config->isCotAllowed(CS101_ASDU_getCOT(asdu))) {
+        m_rejectedAsdus[static_cast<int>(AsduRejectReason::COT_NOT_ALLOWED)]++;
+        return true;
+    }
 
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr, ts));
+    if (!m_config->isTypeIdAllowed(typeId)) {
+        m_rejectedAsdus[static_cast<int>(AsduRejectReason::TYPE_NOT_ALLOWED)]++;
+        return true;
     }
-    else {
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr));
+
+    if (m_config->RejectTestAsdu() && CS101_ASDU_isTest(asdu)) {
+        m_rejectedAsdus[static_cast<int>(AsduRejectReason::TEST_ASDU)]++;
+        return true;
     }
+
+    return false;
 }
 
-void IEC104Client::handle_C_DC_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
+bool
+IEC104Client::handleASDU(const IEC104ClientConnection* connection, CS101_ASDU asdu)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_DC_NA_1 -";
-    auto io_casted = (DoubleCommandWithCP56Time2a)io;
-    int64_t state = DoubleCommand_getState((DoubleCommand)io_casted);
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handleASDU -";
 
-    QualifierOfCommand qu = DoubleCommand_getQU((DoubleCommand)io_casted);
+    // drop unwanted ASDUs before any information object is decoded
+    if (isAsduRejectedByFilter(asdu))
+        return true;
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                                    CS101_CauseOfTransmission_toString(cot), cot);
-            outstandingCommand->actConReceived = true;
-            outstandingCommand->timeout = getMonotonicTimeInMs();
-        }
-        else if (cot == CS101_COT_ACTIVATION_TERMINATION) {
-            Iec104Utility::log_debug("%s Received ACT-TERM for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                                    CS101_CauseOfTransmission_toString(cot), cot);
-            removeOutstandingCommand(outstandingCommand);
-        }
-    }
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
 
-    if (typeId == C_DC_TA_1)
-    {
-        CP56Time2a ts = DoubleCommandWithCP56Time2a_getTimestamp(io_casted);
+    IEC60870_5_TypeID typeId = CS101_ASDU_getTypeID(asdu);
+    AsduDecoders::Decoder decoder = AsduDecoders::get(typeId);
+    bool handledAsdu = (decoder != nullptr);
+    int ca = CS101_ASDU_getCA(asdu);
 
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr, ts));
+    bool isResponse = isInterrogationResponse(asdu);
+    if (isResponse) {
+        if (getGiStatus() == GiStatus::STARTED)
+            updateGiStatus(GiStatus::IN_PROGRESS);
     }
-    else
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr));
-}
 
-void IEC104Client::handle_C_RC_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
-{
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_RC_NA_1 -";
-    auto io_casted = (StepCommandWithCP56Time2a)io;
-    int64_t state = StepCommand_getState((StepCommand)io_casted);
+    Iec104Utility::log_debug("%s Received ASDU with CA: %i, interrogation response: %s", beforeLog.c_str(), ca, isResponse?"true":"false");
 
-    QualifierOfCommand qu = StepCommand_getQU((StepCommand)io_casted);
+    // the labels sent with the datapoints belong to this snapshot of the exchange table
+    auto exchangeTable = m_config->ExchangeTable();
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                        CS101_CauseOfTransmission_toString(cot), cot);
-            outstandingCommand->actConReceived = true;
-            outstandingCommand->timeout = getMonotonicTimeInMs();
-        }
-        else if (cot == CS101_COT_ACTIVATION_TERMINATION) {
-            Iec104Utility::log_debug("%s Received ACT-TERM for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                                    CS101_CauseOfTransmission_toString(cot), cot);
-            removeOutstandingCommand(outstandingCommand);
-        }
-    }
+    uint64_t receiveTime = getMonotonicTimeInMs();
 
-    if (typeId == C_RC_TA_1)
+    for (int i = 0; i < CS101_ASDU_getNumberOfElements(asdu); i++)
     {
-        CP56Time2a ts = StepCommandWithCP56Time2a_getTimestamp(io_casted);
+        InformationObject io = CS101_ASDU_getElement(asdu, i);
 
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr, ts));
-    }
-    else
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, state, nullptr));
-}
+        if (io)
+        {
+            int ioa = InformationObject_getObjectAddress(io);
 
-void IEC104Client::handle_C_SE_NA_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
-{
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_SE_NA_1 -";
-    auto io_casted = (SetpointCommandNormalizedWithCP56Time2a)io;
+            uint32_t pointId = m_config->checkExchangeDataLayer(*exchangeTable, typeId, ca, ioa);
 
-    float value = SetpointCommandNormalized_getValue((SetpointCommandNormalized)io_casted);
+            const std::string* label = (pointId != IEC104ExchangeTable::NO_POINT) ? &(exchangeTable->label(pointId)) : nullptr;
 
-    QualifierOfCommand ql = SetpointCommandNormalized_getQL((SetpointCommandNormalized)io_casted);
+            std::shared_ptr<OutstandingCommand> outstandingCommand;
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                        CS101_CauseOfTransmission_toString(cot), cot);
-            removeOutstandingCommand(outstandingCommand);
-        }
-    }
+            if (isSupportedCommand(typeId)) {
+                outstandingCommand = checkForOutstandingCommand(typeId, ca, ioa, connection);
+                Iec104Utility::log_debug("%s Found supported command type: %s (%d) (CA: %i IOA: %i)", beforeLog.c_str(),
+                                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
+            }
 
-    if (typeId == C_SE_TA_1)
-    {
-        CP56Time2a ts = SetpointCommandNormalizedWithCP56Time2a_getTimestamp(io_casted);
+            if ((label != nullptr) && isResponse) {
+                if (removeFromListOfDatapoints(*exchangeTable, pointId)) {
+                    Iec104Utility::log_debug("%s Removed interrogated group datapoint for type %s (%d) with CA: %i IOA: %i", beforeLog.c_str(),
+                                            IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
+                }
+            }
 
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr, ts));
-    }
-    else
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr));
-}
+            if (label && decoder)
+                datapoints.push_back(decoder(this, asdu, io, ioa, *label, outstandingCommand));
 
-void IEC104Client::handle_C_SE_NB_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
-{
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_SE_NB_1 -";
-    auto io_casted = (SetpointCommandScaledWithCP56Time2a)io;
+            if (label && decoder && isDataPointInMonitoringDirection(typeId)) {
+                m_pointFreshness.refresh(exchangeTable, pointId, receiveTime);
 
-    int64_t value = SetpointCommandScaled_getValue((SetpointCommandScaled)io_casted);
+                if (CS101_ASDU_getCOT(asdu) == CS101_COT_REQUEST) {
+                    m_readScheduler.readAnswered(ca, ioa, receiveTime);
+                }
+            }
 
-    QualifierOfCommand ql = SetpointCommandScaled_getQL((SetpointCommandScaled)io_casted);
+            if (label) {
+                if (handledAsdu) {
+                    labels.push_back(label);
+                    Iec104Utility::log_info("%s Created data object for ASDU of type %s (%d) with CA: %i IOA: %i", beforeLog.c_str(),
+                                            IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
+                    if(isAsduTriggerGi(datapoints, ca, asdu, ioa, typeId)){
+                        m_giArbiter.request(IEC104GiArbiter::Source::TRIGGER_SOUTH_GI);
+                    }
+                }
+                else {
+                    Iec104Utility::log_warn("%s ASDU type %s (%d) not supported for %s (CA: %i IOA: %i)", beforeLog.c_str(),
+                                            IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, label->c_str(), ca, ioa);
+                }
+            }
+            else {
+                if (handledAsdu) {
+                    Iec104Utility::log_debug("%s No data point found in exchange configuration for type %s (%d) with CA: %i IOA: %i",
+                                            beforeLog.c_str(), IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca, ioa);
+                }
+            }
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                        CS101_CauseOfTransmission_toString(cot), cot);
-            removeOutstandingCommand(outstandingCommand);
+            InformationObject_destroy(io);
+        }
+        else {
+            Iec104Utility::log_error("%s Received ASDU with invalid or unknown information object for type %s (%d) CA: %i", beforeLog.c_str(),
+                                    IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, ca);
         }
     }
 
-    if (typeId == C_SE_TB_1)
+    if (labels.empty() == false)
     {
-        CP56Time2a ts = SetpointCommandScaledWithCP56Time2a_getTimestamp(io_casted);
+        sendData(datapoints, labels);
+    }
+
+    return handledAsdu;
+}
 
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr, ts));
+bool IEC104Client::isAsduTriggerGi(vector<Datapoint*>& datapoints,
+                            unsigned int ca,
+                            CS101_ASDU asdu,
+                            uint64_t ioa,
+                            IEC60870_5_TypeID typeId) {
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::isAsduTriggerGi -";
+    if (m_config->isTsAddressCgTriggering(ca, ioa) && isTypeIdSP(typeId) && !isInterrogationResponse(asdu)) {
+        int valueTriggering = isTypeIdSingleSP(typeId) ? 0 : 1; // if it is a simple TS 0 is 0 if it is a double 0 is 1 because 01 is 0, 10 is 1, 11 is transient
+        for (auto datapoint : *(datapoints.back()->getData().getDpVec())) {
+            if (datapoint->getName() == "do_value" && datapoint->getData().toInt() == valueTriggering) {
+                if (m_activeConnection.get() == nullptr) {
+                    Iec104Utility::log_info("%s No active connexion, skip GI request.", beforeLog.c_str());
+                    return false;
+                }
+                return true;
+            }
+        }
     }
-    else
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr));
+    return false;
 }
 
-void IEC104Client::handle_C_SE_NC_1(vector<Datapoint*>& datapoints, string& label,
-                             unsigned int ca,
-                             CS101_ASDU asdu, InformationObject io,
-                             uint64_t ioa,
-                             std::shared_ptr<OutstandingCommand> outstandingCommand)
+void IEC104Client::handleCommandResponse(CS101_ASDU asdu, std::shared_ptr<OutstandingCommand> outstandingCommand, bool hasActTerm)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handle_C_SE_NC_1 -";
-    auto io_casted = (SetpointCommandShortWithCP56Time2a)io;
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::handleCommandResponse -";
+    auto typeId = CS101_ASDU_getTypeID(asdu);
+    auto cot = CS101_ASDU_getCOT(asdu);
 
-    float value = SetpointCommandShort_getValue((SetpointCommandShort)io_casted);
+    if (cot == CS101_COT_ACTIVATION_CON) {
+        bool negative = CS101_ASDU_isNegative(asdu);
 
-    QualifierOfCommand ql = SetpointCommandShort_getQL((SetpointCommandShort)io_casted);
+        Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d) negative: %s", beforeLog.c_str(),
+                                IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
+                                CS101_CauseOfTransmission_toString(cot), cot, negative?"true":"false");
 
-    auto typeId = CS101_ASDU_getTypeID(asdu);
-    auto cot = CS101_ASDU_getCOT(asdu);
-    if (outstandingCommand) {
-        if (cot == CS101_COT_ACTIVATION_CON) {
-            Iec104Utility::log_debug("%s Received ACT-CON for %s (%d) COT: %s (%d)", beforeLog.c_str(),
-                        IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
-                        CS101_CauseOfTransmission_toString(cot), cot);
+        outstandingCommand->actConTime = getMonotonicTimeInMs();
+
+        if (outstandingCommand->execute) {
+            /* select of a select before operate command, no ACT-TERM follows */
+            if (negative) {
+                removeOutstandingCommand(outstandingCommand);
+                commandCompleted(*outstandingCommand, "select_negative");
+            }
+            else {
+                sendSelectedCommand(outstandingCommand);
+            }
+        }
+        /* no ACT-TERM follows a negative ACT-CON */
+        else if (hasActTerm && !negative) {
+            outstandingCommand->actConReceived = true;
+            outstandingCommand->timeout = getMonotonicTimeInMs();
+        }
+        else {
             removeOutstandingCommand(outstandingCommand);
+            commandCompleted(*outstandingCommand, negative ? "negative" : "success");
         }
     }
-
-    if (typeId == C_SE_TC_1)
-    {
-        CP56Time2a ts = SetpointCommandShortWithCP56Time2a_getTimestamp(io_casted);
-
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr, ts));
+    else if ((cot == CS101_COT_ACTIVATION_TERMINATION) && hasActTerm) {
+        Iec104Utility::log_debug("%s Received ACT-TERM for %s (%d) COT: %s (%d)", beforeLog.c_str(),
+                                IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId,
+                                CS101_CauseOfTransmission_toString(cot), cot);
+        removeOutstandingCommand(outstandingCommand);
+        commandCompleted(*outstandingCommand, "success");
     }
-    else
-        datapoints.push_back(m_createDataObject(asdu, ioa, label, value, nullptr));
 }
 
 bool
@@ -1139,21 +1373,21 @@ IEC104Client::prepareConnections()
         // Send initial path connection status audit
         auto configuredConnections = static_cast<int>(connections.size());
         if (configuredConnections == 0) {
-            Iec104Utility::audit_info("SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-A-unused");
+            m_auditQueue.push(IEC104AuditQueue::Level::INFORMATION, "SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-A-unused");
         }
         if (configuredConnections <= 1) {
-            Iec104Utility::audit_info("SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-B-unused");
+            m_auditQueue.push(IEC104AuditQueue::Level::INFORMATION, "SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-B-unused");
         }
     }
     // Send initial path connection status audit
     int maxRedGroups = m_config->GetMaxRedGroups();
     for(int i=configuredRedGroups ; i<maxRedGroups ; i++) {
-        Iec104Utility::audit_info("SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-A-unused");
-        Iec104Utility::audit_info("SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-B-unused");
+        m_auditQueue.push(IEC104AuditQueue::Level::INFORMATION, "SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-A-unused");
+        m_auditQueue.push(IEC104AuditQueue::Level::INFORMATION, "SRVFL", m_iec104->getServiceName() + "-" + std::to_string(i) + "-B-unused");
     }
 
     // Send initial connection status audit
-    Iec104Utility::audit_fail("SRVFL", m_iec104->getServiceName() + "-disconnected");
+    m_auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", m_iec104->getServiceName() + "-disconnected");
 
     return true;
 }
@@ -1165,6 +1399,8 @@ IEC104Client::start()
     Iec104Utility::log_info("%s IEC104 client starting (started: %s)...", beforeLog.c_str(), m_started?"true":"false");
     if (m_started == false) {
 
+        m_auditQueue.start();
+
         prepareConnections();
 
         m_started = true;
@@ -1186,6 +1422,8 @@ IEC104Client::stop()
             m_monitoringThread->join();
             m_monitoringThread = nullptr;
         }
+        Iec104Utility::log_debug("%s Waiting for pending audits to be sent", beforeLog.c_str());
+        m_auditQueue.stop();
     }
     Iec104Utility::log_info("%s IEC104 client stopped!", beforeLog.c_str());
 }
@@ -1212,7 +1450,10 @@ IEC104Client::_monitoringThread()
 
     updateQualityForAllDataObjects(IEC60870_QUALITY_INVALID);
 
-    uint64_t backupConnectionStartTime = Hal_getTimeInMs() + BACKUP_CONNECTION_TIMEOUT;
+    /* the backup connections are tried after backup_delay of their redundancy group without active connection */
+    uint64_t noActiveConnectionSince = getMonotonicTimeInMs();
+
+    uint64_t nextAddressReport = getMonotonicTimeInMs() + (m_config->AddressReportPeriod() * 1000);
 
     while (m_started)
     {
@@ -1223,30 +1464,35 @@ IEC104Client::_monitoringThread()
             {
                 bool foundOpenConnections = false;
 
-                /* activate the first open connection */
-                for (auto clientConnection : m_connections)
-                {
-                    if (clientConnection->Connected()) {
+                /* activate the first open connection, or the one with the lowest cost */
+                std::shared_ptr<IEC104ClientConnection> clientConnection = selectPath(nullptr);
 
-                        backupConnectionStartTime = Hal_getTimeInMs() + BACKUP_CONNECTION_TIMEOUT;
+                if (clientConnection) {
 
-                        foundOpenConnections = true;
+                    noActiveConnectionSince = getMonotonicTimeInMs();
 
-                        clientConnection->Activate();
+                    foundOpenConnections = true;
 
-                        m_activeConnection = clientConnection;
+                    clientConnection->Activate();
 
-                        updateConnectionStatus(ConnectionStatus::STARTED);
+                    m_activeConnection = clientConnection;
+                    m_pathActivationTime = getMonotonicTimeInMs();
+                    m_betterPathSince = 0;
 
-                        Iec104Utility::log_info("%s Activated connection", beforeLog.c_str());
-                        break;
-                    }
+                    updateConnectionStatus(ConnectionStatus::STARTED);
+
+                    Iec104Utility::log_info("%s Activated connection %s-%s (cost: %ld)", beforeLog.c_str(),
+                                            clientConnection->RedGroup()->Name().c_str(), clientConnection->PathLetter().c_str(),
+                                            (long)clientConnection->PathCost());
                 }
 
                 if (foundOpenConnections) {
                     firstConnected = true;
                     qualityUpdateTimer = 0;
                     qualityUpdated = false;
+
+                    /* max_age is checked again from the activation of the connection */
+                    m_stalenessMonitor.restart();
                 }
                 else {
 
@@ -1270,23 +1516,20 @@ IEC104Client::_monitoringThread()
 
                     updateConnectionStatus(ConnectionStatus::NOT_CONNECTED);
 
-                    if (Hal_getTimeInMs() > backupConnectionStartTime)
+                    /* Connect the disconnected connections, they keep trying with their reconnect delays */
+                    for (auto clientConnection : m_connections)
                     {
-                        Iec104Utility::log_info("%s Activating backup connections", beforeLog.c_str());
-                        /* Connect all disconnected connections */
-                        for (auto clientConnection : m_connections)
+                        if (clientConnection->Disconnected() && !clientConnection->ConnectRequested() &&
+                            (getMonotonicTimeInMs() >= noActiveConnectionSince + clientConnection->BackupDelay()))
                         {
-                            if (clientConnection->Disconnected()) {
-                                clientConnection->Connect();
-                            }
+                            Iec104Utility::log_info("%s Activating backup connection", beforeLog.c_str());
+                            clientConnection->Connect();
                         }
-
-                        backupConnectionStartTime = Hal_getTimeInMs() + BACKUP_CONNECTION_TIMEOUT;
                     }
                 }
             }
             else {
-                backupConnectionStartTime = Hal_getTimeInMs() + BACKUP_CONNECTION_TIMEOUT;
+                noActiveConnectionSince = getMonotonicTimeInMs();
 
                 if (m_activeConnection->Connected() == false)
                 {
@@ -1305,11 +1548,38 @@ IEC104Client::_monitoringThread()
                             }
                         }
                     }
+
+                    if (m_config->isPathSwitchover()) {
+                        checkPathSwitchover(getMonotonicTimeInMs());
+                    }
                 }
             }
         }
 
-        checkOutstandingCommandTimeouts();
+        checkOutstandingCommandTimeouts();
+
+        std::shared_ptr<IEC104ClientConnection> activeConnection;
+
+        {
+            std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+            activeConnection = m_activeConnection;
+        }
+
+        /* slots freed by timeouts, or queued commands that could not be sent */
+        dispatchQueuedCommands(activeConnection);
+
+        /* all the data objects are already non topical when no connection is active */
+        if (activeConnection) {
+            updateQualityForStaleDataObjects();
+        }
+
+        if ((m_config->AddressReportPeriod() > 0) && (getMonotonicTimeInMs() >= nextAddressReport)) {
+            if (m_config->AddressReport().newPeriod()) {
+                logAddressReport();
+            }
+
+            nextAddressReport = getMonotonicTimeInMs() + (m_config->AddressReportPeriod() * 1000);
+        }
 
         Thread_sleep(100);
     }
@@ -1325,13 +1595,78 @@ IEC104Client::_monitoringThread()
         std::lock_guard<std::mutex> lock2(m_outstandingCommandsMtx);
         m_outstandingCommands.clear();
     }
+    m_commandQueue.clear();
     m_connections.clear();
     updateConnectionStatus(ConnectionStatus::NOT_CONNECTED);
 }
 
+std::shared_ptr<IEC104ClientConnection>
+IEC104Client::selectPath(const std::shared_ptr<IEC104ClientConnection>& excluded)
+{
+    std::shared_ptr<IEC104ClientConnection> selected;
+    int64_t selectedCost = -1;
+
+    for (auto clientConnection : m_connections)
+    {
+        if ((clientConnection == excluded) || !clientConnection->Connected())
+            continue;
+
+        if (!m_config->isRttPathSelection())
+            return clientConnection;
+
+        /* the paths not measured yet come after the measured ones, in the configuration order */
+        int64_t cost = clientConnection->PathCost();
+
+        if (!selected || IEC104PathHealth::isBetter(cost, selectedCost, 0)) {
+            selected = clientConnection;
+            selectedCost = cost;
+        }
+    }
+
+    return selected;
+}
+
+void
+IEC104Client::checkPathSwitchover(uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::checkPathSwitchover -";
+
+    std::shared_ptr<IEC104ClientConnection> candidate = selectPath(m_activeConnection);
+    int64_t activeCost = m_activeConnection->PathCost();
+
+    if (!candidate || (activeCost < 0) || !IEC104PathHealth::isBetter(candidate->PathCost(), activeCost, m_config->PathHysteresis())) {
+        m_betterPathSince = 0;
+        return;
+    }
+
+    if (m_betterPathSince == 0) {
+        m_betterPathSince = currentTime;
+    }
+
+    uint64_t holdTime = static_cast<uint64_t>(m_config->PathHoldTime()) * 1000;
+
+    /* the path has to stay better for hold_time, and the active one was activated at least hold_time ago */
+    if ((currentTime - m_betterPathSince < holdTime) || (currentTime - m_pathActivationTime < holdTime))
+        return;
+
+    Iec104Utility::log_info("%s Switching active connection from %s-%s (cost: %ld) to %s-%s (cost: %ld)", beforeLog.c_str(),
+                            m_activeConnection->RedGroup()->Name().c_str(), m_activeConnection->PathLetter().c_str(), (long)activeCost,
+                            candidate->RedGroup()->Name().c_str(), candidate->PathLetter().c_str(), (long)candidate->PathCost());
+
+    m_activeConnection->Deactivate();
+    candidate->Activate();
+
+    m_activeConnection = candidate;
+    m_pathActivationTime = currentTime;
+    m_betterPathSince = 0;
+    m_pathSwitchovers++;
+}
+
 bool
 IEC104Client::sendInterrogationCommand(int ca)
 {
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendInterrogationCommand -";
+
     // send interrogation request over active connection
     bool success = false;
 
@@ -1339,12 +1674,45 @@ IEC104Client::sendInterrogationCommand(int ca)
 
     if (m_activeConnection != nullptr)
     {
-        success = m_activeConnection->sendInterrogationCommand(ca);
+        uint64_t minInterval = static_cast<uint64_t>(m_config->GiMinInterval()) * 1000;
+
+        switch (m_giArbiter.admit(IEC104GiArbiter::Source::OPERATION, getMonotonicTimeInMs(), minInterval)) {
+            case IEC104GiArbiter::Admission::MERGED:
+                Iec104Utility::log_info("%s Interrogation of CA %i covered by the pending GI", beforeLog.c_str(), ca);
+                success = true;
+                break;
+
+            case IEC104GiArbiter::Admission::DEFER:
+                Iec104Utility::log_info("%s Interrogation of CA %i delayed by gi_min_interval", beforeLog.c_str(), ca);
+                m_activeConnection->requestInterrogation(std::vector<int>{ca});
+                success = true;
+                break;
+
+            default:
+                success = m_activeConnection->sendInterrogationCommand(ca);
+                break;
+        }
     }
 
     return success;
 }
 
+static IEC104CommandQueue::Command makeCommand(int typeId, int ca, int ioa, double value, bool select, long time,
+                                               IEC104CommandQueue::Priority priority)
+{
+    IEC104CommandQueue::Command command;
+
+    command.typeId = typeId;
+    command.ca = ca;
+    command.ioa = ioa;
+    command.value = value;
+    command.select = select;
+    command.time = time;
+    command.priority = priority;
+
+    return command;
+}
+
 std::shared_ptr<IEC104Client::OutstandingCommand> IEC104Client::addOutstandingCommandAndCheckLimit(int ca, int ioa, bool withTime, int typeIdWithTimestamp, int typeIdNoTimestamp)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::addOutstandingCommandAndCheckLimit -";
@@ -1354,23 +1722,26 @@ std::shared_ptr<IEC104Client::OutstandingCommand> IEC104Client::addOutstandingCo
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
+    std::lock_guard<std::mutex> lock2(m_outstandingCommandsMtx);
+
     int cmdParrallel = m_config->CmdParallel();
     int typeId = withTime ? typeIdWithTimestamp : typeIdNoTimestamp;
-    if (cmdParrallel > 0) {
 
-        if (m_outstandingCommands.size() < cmdParrallel) {
-            command = std::make_shared<OutstandingCommand>(typeId, ca, ioa, m_activeConnection);
-        }
-        else {
-            Iec104Utility::log_warn("%s Maximum number of parallel command exceeded (%d) -> ignore command with typeId=%s, CA=%d, IOA=%d",
-                                    beforeLog.c_str(), cmdParrallel, IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa);
-            return nullptr;
-        }
+    /* queued commands get the free slots first */
+    if (((cmdParrallel > 0) && (m_outstandingCommands.size() >= cmdParrallel)) || (m_commandQueue.Size() > 0)) {
+        Iec104Utility::log_debug("%s Maximum number of parallel command reached (%d) or commands queued -> queue command with typeId=%s, CA=%d, IOA=%d",
+                                beforeLog.c_str(), cmdParrallel, IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa);
+        return nullptr;
     }
-    else {
-        command = std::make_shared<OutstandingCommand>(typeId, ca, ioa, m_activeConnection);
+
+    if ((m_activeConnection != nullptr) && !m_activeConnection->takeCommandToken()) {
+        Iec104Utility::log_debug("%s Command rate of the redundancy group reached -> queue command with typeId=%s, CA=%d, IOA=%d",
+                                beforeLog.c_str(), IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa);
+        return nullptr;
     }
 
+    command = std::make_shared<OutstandingCommand>(typeId, ca, ioa, m_activeConnection);
+
     if (command) {
         m_outstandingCommands.push_back(command);
     }
@@ -1379,7 +1750,7 @@ std::shared_ptr<IEC104Client::OutstandingCommand> IEC104Client::addOutstandingCo
 }
 
 bool
-IEC104Client::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long time)
+IEC104Client::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSingleCommand -";
     // send single command over active connection
@@ -1387,7 +1758,7 @@ IEC104Client::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_SC_TA_1":"C_SC_NA_1";
-    if (m_config->checkExchangeDataLayer(C_SC_NA_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_SC_NA_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1396,7 +1767,7 @@ IEC104Client::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_SC_TA_1, C_SC_NA_1);
 
     if (command == nullptr)
-        return false; //LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_SC_TA_1 : C_SC_NA_1, ca, ioa, value, select, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1409,13 +1780,13 @@ IEC104Client::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
 
     return success;
 }
 
 bool
-IEC104Client::sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool select, long time)
+IEC104Client::sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool select, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendDoubleCommand -";
     // send double command over active connection
@@ -1423,7 +1794,7 @@ IEC104Client::sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_DC_TA_1":"C_DC_NA_1";
-    if (m_config->checkExchangeDataLayer(C_DC_NA_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_DC_NA_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1432,7 +1803,7 @@ IEC104Client::sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_DC_TA_1, C_DC_NA_1);
 
     if (command == nullptr)
-        return false;//LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_DC_TA_1 : C_DC_NA_1, ca, ioa, value, select, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1445,13 +1816,13 @@ IEC104Client::sendDoubleCommand(int ca, int ioa, int value, bool withTime, bool
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
 
     return success;
 }
 
 bool
-IEC104Client::sendStepCommand(int ca, int ioa, int value, bool withTime, bool select, long time)
+IEC104Client::sendStepCommand(int ca, int ioa, int value, bool withTime, bool select, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendStepCommand -";
     // send step command over active connection
@@ -1459,7 +1830,7 @@ IEC104Client::sendStepCommand(int ca, int ioa, int value, bool withTime, bool se
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_RC_TA_1":"C_RC_NA_1";
-    if (m_config->checkExchangeDataLayer(C_RC_NA_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_RC_NA_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1468,7 +1839,7 @@ IEC104Client::sendStepCommand(int ca, int ioa, int value, bool withTime, bool se
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_RC_TA_1, C_RC_NA_1);
 
     if (command == nullptr)
-        return false;//LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_RC_TA_1 : C_RC_NA_1, ca, ioa, value, select, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1481,13 +1852,13 @@ IEC104Client::sendStepCommand(int ca, int ioa, int value, bool withTime, bool se
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
 
     return success;
 }
 
 bool
-IEC104Client::sendSetpointNormalized(int ca, int ioa, float value, bool withTime, long time)
+IEC104Client::sendSetpointNormalized(int ca, int ioa, float value, bool withTime, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSetpointNormalized -";
     // send setpoint command normalized over active connection
@@ -1495,7 +1866,7 @@ IEC104Client::sendSetpointNormalized(int ca, int ioa, float value, bool withTime
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_SE_TA_1":"C_SE_NA_1";
-    if (m_config->checkExchangeDataLayer(C_SE_NA_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_SE_NA_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1504,7 +1875,7 @@ IEC104Client::sendSetpointNormalized(int ca, int ioa, float value, bool withTime
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_SE_TA_1, C_SE_NA_1);
 
     if (command == nullptr)
-        return false;//LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_SE_TA_1 : C_SE_NA_1, ca, ioa, value, false, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1517,13 +1888,13 @@ IEC104Client::sendSetpointNormalized(int ca, int ioa, float value, bool withTime
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
 
     return success;
 }
 
 bool
-IEC104Client::sendSetpointScaled(int ca, int ioa, int value, bool withTime, long time)
+IEC104Client::sendSetpointScaled(int ca, int ioa, int value, bool withTime, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSetpointScaled -";
     // send setpoint command scaled over active connection
@@ -1531,7 +1902,7 @@ IEC104Client::sendSetpointScaled(int ca, int ioa, int value, bool withTime, long
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_SE_TB_1":"C_SE_NB_1";
-    if (m_config->checkExchangeDataLayer(C_SE_NB_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_SE_NB_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1540,7 +1911,7 @@ IEC104Client::sendSetpointScaled(int ca, int ioa, int value, bool withTime, long
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_SE_TB_1, C_SE_NB_1);
 
     if (command == nullptr)
-        return false;//LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_SE_TB_1 : C_SE_NB_1, ca, ioa, value, false, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1553,13 +1924,13 @@ IEC104Client::sendSetpointScaled(int ca, int ioa, int value, bool withTime, long
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
 
     return success;
 }
 
 bool
-IEC104Client::sendSetpointShort(int ca, int ioa, float value, bool withTime, long time)
+IEC104Client::sendSetpointShort(int ca, int ioa, float value, bool withTime, long time, IEC104CommandQueue::Priority priority)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSetpointShort -";
     // send setpoint command short over active connection
@@ -1567,7 +1938,7 @@ IEC104Client::sendSetpointShort(int ca, int ioa, float value, bool withTime, lon
 
     // check if the data point is in the exchange configuration
     std::string cmdName = withTime?"C_SE_TC_1":"C_SE_NC_1";
-    if (m_config->checkExchangeDataLayer(C_SE_NC_1, ca, ioa) == nullptr) {
+    if (m_config->checkExchangeDataLayer(C_SE_NC_1, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
         Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
         return false;
@@ -1576,7 +1947,7 @@ IEC104Client::sendSetpointShort(int ca, int ioa, float value, bool withTime, lon
     std::shared_ptr<OutstandingCommand> command = addOutstandingCommandAndCheckLimit(ca, ioa, withTime, C_SE_TC_1, C_SE_NC_1);
 
     if (command == nullptr)
-        return false;//LCOV_EXCL_LINE
+        return queueCommand(makeCommand(withTime ? C_SE_TC_1 : C_SE_NC_1, ca, ioa, value, false, time, priority));
 
     std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
 
@@ -1589,11 +1960,424 @@ IEC104Client::sendSetpointShort(int ca, int ioa, float value, bool withTime, lon
                                 beforeLog.c_str(), cmdName.c_str(), ca, ioa);
     }
 
-    if (!success) removeOutstandingCommand(command);
+    if (!success) commandNotSent(command);
+
+    return success;
+}
+
+static bool isSetpointCommand(int typeId)
+{
+    return ((typeId >= C_SE_NA_1) && (typeId <= C_SE_NC_1)) || ((typeId >= C_SE_TA_1) && (typeId <= C_SE_TC_1));
+}
+
+// type ID without time tag, used for the exchange configuration lookup of a command
+static int commandTypeWithoutTime(int typeId)
+{
+    if ((typeId >= C_SC_TA_1) && (typeId <= C_SE_TC_1))
+        return typeId - (C_SC_TA_1 - C_SC_NA_1);
+
+    return typeId;
+}
+
+bool
+IEC104Client::sendSelectBeforeOperate(IEC104CommandQueue::Command command)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSelectBeforeOperate -";
+    bool success = false;
+
+    std::string cmdName = IEC104ClientConfig::getStringFromTypeID(command.typeId);
+    int typeId = commandTypeWithoutTime(command.typeId);
+
+    if ((typeId != C_SC_NA_1) && (typeId != C_DC_NA_1) && (typeId != C_RC_NA_1)) {
+        Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) cannot be selected",
+                                beforeLog.c_str(), cmdName.c_str(), command.ca, command.ioa);
+        return false;
+    }
+
+    // check if the data point is in the exchange configuration
+    if (m_config->checkExchangeDataLayer(typeId, command.ca, command.ioa) == IEC104ExchangeTable::NO_POINT) {
+        Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
+                                beforeLog.c_str(), cmdName.c_str(), command.ca, command.ioa);
+        return false;
+    }
+
+    command.select = true;
+    command.sbo = true;
+
+    std::shared_ptr<OutstandingCommand> outstandingCommand = addOutstandingCommandAndCheckLimit(command.ca, command.ioa, false,
+                                                                                                command.typeId, command.typeId);
+
+    if (outstandingCommand == nullptr)
+        return queueCommand(command);
+
+    outstandingCommand->selectBeforeOperate(command);
+
+    std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+
+    if (m_activeConnection != nullptr)
+    {
+        success = sendQueuedCommand(*m_activeConnection, command);
+    }
+    else {
+        Iec104Utility::log_warn("%s No active connection, cannot send command %s (CA: %d, IOA: %d)",
+                                beforeLog.c_str(), cmdName.c_str(), command.ca, command.ioa);
+    }
+
+    if (!success) commandNotSent(outstandingCommand);
 
     return success;
 }
 
+bool
+IEC104Client::sendCommandBatch(std::vector<IEC104CommandQueue::Command>& commands)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendCommandBatch -";
+
+    std::shared_ptr<IEC104ClientConnection> activeConnection;
+
+    {
+        std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+        activeConnection = m_activeConnection;
+    }
+
+    if (activeConnection == nullptr) {
+        Iec104Utility::log_warn("%s No active connection, cannot send batch of %lu commands", beforeLog.c_str(), commands.size());
+        return false;
+    }
+
+    uint32_t batchId = m_nextBatchId++;
+    size_t queued = 0;
+
+    for (auto& command : commands) {
+        command.batchId = batchId;
+        command.sendFailedSince = 0;
+
+        if (m_config->checkExchangeDataLayer(commandTypeWithoutTime(command.typeId), command.ca, command.ioa) == IEC104ExchangeTable::NO_POINT) {
+            Iec104Utility::log_error("%s Command %s (CA: %d, IOA: %d) not found in exchange configuration",
+                                    beforeLog.c_str(), IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(), command.ca, command.ioa);
+            sendCommandResult(batchId, command.index, command.typeId, command.ca, command.ioa, "invalid");
+            continue;
+        }
+
+        command.priority = IEC104CommandQueue::Priority::BULK;
+
+        if (!enqueueCommand(command)) {
+            sendCommandResult(batchId, command.index, command.typeId, command.ca, command.ioa, "rejected");
+            continue;
+        }
+
+        queued++;
+    }
+
+    Iec104Utility::log_info("%s Batch %u: %lu commands queued, %lu invalid or rejected", beforeLog.c_str(), batchId, queued,
+                            commands.size() - queued);
+
+    dispatchQueuedCommands(activeConnection);
+
+    return (queued > 0);
+}
+
+bool
+IEC104Client::enqueueCommand(IEC104CommandQueue::Command& command)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::enqueueCommand -";
+
+    if (m_config->CmdQueueSize() == 0) {
+        Iec104Utility::log_warn("%s Maximum number of parallel command exceeded (%d) -> ignore command with typeId=%s, CA=%d, IOA=%d",
+                                beforeLog.c_str(), m_config->CmdParallel(), IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(),
+                                command.ca, command.ioa);
+        return false;
+    }
+
+    int deadline = m_config->CmdQueueDeadline(static_cast<int>(command.priority));
+
+    command.queuedAt = getMonotonicTimeInMs();
+    command.deadline = (deadline > 0) ? command.queuedAt + (static_cast<uint64_t>(deadline) * 1000) : 0;
+
+    /* only the latest value of a set point is sent */
+    if (m_config->isSetpointCoalescing() && isSetpointCommand(command.typeId)) {
+        IEC104CommandQueue::Command superseded;
+
+        if (m_commandQueue.replace(command, superseded)) {
+            Iec104Utility::log_debug("%s Queued set point %s (CA=%d, IOA=%d) replaced by a newer value", beforeLog.c_str(),
+                                    IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(), command.ca, command.ioa);
+            sendCommandResult(superseded.batchId, superseded.index, superseded.typeId, superseded.ca, superseded.ioa, "superseded");
+            return true;
+        }
+    }
+
+    std::vector<IEC104CommandQueue::Command> dropped;
+
+    bool queued = m_commandQueue.push(command, static_cast<size_t>(m_config->CmdQueueSize()), dropped);
+
+    for (const auto& droppedCommand : dropped) {
+        Iec104Utility::log_warn("%s Command queue full -> drop %s command with typeId=%s, CA=%d, IOA=%d", beforeLog.c_str(),
+                                IEC104CommandQueue::priorityName(droppedCommand.priority),
+                                IEC104ClientConfig::getStringFromTypeID(droppedCommand.typeId).c_str(), droppedCommand.ca, droppedCommand.ioa);
+        sendCommandResult(droppedCommand.batchId, droppedCommand.index, droppedCommand.typeId, droppedCommand.ca, droppedCommand.ioa, "dropped");
+    }
+
+    if (!queued) {
+        Iec104Utility::log_warn("%s Command queue full (%d) -> ignore %s command with typeId=%s, CA=%d, IOA=%d", beforeLog.c_str(),
+                                m_config->CmdQueueSize(), IEC104CommandQueue::priorityName(command.priority),
+                                IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(), command.ca, command.ioa);
+    }
+
+    return queued;
+}
+
+bool
+IEC104Client::queueCommand(IEC104CommandQueue::Command command)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::queueCommand -";
+
+    std::shared_ptr<IEC104ClientConnection> activeConnection;
+
+    {
+        std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+        activeConnection = m_activeConnection;
+    }
+
+    if (activeConnection == nullptr) {
+        Iec104Utility::log_warn("%s No active connection, cannot send command %s (CA: %d, IOA: %d)",
+                                beforeLog.c_str(), IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(), command.ca, command.ioa);
+        return false;
+    }
+
+    if (!enqueueCommand(command))
+        return false;
+
+    Iec104Utility::log_debug("%s Queued %s command %s (CA: %d, IOA: %d), %lu commands queued", beforeLog.c_str(),
+                            IEC104CommandQueue::priorityName(command.priority), IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(),
+                            command.ca, command.ioa, m_commandQueue.Size());
+
+    dispatchQueuedCommands(activeConnection);
+
+    return true;
+}
+
+void
+IEC104Client::dispatchQueuedCommands(std::shared_ptr<IEC104ClientConnection> connection)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::dispatchQueuedCommands -";
+
+    if (m_commandQueue.Size() == 0)
+        return;
+
+    std::vector<IEC104CommandQueue::Command> expired;
+
+    m_commandQueue.expire(getMonotonicTimeInMs(), expired);
+
+    for (const auto& command : expired) {
+        Iec104Utility::log_warn("%s Deadline of queued %s command %s (CA: %d, IOA: %d) elapsed", beforeLog.c_str(),
+                                IEC104CommandQueue::priorityName(command.priority), IEC104ClientConfig::getStringFromTypeID(command.typeId).c_str(),
+                                command.ca, command.ioa);
+        sendCommandResult(command.batchId, command.index, command.typeId, command.ca, command.ioa, "expired");
+    }
+
+    /* no active connection: the commands stay queued until their deadline or the activation of a connection */
+    if (connection == nullptr)
+        return;
+
+    int cmdParallel = m_config->CmdParallel();
+
+    while (true) {
+        IEC104CommandQueue::Command command;
+        std::shared_ptr<OutstandingCommand> outstandingCommand;
+
+        {
+            /* the slot is taken before sending, concurrent dispatches never exceed cmd_parallel */
+            std::lock_guard<std::mutex> lock(m_outstandingCommandsMtx);
+
+            if ((cmdParallel > 0) && (m_outstandingCommands.size() >= static_cast<size_t>(cmdParallel)))
+                return;
+
+            if (m_commandQueue.Size() == 0)
+                return;
+
+            /* paced, sent at a next dispatch */
+            if (!connection->takeCommandToken())
+                return;
+
+            if (!m_commandQueue.pop(command))
+                return;
+
+            outstandingCommand = std::make_shared<OutstandingCommand>(command.typeId, command.ca, command.ioa, connection);
+            outstandingCommand->batchId = command.batchId;
+            outstandingCommand->batchIndex = command.index;
+
+            if (command.sbo) {
+                outstandingCommand->selectBeforeOperate(command);
+            }
+
+            m_outstandingCommands.push_back(outstandingCommand);
+        }
+
+        if (sendQueuedCommand(*connection, command)) {
+            m_commandQueue.released(command, getMonotonicTimeInMs());
+            continue;
+        }
+
+        commandNotSent(outstandingCommand);
+
+        uint64_t currentTime = getMonotonicTimeInMs();
+
+        if (command.sendFailedSince == 0) {
+            command.sendFailedSince = currentTime;
+        }
+
+        if (currentTime - command.sendFailedSince > static_cast<uint64_t>(m_config->CmdExecTimeout())) {
+            sendCommandResult(command.batchId, command.index, command.typeId, command.ca, command.ioa, "failed");
+            continue;
+        }
+
+        /* connection not ready or k window full, the command is sent first at the next dispatch */
+        m_commandQueue.pushFront(command);
+
+        return;
+    }
+}
+
+bool
+IEC104Client::sendQueuedCommand(IEC104ClientConnection& connection, const IEC104CommandQueue::Command& command)
+{
+    bool withTime = (command.typeId != commandTypeWithoutTime(command.typeId));
+
+    switch (commandTypeWithoutTime(command.typeId)) {
+        case C_SC_NA_1:
+            return connection.sendSingleCommand(command.ca, command.ioa, (command.value != 0), withTime, command.select, command.time);
+        case C_DC_NA_1:
+            return connection.sendDoubleCommand(command.ca, command.ioa, static_cast<int>(command.value), withTime, command.select, command.time);
+        case C_RC_NA_1:
+            return connection.sendStepCommand(command.ca, command.ioa, static_cast<int>(command.value), withTime, command.select, command.time);
+        case C_SE_NA_1:
+            return connection.sendSetpointNormalized(command.ca, command.ioa, static_cast<float>(command.value), withTime, command.time);
+        case C_SE_NB_1:
+            return connection.sendSetpointScaled(command.ca, command.ioa, static_cast<int>(command.value), withTime, command.time);
+        case C_SE_NC_1:
+            return connection.sendSetpointShort(command.ca, command.ioa, static_cast<float>(command.value), withTime, command.time);
+        default:
+            return false;
+    }
+}
+
+void
+IEC104Client::sendSelectedCommand(std::shared_ptr<OutstandingCommand> select)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendSelectedCommand -";
+
+    auto command = std::make_shared<OutstandingCommand>(select->typeId, select->ca, select->ioa, select->clientCon);
+    command->batchId = select->batchId;
+    command->batchIndex = select->batchIndex;
+    command->sbo = true;
+
+    {
+        /* the execute takes the slot of the select, no queued command can take it in between */
+        std::lock_guard<std::mutex> lock(m_outstandingCommandsMtx);
+
+        auto it = std::find(m_outstandingCommands.begin(), m_outstandingCommands.end(), select);
+
+        /* select timed out meanwhile, its failure is already reported: the execute is not sent */
+        if (it == m_outstandingCommands.end()) {
+            Iec104Utility::log_warn("%s Select of %s (CA: %d, IOA: %d) not outstanding anymore -> execute dropped", beforeLog.c_str(),
+                                    IEC104ClientConfig::getStringFromTypeID(command->typeId).c_str(), command->ca, command->ioa);
+            return;
+        }
+
+        *it = command;
+    }
+
+    Iec104Utility::log_debug("%s Select of %s (CA: %d, IOA: %d) confirmed -> send execute", beforeLog.c_str(),
+                            IEC104ClientConfig::getStringFromTypeID(command->typeId).c_str(), command->ca, command->ioa);
+
+    if (sendQueuedCommand(*select->clientCon, *select->execute))
+        return;
+
+    Iec104Utility::log_warn("%s Failed to send execute of %s (CA: %d, IOA: %d)", beforeLog.c_str(),
+                            IEC104ClientConfig::getStringFromTypeID(command->typeId).c_str(), command->ca, command->ioa);
+
+    removeOutstandingCommand(command);
+    commandCompleted(*command, "failed");
+}
+
+void
+IEC104Client::commandCompleted(const OutstandingCommand& command, const std::string& result)
+{
+    reportOutstandingCommand(command, result);
+
+    /* the connection of the command may not be the active one anymore (switchover or failover) */
+    std::shared_ptr<IEC104ClientConnection> activeConnection;
+
+    {
+        std::lock_guard<std::mutex> lock(m_activeConnectionMtx);
+        activeConnection = m_activeConnection;
+    }
+
+    dispatchQueuedCommands(activeConnection);
+}
+
+void
+IEC104Client::reportOutstandingCommand(const OutstandingCommand& command, const std::string& result)
+{
+    int64_t actConLatency = -1;
+    int64_t actTermLatency = -1;
+
+    if (command.actConTime != 0) {
+        actConLatency = static_cast<int64_t>(command.actConTime - command.sentTime);
+
+        /* completed by its ACT-TERM */
+        if (command.actConReceived && (result == "success")) {
+            actTermLatency = static_cast<int64_t>(getMonotonicTimeInMs() - command.actConTime);
+        }
+    }
+
+    m_commandLatency.record(command.typeId, command.ca, actConLatency, actTermLatency,
+                            (result == "timeout") || (result == "select_timeout"));
+
+    sendCommandResult(command.batchId, command.batchIndex, command.typeId, command.ca, command.ioa, result, actConLatency, actTermLatency);
+}
+
+void
+IEC104Client::sendCommandResult(uint32_t batchId, uint32_t index, int typeId, int ca, int ioa, const std::string& result,
+                                int64_t actConLatency, int64_t actTermLatency)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104Client::sendCommandResult -";
+
+    if (batchId != 0) {
+        Iec104Utility::log_info("%s Batch %u command %u %s (CA: %d, IOA: %d): %s", beforeLog.c_str(), batchId, index,
+                                IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa, result.c_str());
+    }
+    else {
+        Iec104Utility::log_info("%s Command %s (CA: %d, IOA: %d): %s", beforeLog.c_str(),
+                                IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), ca, ioa, result.c_str());
+    }
+
+    if (m_config->GetConnxStatusSignal().empty())
+        return;
+
+    auto* attributes = new vector<Datapoint*>;
+
+    attributes->push_back(m_createDatapoint("batch_id", (long)batchId));
+    attributes->push_back(m_createDatapoint("index", (long)index));
+    attributes->push_back(m_createDatapoint("co_type", IEC104ClientConfig::getStringFromTypeID(typeId)));
+    attributes->push_back(m_createDatapoint("co_ca", (long)ca));
+    attributes->push_back(m_createDatapoint("co_ioa", (long)ioa));
+    attributes->push_back(m_createDatapoint("result", result));
+    attributes->push_back(m_createDatapoint("act_con_ms", (long)actConLatency));
+    attributes->push_back(m_createDatapoint("act_term_ms", (long)actTermLatency));
+
+    DatapointValue dpv(attributes, true);
+
+    vector<Datapoint*> datapoints;
+    vector<const string*> labels;
+
+    datapoints.push_back(new Datapoint("command_result", dpv));
+
+    labels.push_back(&m_config->GetConnxStatusSignal());
+
+    sendData(datapoints, labels);
+}
+
  bool
  IEC104Client::sendConnectionStatus()
  {
@@ -1612,7 +2396,7 @@ bool IEC104Client::scheduleGI()
 {
     if (m_activeConnection != nullptr)
     {
-        m_activeConnection->setGiRequested(true);
+        m_giArbiter.request(IEC104GiArbiter::Source::NORTH_STATUS);
         return true;
     }
     return false;
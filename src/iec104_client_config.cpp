@@ -1,5 +1,11 @@
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <map>
 #include <algorithm>
 
+#include <rapidjson/reader.h>
 #include <rapidjson/error/en.h>
 
 #include <arpa/inet.h>
@@ -7,6 +13,7 @@
 
 #include "iec104_client_config.h"
 #include "iec104_client_redgroup.h"
+#include "iec104_exchange_cache.h"
 #include "iec104_utility.h"
 
 
@@ -22,6 +29,8 @@
 #define JSON_PROT_ADDR "address"
 #define JSON_PROT_TYPEID "typeid"
 #define JSON_PROT_GI_GROUPS "gi_groups"
+#define JSON_PROT_STALE_AFTER "stale_after"
+#define JSON_PROT_MAX_AGE "max_age"
 #define JSON_TRIGGER_SOUTH_GI_PIVOT_SUBTYPE "trigger_south_gi"
 
 using namespace rapidjson;
@@ -277,6 +286,90 @@ IEC104ClientConfig::isMessageTypeMatching(int expectedType, int rcvdType)
 
             break;
 
+        case M_BO_NA_1:
+            if ((rcvdType == M_BO_TA_1) || (rcvdType == M_BO_TB_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_BO_TA_1:
+            if ((rcvdType == M_BO_NA_1) || (rcvdType == M_BO_TB_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_BO_TB_1:
+            if ((rcvdType == M_BO_NA_1) || (rcvdType == M_BO_TA_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_IT_NA_1:
+            if ((rcvdType == M_IT_TA_1) || (rcvdType == M_IT_TB_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_IT_TA_1:
+            if ((rcvdType == M_IT_NA_1) || (rcvdType == M_IT_TB_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_IT_TB_1:
+            if ((rcvdType == M_IT_NA_1) || (rcvdType == M_IT_TA_1)) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TA_1:
+            if (rcvdType == M_EP_TD_1) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TD_1:
+            if (rcvdType == M_EP_TA_1) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TB_1:
+            if (rcvdType == M_EP_TE_1) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TE_1:
+            if (rcvdType == M_EP_TB_1) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TC_1:
+            if (rcvdType == M_EP_TF_1) {
+                return true;
+            }
+
+            break;
+
+        case M_EP_TF_1:
+            if (rcvdType == M_EP_TC_1) {
+                return true;
+            }
+
+            break;
+
         case C_SC_NA_1:
             if (rcvdType == C_SC_TA_1) {
                 return true;
@@ -367,27 +460,40 @@ IEC104ClientConfig::isMessageTypeMatching(int expectedType, int rcvdType)
     return false;
 }
 
-std::string*
+uint32_t
 IEC104ClientConfig::checkExchangeDataLayer(int typeId, int ca, int ioa)
+{
+    return checkExchangeDataLayer(*ExchangeTable(), typeId, ca, ioa);
+}
+
+uint32_t
+IEC104ClientConfig::checkExchangeDataLayer(const IEC104ExchangeTable& exchangeTable, int typeId, int ca, int ioa)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::checkExchangeDataLayer -";
-    const auto& def = ExchangeDefinition()[ca][ioa];
 
-    if (def != nullptr) {
+    uint32_t pointId = exchangeTable.find(ca, ioa);
+
+    if (pointId != IEC104ExchangeTable::NO_POINT) {
+        int pointTypeId = exchangeTable.typeIds[pointId];
+
         // check if message type is matching the exchange definition
-        if (isMessageTypeMatching(def->typeId, typeId)) {
-            return &(def->label);
+        if (isMessageTypeMatching(pointTypeId, typeId)) {
+            return pointId;
         }
-        else {
+
+        if (m_addressReport.add(IEC104AddressReport::Error::TYPE_MISMATCH, ca, ioa, typeId)) {
             Iec104Utility::log_warn("%s data point %i:%i found but type %s (%i) not matching", beforeLog.c_str(), ca, ioa,
-                                    IEC104ClientConfig::getStringFromTypeID(def->typeId).c_str(), def->typeId);
+                                    IEC104ClientConfig::getStringFromTypeID(pointTypeId).c_str(), pointTypeId);
         }
+
+        return IEC104ExchangeTable::NO_POINT;
     }
-    else {
+
+    if (m_addressReport.add(IEC104AddressReport::Error::NOT_FOUND, ca, ioa, typeId)) {
         Iec104Utility::log_warn("%s data point %i:%i not found", beforeLog.c_str(), ca, ioa);
     }
 
-    return nullptr;
+    return IEC104ExchangeTable::NO_POINT;
 }
 
 bool
@@ -475,6 +581,10 @@ void IEC104ClientConfig::importProtocolConfig(const string& protocolConfig)
         }
     }
 
+    if (transportLayer.HasMember("path_selection")) {
+        importPathSelection(transportLayer["path_selection"]);
+    }
+
     /* Application layer parameters */
 
     if (applicationLayer.HasMember("orig_addr")) {
@@ -642,6 +752,42 @@ void IEC104ClientConfig::importProtocolConfig(const string& protocolConfig)
         }
     }
 
+    if (applicationLayer.HasMember("gi_parallel")) {
+        if (applicationLayer["gi_parallel"].IsInt()) {
+            int giParallel = applicationLayer["gi_parallel"].GetInt();
+
+            if (giParallel >= 1) {
+                m_giParallel = giParallel;
+            }
+            else {
+                Iec104Utility::log_warn("%s application_layer.gi_parallel value out of range [1..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), giParallel, m_giParallel);
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s application_layer.gi_parallel is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    m_giParallel);
+        }
+    }
+
+    if (applicationLayer.HasMember("gi_min_interval")) {
+        if (applicationLayer["gi_min_interval"].IsInt()) {
+            int giMinInterval = applicationLayer["gi_min_interval"].GetInt();
+
+            if (giMinInterval >= 0) {
+                m_giMinInterval = giMinInterval;
+            }
+            else {
+                Iec104Utility::log_warn("%s application_layer.gi_min_interval value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), giMinInterval, m_giMinInterval);
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s application_layer.gi_min_interval is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    m_giMinInterval);
+        }
+    }
+
     if (applicationLayer.HasMember("cmd_parallel")) {              
         if (applicationLayer["cmd_parallel"].IsInt()) {
             int cmdParallel = applicationLayer["cmd_parallel"].GetInt();
@@ -678,552 +824,1823 @@ void IEC104ClientConfig::importProtocolConfig(const string& protocolConfig)
         }
     }
 
+    if (applicationLayer.HasMember("address_report_period")) {
+        if (applicationLayer["address_report_period"].IsInt()) {
+            int addressReportPeriod = applicationLayer["address_report_period"].GetInt();
+
+            if (addressReportPeriod >= 0) {
+                m_addressReportPeriod = addressReportPeriod;
+            }
+            else {
+                Iec104Utility::log_warn("%s application_layer.address_report_period value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), addressReportPeriod, m_addressReportPeriod);
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s application_layer.address_report_period is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    m_addressReportPeriod);
+        }
+    }
+
+    if (applicationLayer.HasMember("asdu_filter")) {
+        importAsduFilter(applicationLayer["asdu_filter"]);
+    }
+
+    if (applicationLayer.HasMember("gi_group_cycles")) {
+        importGiGroupCycles(applicationLayer["gi_group_cycles"]);
+    }
+
+    if (applicationLayer.HasMember("gi_adaptive")) {
+        importGiAdaptive(applicationLayer["gi_adaptive"]);
+    }
+
+    if (applicationLayer.HasMember("read_refresh")) {
+        importReadRefresh(applicationLayer["read_refresh"]);
+    }
+
+    if (applicationLayer.HasMember("max_age")) {
+        importMaxAge(applicationLayer["max_age"]);
+    }
+
+    if (applicationLayer.HasMember("cmd_queue")) {
+        importCmdQueue(applicationLayer["cmd_queue"]);
+    }
+
     m_protocolConfigComplete = true;
 }
 
-void IEC104ClientConfig::importRedGroup(const Value& redGroup)
+void IEC104ClientConfig::importGiGroupCycles(const Value& giGroupCycles)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importRedGroup -";
-    
-    if (!redGroup.IsObject()) {
-        Iec104Utility::log_error("%s redundancy_groups element is not an object -> ignore", beforeLog.c_str());
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importGiGroupCycles -";
+
+    if (!giGroupCycles.IsArray()) {
+        Iec104Utility::log_warn("%s application_layer.gi_group_cycles is not an array -> ignore", beforeLog.c_str());
         return;
     }
-    
-    std::string redGroupName;
-    bool hasName = false;
-    if (redGroup.HasMember("rg_name")) {
-        if (redGroup["rg_name"].IsString()) {
-            redGroupName = redGroup["rg_name"].GetString();
-            hasName = true;
+
+    for (const Value& groupCycle : giGroupCycles.GetArray()) {
+        if (!groupCycle.IsObject() || !groupCycle.HasMember("group") || !groupCycle.HasMember("cycle")) {
+            Iec104Utility::log_warn("%s gi_group_cycles element is not an object with group and cycle -> ignore", beforeLog.c_str());
+            continue;
         }
-    }
-    if (!hasName) {
-        Iec104Utility::log_error("%s rg_name does not exist or is not a string -> ignore", beforeLog.c_str());
-        return;
-    }
 
-    auto redundancyGroup = std::make_shared<IEC104ClientRedGroup>(redGroupName, static_cast<int>(m_redundancyGroups.size()));
+        const Value& group = groupCycle["group"];
+        const Value& cycle = groupCycle["cycle"];
 
-    Iec104Utility::log_debug("%s Adding red group with name: %s", beforeLog.c_str(), redGroupName.c_str());
+        if (!group.IsInt() || (group.GetInt() < 1) || (group.GetInt() > IEC104ExchangeTable::GI_GROUP_MAX)) {
+            Iec104Utility::log_warn("%s gi_group_cycles.group is not an integer in range [1..%d] -> ignore", beforeLog.c_str(),
+                                    IEC104ExchangeTable::GI_GROUP_MAX);
+            continue;
+        }
 
-    if (redGroup.HasMember("connections") && redGroup["connections"].IsArray()) {
-        for (const Value& con : redGroup["connections"].GetArray()) {
-            importRedGroupCon(con, redundancyGroup);
+        if (!cycle.IsInt() || (cycle.GetInt() < 0)) {
+            Iec104Utility::log_warn("%s gi_group_cycles.cycle of group %d is not an integer in range [0..+Inf] -> ignore",
+                                    beforeLog.c_str(), group.GetInt());
+            continue;
         }
+
+        m_giGroupCycles[group.GetInt()] = cycle.GetInt();
     }
-    else {
-        Iec104Utility::log_debug("%s  connections does not exist or is not an array -> adding fallback group",
-                                beforeLog.c_str());
-    }
+}
 
-    if (redGroup.HasMember("k_value")) {
-        if (redGroup["k_value"].IsInt()) {
-            int kValue = redGroup["k_value"].GetInt();
+void IEC104ClientConfig::importAsduFilter(const Value& asduFilter)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importAsduFilter -";
 
-            if (kValue > 0 && kValue < 32768) {
-                redundancyGroup->K(kValue);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.k_value value out of range [1..32767]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), kValue, redundancyGroup->K());
-            }
+    if (!asduFilter.IsObject()) {
+        Iec104Utility::log_warn("%s application_layer.asdu_filter is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (asduFilter.HasMember("reject_unknown_ca")) {
+        if (asduFilter["reject_unknown_ca"].IsBool()) {
+            m_rejectUnknownCa = asduFilter["reject_unknown_ca"].GetBool();
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.k_value is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->K());
+            Iec104Utility::log_warn("%s asdu_filter.reject_unknown_ca is not a bool -> using default value (%s)", beforeLog.c_str(),
+                                    (m_rejectUnknownCa?"true":"false"));
         }
     }
 
-    if (redGroup.HasMember("w_value")) {
-        if (redGroup["w_value"].IsInt()) {
-            int wValue = redGroup["w_value"].GetInt();
+    if (asduFilter.HasMember("allowed_cot")) {
+        if (asduFilter["allowed_cot"].IsArray()) {
+            m_allowedCots = 0;
 
-            if (wValue > 0 && wValue < 32768) {
-                redundancyGroup->W(wValue);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.w_value value out of range [1..32767]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), wValue, redundancyGroup->W());
+            for (const Value& cot : asduFilter["allowed_cot"].GetArray()) {
+                if (cot.IsInt() && (cot.GetInt() >= 0) && (cot.GetInt() < 64)) {
+                    m_allowedCots |= (1ULL << cot.GetInt());
+                }
+                else {
+                    Iec104Utility::log_warn("%s asdu_filter.allowed_cot element is not an integer in range [0..63] -> ignore",
+                                            beforeLog.c_str());
+                }
             }
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.w_value is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->W());
+            Iec104Utility::log_warn("%s asdu_filter.allowed_cot is not an array -> all COTs allowed", beforeLog.c_str());
         }
     }
 
-    if (redGroup.HasMember("t0_timeout")) {
-        if (redGroup["t0_timeout"].IsInt()) {
-            int t0Timeout = redGroup["t0_timeout"].GetInt();
+    if (asduFilter.HasMember("allowed_types")) {
+        if (asduFilter["allowed_types"].IsArray()) {
+            m_allowedTypeIds.reset();
 
-            if (t0Timeout > 0 && t0Timeout < 256) {
-                redundancyGroup->T0(t0Timeout);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.t0_timeout value out of range [1..255]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), t0Timeout, redundancyGroup->T0());
+            for (const Value& type : asduFilter["allowed_types"].GetArray()) {
+                int typeId = type.IsString() ? getTypeIdFromString(type.GetString()) : 0;
+
+                if (typeId > 0) {
+                    m_allowedTypeIds.set(typeId);
+                }
+                else {
+                    Iec104Utility::log_warn("%s asdu_filter.allowed_types element is not a known type ID -> ignore", beforeLog.c_str());
+                }
             }
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.t0_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->T0());
+            Iec104Utility::log_warn("%s asdu_filter.allowed_types is not an array -> all types allowed", beforeLog.c_str());
         }
     }
 
-    if (redGroup.HasMember("t1_timeout")) {
-        if (redGroup["t1_timeout"].IsInt()) {
-            int t1Timeout = redGroup["t1_timeout"].GetInt();
-
-            if (t1Timeout > 0 && t1Timeout < 256) {
-                redundancyGroup->T1(t1Timeout);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.t1_timeout value out of range [1..255]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), t1Timeout, redundancyGroup->T1());
-            }
+    if (asduFilter.HasMember("test_asdu")) {
+        if (asduFilter["test_asdu"].IsString() && (asduFilter["test_asdu"].GetString() == std::string("accept"))) {
+            m_rejectTestAsdu = false;
+        }
+        else if (asduFilter["test_asdu"].IsString() && (asduFilter["test_asdu"].GetString() == std::string("reject"))) {
+            m_rejectTestAsdu = true;
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.t1_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->T1());
+            Iec104Utility::log_warn("%s asdu_filter.test_asdu is not \"accept\" or \"reject\" -> using default value (%s)",
+                                    beforeLog.c_str(), (m_rejectTestAsdu?"reject":"accept"));
         }
     }
+}
 
-    if (redGroup.HasMember("t2_timeout")) {
-        if (redGroup["t2_timeout"].IsInt()) {
-            int t2Timeout = redGroup["t2_timeout"].GetInt();
+void IEC104ClientConfig::importGiAdaptive(const Value& giAdaptive)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importGiAdaptive -";
 
-            if (t2Timeout > 0 && t2Timeout < 256) {
-                redundancyGroup->T2(t2Timeout);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.t2_timeout value out of range [1..255]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), t2Timeout, redundancyGroup->T2());
-            }
+    if (!giAdaptive.IsObject()) {
+        Iec104Utility::log_warn("%s application_layer.gi_adaptive is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (giAdaptive.HasMember("coverage")) {
+        if (giAdaptive["coverage"].IsInt() && (giAdaptive["coverage"].GetInt() >= 0) && (giAdaptive["coverage"].GetInt() <= 100)) {
+            m_giAdaptiveCoverage = giAdaptive["coverage"].GetInt();
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.t2_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->T2());
+            Iec104Utility::log_warn("%s gi_adaptive.coverage is not an integer in range [0..100] -> using default value (%d)",
+                                    beforeLog.c_str(), m_giAdaptiveCoverage);
         }
     }
 
-    if (redGroup.HasMember("t3_timeout")) {
-        if (redGroup["t3_timeout"].IsInt()) {
-            int t3Timeout = redGroup["t3_timeout"].GetInt();
-
-            if (t3Timeout > -1) {
-                redundancyGroup->T3(t3Timeout);
-            }
-            else {
-                Iec104Utility::log_warn("%s redGroup.t3_timeout value out of range [0..+Inf]: %d -> using default value (%d)",
-                                        beforeLog.c_str(), t3Timeout, redundancyGroup->T3());
-            }
+    if (giAdaptive.HasMember("max_reads")) {
+        if (giAdaptive["max_reads"].IsInt() && (giAdaptive["max_reads"].GetInt() >= 0)) {
+            m_giAdaptiveMaxReads = giAdaptive["max_reads"].GetInt();
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.t3_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
-                                    redundancyGroup->T3());
+            Iec104Utility::log_warn("%s gi_adaptive.max_reads is not an integer in range [0..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_giAdaptiveMaxReads);
         }
     }
 
-    if (redGroup.HasMember("tls")) {
-        if (redGroup["tls"].IsBool()) {
-            redundancyGroup->UseTLS(redGroup["tls"].GetBool());
+    if (giAdaptive.HasMember("max_skips")) {
+        if (giAdaptive["max_skips"].IsInt() && (giAdaptive["max_skips"].GetInt() >= 1)) {
+            m_giAdaptiveMaxSkips = giAdaptive["max_skips"].GetInt();
         }
         else {
-            Iec104Utility::log_warn("%s redGroup.tls is not a bool -> not using TLS", beforeLog.c_str());
+            Iec104Utility::log_warn("%s gi_adaptive.max_skips is not an integer in range [1..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_giAdaptiveMaxSkips);
         }
     }
-
-    m_redundancyGroups.push_back(redundancyGroup);
 }
 
-void IEC104ClientConfig::importRedGroupCon(const Value& con, std::shared_ptr<IEC104ClientRedGroup> redundancyGroup) const
+void IEC104ClientConfig::importReadRefresh(const Value& readRefresh)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importRedGroupCon -";
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importReadRefresh -";
 
-    if(!con.IsObject()) {
-        Iec104Utility::log_error("%s  connections element is not an object -> ignore", beforeLog.c_str());
+    if (!readRefresh.IsObject()) {
+        Iec104Utility::log_warn("%s application_layer.read_refresh is not an object -> ignore", beforeLog.c_str());
         return;
     }
 
-    if (!con.HasMember("srv_ip") || !con["srv_ip"].IsString()) {
-        Iec104Utility::log_error("%s  srv_ip does not exist or is not a string -> ignore", beforeLog.c_str());
-        return;
+    if (readRefresh.HasMember("stale_after")) {
+        if (readRefresh["stale_after"].IsInt() && (readRefresh["stale_after"].GetInt() >= 0)) {
+            m_readStaleAfter = readRefresh["stale_after"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s read_refresh.stale_after is not an integer in range [0..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_readStaleAfter);
+        }
     }
-    string srvIp = con["srv_ip"].GetString();
 
-    if (!isValidIPAddress(srvIp)) {
-        Iec104Utility::log_error("%s  srv_ip %s is not a valid IP address -> ignore", beforeLog.c_str(), srvIp.c_str());
-        return;
+    if (readRefresh.HasMember("max_outstanding")) {
+        if (readRefresh["max_outstanding"].IsInt() && (readRefresh["max_outstanding"].GetInt() >= 1)) {
+            m_readMaxOutstanding = readRefresh["max_outstanding"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s read_refresh.max_outstanding is not an integer in range [1..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_readMaxOutstanding);
+        }
     }
 
-    Iec104Utility::log_debug("%s  add to group: %s", beforeLog.c_str(), srvIp.c_str());
-
-    int tcpPort = 2404;
-    bool start = true;
-    bool conn = true;
-    
-    string clientIp;
+    if (readRefresh.HasMember("timeout")) {
+        if (readRefresh["timeout"].IsInt() && (readRefresh["timeout"].GetInt() >= 1)) {
+            m_readTimeout = readRefresh["timeout"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s read_refresh.timeout is not an integer in range [1..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_readTimeout);
+        }
+    }
+}
 
-    if (con.HasMember("clt_ip")) {
-        if (con["clt_ip"].IsString()) {
-            string cltIpStr = con["clt_ip"].GetString();
+void IEC104ClientConfig::importMaxAge(const Value& maxAge)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importMaxAge -";
 
-            if (isValidIPAddress(cltIpStr)) {
-                clientIp = cltIpStr;
+    if (!maxAge.IsObject()) {
+        Iec104Utility::log_warn("%s application_layer.max_age is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    for (auto it = maxAge.MemberBegin(); it != maxAge.MemberEnd(); ++it) {
+        std::string typeName = it->name.GetString();
+
+        int typeId = getTypeIdFromString(typeName);
+
+        if ((typeId <= 0) || (typeId >= 41)) {
+            Iec104Utility::log_warn("%s max_age: %s is not a monitoring direction type ID -> ignore", beforeLog.c_str(), typeName.c_str());
+            continue;
+        }
+
+        if (!it->value.IsInt() || (it->value.GetInt() < 0)) {
+            Iec104Utility::log_warn("%s max_age of %s is not an integer in range [0..+Inf] -> ignore", beforeLog.c_str(), typeName.c_str());
+            continue;
+        }
+
+        m_maxAgeByType[typeId] = it->value.GetInt();
+    }
+}
+
+void IEC104ClientConfig::importCmdQueue(const Value& cmdQueue)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importCmdQueue -";
+
+    if (!cmdQueue.IsObject()) {
+        Iec104Utility::log_warn("%s application_layer.cmd_queue is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (cmdQueue.HasMember("size")) {
+        if (cmdQueue["size"].IsInt() && (cmdQueue["size"].GetInt() >= 0)) {
+            m_cmdQueueSize = cmdQueue["size"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s cmd_queue.size is not an integer in range [0..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_cmdQueueSize);
+        }
+    }
+
+    if (cmdQueue.HasMember("coalesce_setpoints")) {
+        if (cmdQueue["coalesce_setpoints"].IsBool()) {
+            m_cmdQueueCoalesceSetpoints = cmdQueue["coalesce_setpoints"].GetBool();
+        }
+        else {
+            Iec104Utility::log_warn("%s cmd_queue.coalesce_setpoints is not a boolean -> using default value (%s)",
+                                    beforeLog.c_str(), m_cmdQueueCoalesceSetpoints ? "true" : "false");
+        }
+    }
+
+    if (cmdQueue.HasMember("deadline")) {
+        const Value& deadline = cmdQueue["deadline"];
+
+        if (!deadline.IsObject()) {
+            Iec104Utility::log_warn("%s cmd_queue.deadline is not an object -> ignore", beforeLog.c_str());
+            return;
+        }
+
+        static const char* priorities[] = {"protection", "operator", "bulk"};
+
+        for (int i = 0; i < 3; i++) {
+            if (!deadline.HasMember(priorities[i]))
+                continue;
+
+            if (deadline[priorities[i]].IsInt() && (deadline[priorities[i]].GetInt() >= 0)) {
+                m_cmdQueueDeadlines[i] = deadline[priorities[i]].GetInt();
             }
             else {
-                Iec104Utility::log_error("%s  clt_ip %s is not a valid IP address -> ignore client",
-                                        beforeLog.c_str(), cltIpStr.c_str());
+                Iec104Utility::log_warn("%s cmd_queue.deadline.%s is not an integer in range [0..+Inf] -> using default value (%d)",
+                                        beforeLog.c_str(), priorities[i], m_cmdQueueDeadlines[i]);
             }
         }
+    }
+}
+
+void IEC104ClientConfig::importPathSelection(const Value& pathSelection)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importPathSelection -";
+
+    if (!pathSelection.IsObject()) {
+        Iec104Utility::log_warn("%s transport_layer.path_selection is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (pathSelection.HasMember("mode")) {
+        if (pathSelection["mode"].IsString() && ((std::string(pathSelection["mode"].GetString()) == "first") ||
+                                                 (std::string(pathSelection["mode"].GetString()) == "rtt"))) {
+            m_rttPathSelection = (std::string(pathSelection["mode"].GetString()) == "rtt");
+        }
         else {
-            Iec104Utility::log_warn("%s  clt_ip is not a string -> ignore client",
-                                    beforeLog.c_str());
+            Iec104Utility::log_warn("%s path_selection.mode is not \"first\" or \"rtt\" -> using default value (%s)",
+                                    beforeLog.c_str(), m_rttPathSelection ? "rtt" : "first");
+        }
+    }
+
+    if (pathSelection.HasMember("switchover")) {
+        if (pathSelection["switchover"].IsBool()) {
+            m_pathSwitchover = pathSelection["switchover"].GetBool();
+        }
+        else {
+            Iec104Utility::log_warn("%s path_selection.switchover is not a boolean -> using default value (%s)",
+                                    beforeLog.c_str(), m_pathSwitchover ? "true" : "false");
+        }
+    }
+
+    if (pathSelection.HasMember("hysteresis")) {
+        if (pathSelection["hysteresis"].IsInt() && (pathSelection["hysteresis"].GetInt() >= 0) &&
+            (pathSelection["hysteresis"].GetInt() < 100)) {
+            m_pathHysteresis = pathSelection["hysteresis"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s path_selection.hysteresis is not an integer in range [0..99] -> using default value (%d)",
+                                    beforeLog.c_str(), m_pathHysteresis);
+        }
+    }
+
+    if (pathSelection.HasMember("hold_time")) {
+        if (pathSelection["hold_time"].IsInt() && (pathSelection["hold_time"].GetInt() >= 0)) {
+            m_pathHoldTime = pathSelection["hold_time"].GetInt();
+        }
+        else {
+            Iec104Utility::log_warn("%s path_selection.hold_time is not an integer in range [0..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), m_pathHoldTime);
+        }
+    }
+
+    if (m_pathSwitchover && !m_rttPathSelection) {
+        Iec104Utility::log_warn("%s path_selection.switchover needs mode \"rtt\" -> switchover disabled", beforeLog.c_str());
+        m_pathSwitchover = false;
+    }
+}
+
+void IEC104ClientConfig::importApciAutoTune(const Value& autoTune, std::shared_ptr<IEC104ClientRedGroup> redundancyGroup) const
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importApciAutoTune -";
+
+    if (!autoTune.IsObject()) {
+        Iec104Utility::log_warn("%s redGroup.apci_auto_tune is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (autoTune.HasMember("enabled")) {
+        if (autoTune["enabled"].IsBool()) {
+            redundancyGroup->AutoTune(autoTune["enabled"].GetBool());
+        }
+        else {
+            Iec104Utility::log_warn("%s apci_auto_tune.enabled is not a boolean -> using default value (%s)",
+                                    beforeLog.c_str(), redundancyGroup->AutoTune() ? "true" : "false");
+        }
+    }
+
+    if (autoTune.HasMember("w_min")) {
+        if (autoTune["w_min"].IsInt() && (autoTune["w_min"].GetInt() >= 1)) {
+            redundancyGroup->AutoTuneWMin(autoTune["w_min"].GetInt());
+        }
+        else {
+            Iec104Utility::log_warn("%s apci_auto_tune.w_min is not an integer in range [1..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), redundancyGroup->AutoTuneWMin());
         }
     }
+
+    if (autoTune.HasMember("w_max")) {
+        if (autoTune["w_max"].IsInt() && (autoTune["w_max"].GetInt() >= 0)) {
+            redundancyGroup->AutoTuneWMax(autoTune["w_max"].GetInt());
+        }
+        else {
+            Iec104Utility::log_warn("%s apci_auto_tune.w_max is not an integer in range [0..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), redundancyGroup->AutoTuneWMax());
+        }
+    }
+
+    if (autoTune.HasMember("t2_min")) {
+        if (autoTune["t2_min"].IsInt() && (autoTune["t2_min"].GetInt() >= 1)) {
+            redundancyGroup->AutoTuneT2Min(autoTune["t2_min"].GetInt());
+        }
+        else {
+            Iec104Utility::log_warn("%s apci_auto_tune.t2_min is not an integer in range [1..+Inf] -> using default value (%d)",
+                                    beforeLog.c_str(), redundancyGroup->AutoTuneT2Min());
+        }
+    }
+
+    if (autoTune.HasMember("k_max")) {
+        if (autoTune["k_max"].IsInt() && (autoTune["k_max"].GetInt() >= 0) && (autoTune["k_max"].GetInt() <= 32767)) {
+            redundancyGroup->AutoTuneKMax(autoTune["k_max"].GetInt());
+        }
+        else {
+            Iec104Utility::log_warn("%s apci_auto_tune.k_max is not an integer in range [0..32767] -> using default value (%d)",
+                                    beforeLog.c_str(), redundancyGroup->AutoTuneKMax());
+        }
+    }
+}
+
+void IEC104ClientConfig::importRedGroup(const Value& redGroup)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importRedGroup -";
     
-    if (con.HasMember("port")) {
-        if (con["port"].IsInt()) {
-            int tcpPortVal = con["port"].GetInt();
+    if (!redGroup.IsObject()) {
+        Iec104Utility::log_error("%s redundancy_groups element is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+    
+    std::string redGroupName;
+    bool hasName = false;
+    if (redGroup.HasMember("rg_name")) {
+        if (redGroup["rg_name"].IsString()) {
+            redGroupName = redGroup["rg_name"].GetString();
+            hasName = true;
+        }
+    }
+    if (!hasName) {
+        Iec104Utility::log_error("%s rg_name does not exist or is not a string -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    auto redundancyGroup = std::make_shared<IEC104ClientRedGroup>(redGroupName, static_cast<int>(m_redundancyGroups.size()));
+
+    Iec104Utility::log_debug("%s Adding red group with name: %s", beforeLog.c_str(), redGroupName.c_str());
+
+    if (redGroup.HasMember("connections") && redGroup["connections"].IsArray()) {
+        for (const Value& con : redGroup["connections"].GetArray()) {
+            importRedGroupCon(con, redundancyGroup);
+        }
+    }
+    else {
+        Iec104Utility::log_debug("%s  connections does not exist or is not an array -> adding fallback group",
+                                beforeLog.c_str());
+    }
+
+    if (redGroup.HasMember("k_value")) {
+        if (redGroup["k_value"].IsInt()) {
+            int kValue = redGroup["k_value"].GetInt();
+
+            if (kValue > 0 && kValue < 32768) {
+                redundancyGroup->K(kValue);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.k_value value out of range [1..32767]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), kValue, redundancyGroup->K());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.k_value is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->K());
+        }
+    }
+
+    if (redGroup.HasMember("w_value")) {
+        if (redGroup["w_value"].IsInt()) {
+            int wValue = redGroup["w_value"].GetInt();
+
+            if (wValue > 0 && wValue < 32768) {
+                redundancyGroup->W(wValue);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.w_value value out of range [1..32767]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), wValue, redundancyGroup->W());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.w_value is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->W());
+        }
+    }
+
+    if (redGroup.HasMember("t0_timeout")) {
+        if (redGroup["t0_timeout"].IsInt()) {
+            int t0Timeout = redGroup["t0_timeout"].GetInt();
+
+            if (t0Timeout > 0 && t0Timeout < 256) {
+                redundancyGroup->T0(t0Timeout);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.t0_timeout value out of range [1..255]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), t0Timeout, redundancyGroup->T0());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.t0_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->T0());
+        }
+    }
+
+    if (redGroup.HasMember("t1_timeout")) {
+        if (redGroup["t1_timeout"].IsInt()) {
+            int t1Timeout = redGroup["t1_timeout"].GetInt();
+
+            if (t1Timeout > 0 && t1Timeout < 256) {
+                redundancyGroup->T1(t1Timeout);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.t1_timeout value out of range [1..255]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), t1Timeout, redundancyGroup->T1());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.t1_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->T1());
+        }
+    }
+
+    if (redGroup.HasMember("t2_timeout")) {
+        if (redGroup["t2_timeout"].IsInt()) {
+            int t2Timeout = redGroup["t2_timeout"].GetInt();
+
+            if (t2Timeout > 0 && t2Timeout < 256) {
+                redundancyGroup->T2(t2Timeout);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.t2_timeout value out of range [1..255]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), t2Timeout, redundancyGroup->T2());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.t2_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->T2());
+        }
+    }
+
+    if (redGroup.HasMember("t3_timeout")) {
+        if (redGroup["t3_timeout"].IsInt()) {
+            int t3Timeout = redGroup["t3_timeout"].GetInt();
+
+            if (t3Timeout > -1) {
+                redundancyGroup->T3(t3Timeout);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.t3_timeout value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), t3Timeout, redundancyGroup->T3());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.t3_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->T3());
+        }
+    }
+
+    if (redGroup.HasMember("cmd_rate")) {
+        if (redGroup["cmd_rate"].IsInt()) {
+            int cmdRate = redGroup["cmd_rate"].GetInt();
+
+            if (cmdRate > -1) {
+                redundancyGroup->CmdRate(cmdRate);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.cmd_rate value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), cmdRate, redundancyGroup->CmdRate());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.cmd_rate is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->CmdRate());
+        }
+    }
+
+    if (redGroup.HasMember("cmd_burst")) {
+        if (redGroup["cmd_burst"].IsInt()) {
+            int cmdBurst = redGroup["cmd_burst"].GetInt();
+
+            if (cmdBurst > 0) {
+                redundancyGroup->CmdBurst(cmdBurst);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.cmd_burst value out of range [1..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), cmdBurst, redundancyGroup->CmdBurst());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.cmd_burst is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->CmdBurst());
+        }
+    }
+
+    if (redGroup.HasMember("connect_timeout")) {
+        if (redGroup["connect_timeout"].IsInt()) {
+            int connectTimeout = redGroup["connect_timeout"].GetInt();
+
+            if (connectTimeout > 0) {
+                redundancyGroup->ConnectTimeout(connectTimeout);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.connect_timeout value out of range [1..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), connectTimeout, redundancyGroup->ConnectTimeout());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.connect_timeout is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->ConnectTimeout());
+        }
+    }
+
+    if (redGroup.HasMember("reconnect_delay")) {
+        if (redGroup["reconnect_delay"].IsInt()) {
+            int reconnectDelay = redGroup["reconnect_delay"].GetInt();
+
+            if (reconnectDelay > -1) {
+                redundancyGroup->ReconnectDelay(reconnectDelay);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.reconnect_delay value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), reconnectDelay, redundancyGroup->ReconnectDelay());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.reconnect_delay is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->ReconnectDelay());
+        }
+    }
+
+    if (redGroup.HasMember("reconnect_max_delay")) {
+        if (redGroup["reconnect_max_delay"].IsInt()) {
+            int reconnectMaxDelay = redGroup["reconnect_max_delay"].GetInt();
+
+            if (reconnectMaxDelay >= redundancyGroup->ReconnectDelay()) {
+                redundancyGroup->ReconnectMaxDelay(reconnectMaxDelay);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.reconnect_max_delay value out of range [reconnect_delay..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), reconnectMaxDelay, redundancyGroup->ReconnectMaxDelay());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.reconnect_max_delay is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->ReconnectMaxDelay());
+        }
+    }
+
+    if (redGroup.HasMember("reconnect_jitter")) {
+        if (redGroup["reconnect_jitter"].IsInt()) {
+            int reconnectJitter = redGroup["reconnect_jitter"].GetInt();
+
+            if ((reconnectJitter > -1) && (reconnectJitter < 101)) {
+                redundancyGroup->ReconnectJitter(reconnectJitter);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.reconnect_jitter value out of range [0..100]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), reconnectJitter, redundancyGroup->ReconnectJitter());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.reconnect_jitter is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->ReconnectJitter());
+        }
+    }
+
+    if (redGroup.HasMember("backup_delay")) {
+        if (redGroup["backup_delay"].IsInt()) {
+            int backupDelay = redGroup["backup_delay"].GetInt();
+
+            if (backupDelay > -1) {
+                redundancyGroup->BackupDelay(backupDelay);
+            }
+            else {
+                Iec104Utility::log_warn("%s redGroup.backup_delay value out of range [0..+Inf]: %d -> using default value (%d)",
+                                        beforeLog.c_str(), backupDelay, redundancyGroup->BackupDelay());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.backup_delay is not an integer -> using default value (%d)", beforeLog.c_str(),
+                                    redundancyGroup->BackupDelay());
+        }
+    }
+
+    if (redGroup.HasMember("apci_auto_tune")) {
+        importApciAutoTune(redGroup["apci_auto_tune"], redundancyGroup);
+    }
+
+    if (redGroup.HasMember("tls")) {
+        if (redGroup["tls"].IsBool()) {
+            redundancyGroup->UseTLS(redGroup["tls"].GetBool());
+        }
+        else {
+            Iec104Utility::log_warn("%s redGroup.tls is not a bool -> not using TLS", beforeLog.c_str());
+        }
+    }
+
+    m_redundancyGroups.push_back(redundancyGroup);
+}
+
+void IEC104ClientConfig::importRedGroupCon(const Value& con, std::shared_ptr<IEC104ClientRedGroup> redundancyGroup) const
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importRedGroupCon -";
+
+    if(!con.IsObject()) {
+        Iec104Utility::log_error("%s  connections element is not an object -> ignore", beforeLog.c_str());
+        return;
+    }
+
+    if (!con.HasMember("srv_ip") || !con["srv_ip"].IsString()) {
+        Iec104Utility::log_error("%s  srv_ip does not exist or is not a string -> ignore", beforeLog.c_str());
+        return;
+    }
+    string srvIp = con["srv_ip"].GetString();
+
+    if (!isValidIPAddress(srvIp)) {
+        Iec104Utility::log_error("%s  srv_ip %s is not a valid IP address -> ignore", beforeLog.c_str(), srvIp.c_str());
+        return;
+    }
+
+    Iec104Utility::log_debug("%s  add to group: %s", beforeLog.c_str(), srvIp.c_str());
+
+    int tcpPort = 2404;
+    bool start = true;
+    bool conn = true;
+    
+    string clientIp;
+
+    if (con.HasMember("clt_ip")) {
+        if (con["clt_ip"].IsString()) {
+            string cltIpStr = con["clt_ip"].GetString();
+
+            if (isValidIPAddress(cltIpStr)) {
+                clientIp = cltIpStr;
+            }
+            else {
+                Iec104Utility::log_error("%s  clt_ip %s is not a valid IP address -> ignore client",
+                                        beforeLog.c_str(), cltIpStr.c_str());
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s  clt_ip is not a string -> ignore client",
+                                    beforeLog.c_str());
+        }
+    }
+    
+    if (con.HasMember("port")) {
+        if (con["port"].IsInt()) {
+            int tcpPortVal = con["port"].GetInt();
+
+            if (tcpPortVal > 0 && tcpPortVal < 65636) {
+                tcpPort = tcpPortVal;
+            }
+            else {
+                Iec104Utility::log_error("%s  port value out of range [1..65635]: %d -> using default port (%d)",
+                                        beforeLog.c_str(), tcpPortVal, tcpPort);
+            }
+        }
+        else {
+            Iec104Utility::log_warn("%s  port is not an integer -> using default port (%d)",
+                                    beforeLog.c_str(), tcpPort);
+        }
+    }
+
+    if (con.HasMember("conn")) {
+        if (con["conn"].IsBool()) {
+            conn = con["conn"].GetBool();
+        }
+        else {
+            Iec104Utility::log_warn("%s  conn is not a bool -> using default conn (%s)",
+                                    beforeLog.c_str(), conn?"true":"false");
+        }
+    }
+
+    if (con.HasMember("start")) {
+        if (con["start"].IsBool()) {
+            start = con["start"].GetBool();
+        }
+        else {
+            Iec104Utility::log_warn("%s  start is not a bool -> using default start (%s)",
+                                    beforeLog.c_str(), start?"true":"false");
+        }
+    }
+
+    auto connection = std::make_shared<RedGroupCon>(srvIp, tcpPort, conn, start, clientIp);
+
+    redundancyGroup->AddConnection(connection);
+}
+
+void
+IEC104ClientConfig::importTlsConfig(const string& tlsConfig)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importTlsConfig -";
+    Document document;
+    m_tlsConfigComplete = false;
+
+    if (document.Parse(const_cast<char*>(tlsConfig.c_str())).HasParseError()) {
+        Iec104Utility::log_fatal("%s Parsing error in tls_conf json, offset %u: %s", beforeLog.c_str(),
+                                static_cast<unsigned>(document.GetErrorOffset()), GetParseError_En(document.GetParseError()));
+        return;
+    }
+       
+    if (!document.IsObject()) {
+        Iec104Utility::log_fatal("%s Root is not an object", beforeLog.c_str());
+        return;
+    }
+    
+    if (!document.HasMember("tls_conf") || !document["tls_conf"].IsObject()) {
+        Iec104Utility::log_debug("%s tls_conf does not exist or is not an object", beforeLog.c_str());
+        return;
+    }
+
+    const Value& tlsConf = document["tls_conf"];
+
+    if (tlsConf.HasMember("private_key") && tlsConf["private_key"].IsString()) {
+        m_privateKey = tlsConf["private_key"].GetString();
+    }
+    else {
+        Iec104Utility::log_warn("%s private_key does not exist or is not a string", beforeLog.c_str());
+    }
+
+    if (tlsConf.HasMember("own_cert") && tlsConf["own_cert"].IsString()) {
+        m_ownCertificate = tlsConf["own_cert"].GetString();
+    }
+    else {
+        Iec104Utility::log_warn("%s own_cert does not exist or is not a string", beforeLog.c_str());
+    }
+
+    if (tlsConf.HasMember("ca_certs") && tlsConf["ca_certs"].IsArray()) {
+
+        const Value& caCerts = tlsConf["ca_certs"];
+
+        for (const Value& caCert : caCerts.GetArray()) {
+            if (!caCert.IsObject()) {
+                Iec104Utility::log_warn("%s ca_certs element is not an object", beforeLog.c_str());
+                continue;
+            }
+
+            if (caCert.HasMember("cert_file") && caCert["cert_file"].IsString()) {
+                string certFileName = caCert["cert_file"].GetString();
+                m_caCertificates.push_back(certFileName);
+            }
+            else {
+                Iec104Utility::log_warn("%s ca_certs.cert_file does not exist or is not a string", beforeLog.c_str());
+            }
+        }
+    }
+    else {
+        Iec104Utility::log_warn("%s ca_certs does not exist or is not an array", beforeLog.c_str());
+    }
+
+    if (tlsConf.HasMember("remote_certs") && tlsConf["remote_certs"].IsArray()) {
+
+        const Value& remoteCerts = tlsConf["remote_certs"];
+
+        for (const Value& remoteCert : remoteCerts.GetArray()) {
+            if (!remoteCert.IsObject()) {
+                Iec104Utility::log_warn("%s remote_certs element is not an object", beforeLog.c_str());
+                continue;
+            }
+
+            if (remoteCert.HasMember("cert_file") && remoteCert["cert_file"].IsString()) {
+                string certFileName = remoteCert["cert_file"].GetString();
+                m_remoteCertificates.push_back(certFileName);
+            }
+            else {
+                Iec104Utility::log_warn("%s remote_certs.cert_file does not exist or is not a string", beforeLog.c_str());
+            }
+        }
+    }
+    else {
+        Iec104Utility::log_warn("%s remote_certs does not exist or is not an array", beforeLog.c_str());
+    }
+
+    m_tlsConfigComplete = true;
+}
+
+void IEC104ClientConfig::importExchangeConfig(const string& exchangeConfig)
+{
+    auto exchangeTable = std::make_shared<IEC104ExchangeTable>();
+
+    m_exchangeConfigComplete = buildExchangeTable(exchangeConfig, *exchangeTable);
+
+    std::atomic_store(&m_exchangeTable, std::shared_ptr<const IEC104ExchangeTable>(exchangeTable));
+
+    m_addressReport.clear();
+}
+
+bool
+IEC104ClientConfig::isSameCaDefinitions(const IEC104ExchangeTable& oldTable, const IEC104ExchangeTable& newTable, int ca)
+{
+    uint32_t oldFirst, oldLast, newFirst, newLast;
+
+    if (!oldTable.caRange(ca, oldFirst, oldLast) || !newTable.caRange(ca, newFirst, newLast))
+        return false;
+
+    if ((oldLast - oldFirst) != (newLast - newFirst))
+        return false;
+
+    for (uint32_t i = 0; i < (newLast - newFirst); i++) {
+        uint32_t a = oldFirst + i;
+        uint32_t b = newFirst + i;
+
+        if ((oldTable.ioas[a] != newTable.ioas[b]) || (oldTable.typeIds[a] != newTable.typeIds[b]) ||
+            (oldTable.giGroups[a] != newTable.giGroups[b]) || (oldTable.flags[a] != newTable.flags[b]) ||
+            (oldTable.label(a) != newTable.label(b)))
+            return false;
+    }
+
+    return true;
+}
+
+bool IEC104ClientConfig::reloadExchangeConfig(const string& exchangeConfig, std::vector<int>& changedCAs)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::reloadExchangeConfig -";
+
+    auto newTable = std::make_shared<IEC104ExchangeTable>();
+
+    if (buildExchangeTable(exchangeConfig, *newTable) == false) {
+        Iec104Utility::log_error("%s Invalid exchanged_data -> keeping the current one", beforeLog.c_str());
+        return false;
+    }
+
+    auto oldTable = ExchangeTable();
+
+    changedCAs.clear();
+
+    for (int ca : newTable->listOfCAs) {
+        if (!isSameCaDefinitions(*oldTable, *newTable, ca)) {
+            changedCAs.push_back(ca);
+        }
+    }
+
+    std::atomic_store(&m_exchangeTable, std::shared_ptr<const IEC104ExchangeTable>(newTable));
+
+    m_exchangeConfigComplete = true;
+
+    m_addressReport.clear();
+
+    Iec104Utility::log_info("%s New exchanged_data applied (%lu CA(s) changed)", beforeLog.c_str(), changedCAs.size());
+
+    return true;
+}
+
+/*
+ * SAX handler for the exchanged_data configuration. Data points are added to the exchange
+ * table while the JSON is read, no DOM of the (possibly very large) configuration is built.
+ * Only the members used by the plugin are decoded, all other values are skipped.
+ */
+class ExchangeConfigHandler : public BaseReaderHandler<UTF8<>, ExchangeConfigHandler>
+{
+public:
+
+    explicit ExchangeConfigHandler(IEC104ExchangeTable& exchangeTable):
+        m_exchangeTable(exchangeTable),
+        m_beforeLog(Iec104Utility::PluginName + " - IEC104ClientConfig::parseExchangeConfig -")
+    {}
+
+    /* null, boolean and number values */
+    bool Default() {
+        return scalar(nullptr, 0);
+    }
+
+    bool String(const char* str, SizeType length, bool /*copy*/) {
+        return scalar(str, length);
+    }
+
+    bool Uint(unsigned value) {
+        if ((m_skipDepth == 0) && (m_state == State::PROTOCOL) && (m_field == Field::PROT_STALE_AFTER)) {
+            m_field = Field::OTHER;
+            m_staleAfter = value;
+            return true;
+        }
+
+        if ((m_skipDepth == 0) && (m_state == State::PROTOCOL) && (m_field == Field::PROT_MAX_AGE)) {
+            m_field = Field::OTHER;
+            m_maxAge = value;
+            return true;
+        }
+
+        return Default();
+    }
+
+    bool Key(const char* str, SizeType length, bool copy);
+
+    bool StartObject();
+    bool EndObject(SizeType memberCount);
+    bool StartArray();
+    bool EndArray(SizeType elementCount);
+
+    /* check the mandatory members once the whole document has been read */
+    bool isComplete() const;
+
+    int DatapointCount() const {return m_datapointCount;};
+
+private:
+
+    enum class State
+    {
+        ROOT,
+        DOCUMENT,
+        EXCHANGED_DATA,
+        DATAPOINTS,
+        DATAPOINT,
+        PIVOT_SUBTYPES,
+        PROTOCOLS,
+        PROTOCOL,
+        DONE
+    };
+
+    enum class Field
+    {
+        OTHER,
+        EXCHANGED_DATA,
+        DATAPOINTS,
+        LABEL,
+        PIVOT_SUBTYPES,
+        PROTOCOLS,
+        PROT_NAME,
+        PROT_ADDR,
+        PROT_TYPEID,
+        PROT_GI_GROUPS,
+        PROT_STALE_AFTER,
+        PROT_MAX_AGE
+    };
+
+    struct Address {
+        int ca;
+        int ioa;
+        int typeId;
+        uint32_t giGroups;
+        uint32_t staleAfter;
+        uint32_t maxAge;
+    };
+
+    static bool isEqual(const char* str, SizeType length, const char* value) {
+        return (strlen(value) == length) && (memcmp(str, value, length) == 0);
+    }
+
+    /* "station", "groupN" or "N" -> 0 (station) or N (1..16), -1 when unknown */
+    static int giGroupNumber(const char* str, SizeType length) {
+        if (isEqual(str, length, "station"))
+            return IEC104ExchangeTable::GI_GROUP_STATION;
+
+        if ((length > 5) && (memcmp(str, "group", 5) == 0)) {
+            str += 5;
+            length -= 5;
+        }
+
+        if ((length == 0) || (length > 2))
+            return -1;
+
+        int group = 0;
+
+        for (SizeType i = 0; i < length; i++) {
+            if ((str[i] < '0') || (str[i] > '9'))
+                return -1;
+
+            group = (group * 10) + (str[i] - '0');
+        }
+
+        return ((group >= 1) && (group <= IEC104ExchangeTable::GI_GROUP_MAX)) ? group : -1;
+    }
+
+    bool scalar(const char* str, SizeType length);
+    bool startContainer(bool isObject);
+    bool endProtocol();
+    bool endDatapoint();
+
+    IEC104ExchangeTable& m_exchangeTable;
+    std::string m_beforeLog;
+
+    State m_state = State::ROOT;
+    Field m_field = Field::OTHER;
+    int m_skipDepth = 0; /* > 0 while skipping the content of an unused object or array */
+
+    bool m_exchangedDataFound = false;
+    bool m_datapointsFound = false;
+    int m_datapointCount = 0;
+
+    /* current data point */
+    std::string m_label;
+    bool m_labelFound = false;
+    bool m_protocolsFound = false;
+    bool m_isGiTriggeringTs = false;
+    std::vector<Address> m_addresses;
+
+    /* current protocol */
+    bool m_nameFound = false;
+    bool m_isIec104 = false;
+    std::string m_address;
+    bool m_addressFound = false;
+    std::string m_typeId;
+    bool m_typeIdFound = false;
+    uint32_t m_giGroups = 0;
+    bool m_giGroupsNotString = false;
+    uint32_t m_staleAfter = 0;
+    bool m_staleAfterInvalid = false;
+    uint32_t m_maxAge = 0;
+    bool m_maxAgeInvalid = false;
+};
+
+bool
+ExchangeConfigHandler::Key(const char* str, SizeType length, bool /*copy*/)
+{
+    if (m_skipDepth > 0)
+        return true;
+
+    m_field = Field::OTHER;
+
+    switch (m_state) {
+        case State::DOCUMENT:
+            if (isEqual(str, length, JSON_EXCHANGED_DATA)) m_field = Field::EXCHANGED_DATA;
+            break;
+
+        case State::EXCHANGED_DATA:
+            if (isEqual(str, length, JSON_DATAPOINTS)) m_field = Field::DATAPOINTS;
+            break;
+
+        case State::DATAPOINT:
+            if (isEqual(str, length, JSON_LABEL)) m_field = Field::LABEL;
+            else if (isEqual(str, length, JSON_PIVOT_SUBTYPES)) m_field = Field::PIVOT_SUBTYPES;
+            else if (isEqual(str, length, JSON_PROTOCOLS)) m_field = Field::PROTOCOLS;
+            break;
+
+        case State::PROTOCOL:
+            if (isEqual(str, length, JSON_PROT_NAME)) m_field = Field::PROT_NAME;
+            else if (isEqual(str, length, JSON_PROT_ADDR)) m_field = Field::PROT_ADDR;
+            else if (isEqual(str, length, JSON_PROT_TYPEID)) m_field = Field::PROT_TYPEID;
+            else if (isEqual(str, length, JSON_PROT_GI_GROUPS)) m_field = Field::PROT_GI_GROUPS;
+            else if (isEqual(str, length, JSON_PROT_STALE_AFTER)) m_field = Field::PROT_STALE_AFTER;
+            else if (isEqual(str, length, JSON_PROT_MAX_AGE)) m_field = Field::PROT_MAX_AGE;
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool
+ExchangeConfigHandler::scalar(const char* str, SizeType length)
+{
+    if (m_skipDepth > 0)
+        return true;
+
+    Field field = m_field;
+    m_field = Field::OTHER;
+
+    switch (m_state) {
+        case State::ROOT:
+            Iec104Utility::log_fatal("%s Root is not an object", m_beforeLog.c_str());
+            return false;
+
+        case State::DATAPOINTS:
+            Iec104Utility::log_error("%s %s element is not an object", m_beforeLog.c_str(), JSON_DATAPOINTS);
+            return false;
+
+        case State::PROTOCOLS:
+            Iec104Utility::log_error("%s %s element is not an object", m_beforeLog.c_str(), JSON_PROTOCOLS);
+            return false;
+
+        case State::PIVOT_SUBTYPES:
+            if (str && isEqual(str, length, JSON_TRIGGER_SOUTH_GI_PIVOT_SUBTYPE)) {
+                m_isGiTriggeringTs = true;
+            }
+            break;
+
+        case State::DATAPOINT:
+            if (str && (field == Field::LABEL)) {
+                m_label.assign(str, length);
+                m_labelFound = true;
+            }
+            break;
+
+        case State::PROTOCOL:
+            if (field == Field::PROT_GI_GROUPS) {
+                if (str == nullptr) {
+                    m_giGroupsNotString = true;
+                    break;
+                }
+
+                /* space separated list of groups: "station" and groups 1..16 */
+                const char* token = str;
+                const char* end = str + length;
+
+                while (true) {
+                    const char* tokenEnd = std::find(token, end, ' ');
+                    SizeType tokenLength = static_cast<SizeType>(tokenEnd - token);
+
+                    if (tokenLength > 0) {
+                        int group = giGroupNumber(token, tokenLength);
+
+                        if (group >= 0) {
+                            m_giGroups |= (1u << group);
+                        }
+                        else {
+                            Iec104Utility::log_warn("%s %s: unknown group \"%s\" -> ignore", m_beforeLog.c_str(), JSON_PROT_GI_GROUPS,
+                                                    std::string(token, tokenLength).c_str());
+                        }
+                    }
+
+                    if (tokenEnd == end)
+                        break;
+
+                    token = tokenEnd + 1;
+                }
+            }
+            else if (field == Field::PROT_STALE_AFTER) {
+                /* positive integers are handled by Uint() */
+                m_staleAfterInvalid = true;
+            }
+            else if (field == Field::PROT_MAX_AGE) {
+                m_maxAgeInvalid = true;
+            }
+            else if (str == nullptr) {
+                break;
+            }
+            else if (field == Field::PROT_NAME) {
+                m_nameFound = true;
+                m_isIec104 = isEqual(str, length, PROTOCOL_IEC104);
+            }
+            else if (field == Field::PROT_ADDR) {
+                m_address.assign(str, length);
+                m_addressFound = true;
+            }
+            else if (field == Field::PROT_TYPEID) {
+                m_typeId.assign(str, length);
+                m_typeIdFound = true;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool
+ExchangeConfigHandler::startContainer(bool isObject)
+{
+    if (m_skipDepth > 0) {
+        m_skipDepth++;
+        return true;
+    }
+
+    Field field = m_field;
+    m_field = Field::OTHER;
+
+    switch (m_state) {
+        case State::ROOT:
+            if (isObject) {
+                m_state = State::DOCUMENT;
+                return true;
+            }
+
+            Iec104Utility::log_fatal("%s Root is not an object", m_beforeLog.c_str());
+            return false;
+
+        case State::DOCUMENT:
+            if (isObject && (field == Field::EXCHANGED_DATA)) {
+                m_exchangedDataFound = true;
+                m_state = State::EXCHANGED_DATA;
+                return true;
+            }
+            break;
+
+        case State::EXCHANGED_DATA:
+            if (!isObject && (field == Field::DATAPOINTS)) {
+                m_datapointsFound = true;
+                m_state = State::DATAPOINTS;
+                return true;
+            }
+            break;
+
+        case State::DATAPOINTS:
+            if (isObject) {
+                m_label.clear();
+                m_labelFound = false;
+                m_protocolsFound = false;
+                m_isGiTriggeringTs = false;
+                m_addresses.clear();
+
+                m_state = State::DATAPOINT;
+                return true;
+            }
+
+            Iec104Utility::log_error("%s %s element is not an object", m_beforeLog.c_str(), JSON_DATAPOINTS);
+            return false;
+
+        case State::DATAPOINT:
+            if (!isObject && (field == Field::PIVOT_SUBTYPES)) {
+                m_state = State::PIVOT_SUBTYPES;
+                return true;
+            }
 
-            if (tcpPortVal > 0 && tcpPortVal < 65636) {
-                tcpPort = tcpPortVal;
+            if (!isObject && (field == Field::PROTOCOLS)) {
+                m_protocolsFound = true;
+                m_state = State::PROTOCOLS;
+                return true;
             }
-            else {
-                Iec104Utility::log_error("%s  port value out of range [1..65635]: %d -> using default port (%d)",
-                                        beforeLog.c_str(), tcpPortVal, tcpPort);
+            break;
+
+        case State::PROTOCOLS:
+            if (isObject) {
+                m_nameFound = false;
+                m_isIec104 = false;
+                m_addressFound = false;
+                m_typeIdFound = false;
+                m_giGroups = 0;
+                m_giGroupsNotString = false;
+                m_staleAfter = 0;
+                m_staleAfterInvalid = false;
+                m_maxAge = 0;
+                m_maxAgeInvalid = false;
+
+                m_state = State::PROTOCOL;
+                return true;
             }
-        }
-        else {
-            Iec104Utility::log_warn("%s  port is not an integer -> using default port (%d)",
-                                    beforeLog.c_str(), tcpPort);
-        }
-    }
 
-    if (con.HasMember("conn")) {
-        if (con["conn"].IsBool()) {
-            conn = con["conn"].GetBool();
-        }
-        else {
-            Iec104Utility::log_warn("%s  conn is not a bool -> using default conn (%s)",
-                                    beforeLog.c_str(), conn?"true":"false");
-        }
-    }
+            Iec104Utility::log_error("%s %s element is not an object", m_beforeLog.c_str(), JSON_PROTOCOLS);
+            return false;
 
-    if (con.HasMember("start")) {
-        if (con["start"].IsBool()) {
-            start = con["start"].GetBool();
-        }
-        else {
-            Iec104Utility::log_warn("%s  start is not a bool -> using default start (%s)",
-                                    beforeLog.c_str(), start?"true":"false");
-        }
+        case State::PROTOCOL:
+            if (field == Field::PROT_GI_GROUPS) {
+                m_giGroupsNotString = true;
+            }
+            else if (field == Field::PROT_STALE_AFTER) {
+                m_staleAfterInvalid = true;
+            }
+            else if (field == Field::PROT_MAX_AGE) {
+                m_maxAgeInvalid = true;
+            }
+            break;
+
+        default:
+            break;
     }
 
-    auto connection = std::make_shared<RedGroupCon>(srvIp, tcpPort, conn, start, clientIp);
+    /* value not used by the plugin */
+    m_skipDepth = 1;
 
-    redundancyGroup->AddConnection(connection);
+    return true;
 }
 
-void IEC104ClientConfig::deleteExchangeDefinitions()
+bool
+ExchangeConfigHandler::StartObject()
 {
-    m_exchangeDefinitions.clear();
+    return startContainer(true);
 }
 
-void
-IEC104ClientConfig::importTlsConfig(const string& tlsConfig)
+bool
+ExchangeConfigHandler::StartArray()
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importTlsConfig -";
-    Document document;
-    m_tlsConfigComplete = false;
+    return startContainer(false);
+}
 
-    if (document.Parse(const_cast<char*>(tlsConfig.c_str())).HasParseError()) {
-        Iec104Utility::log_fatal("%s Parsing error in tls_conf json, offset %u: %s", beforeLog.c_str(),
-                                static_cast<unsigned>(document.GetErrorOffset()), GetParseError_En(document.GetParseError()));
-        return;
+bool
+ExchangeConfigHandler::EndObject(SizeType /*memberCount*/)
+{
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
     }
-       
-    if (!document.IsObject()) {
-        Iec104Utility::log_fatal("%s Root is not an object", beforeLog.c_str());
-        return;
+
+    switch (m_state) {
+        case State::DOCUMENT:
+            m_state = State::DONE;
+            break;
+
+        case State::EXCHANGED_DATA:
+            m_state = State::DOCUMENT;
+            break;
+
+        case State::DATAPOINT:
+            m_state = State::DATAPOINTS;
+            return endDatapoint();
+
+        case State::PROTOCOL:
+            m_state = State::PROTOCOLS;
+            return endProtocol();
+
+        default:
+            break;
     }
-    
-    if (!document.HasMember("tls_conf") || !document["tls_conf"].IsObject()) {
-        Iec104Utility::log_debug("%s tls_conf does not exist or is not an object", beforeLog.c_str());
-        return;
+
+    return true;
+}
+
+bool
+ExchangeConfigHandler::EndArray(SizeType /*elementCount*/)
+{
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
     }
 
-    const Value& tlsConf = document["tls_conf"];
+    switch (m_state) {
+        case State::DATAPOINTS:
+            m_state = State::EXCHANGED_DATA;
+            break;
 
-    if (tlsConf.HasMember("private_key") && tlsConf["private_key"].IsString()) {
-        m_privateKey = tlsConf["private_key"].GetString();
+        case State::PIVOT_SUBTYPES:
+        case State::PROTOCOLS:
+            m_state = State::DATAPOINT;
+            break;
+
+        default:
+            break;
     }
-    else {
-        Iec104Utility::log_warn("%s private_key does not exist or is not a string", beforeLog.c_str());
+
+    return true;
+}
+
+static bool
+toInt(const char* str, const char* limit, int& value)
+{
+    char* end = nullptr;
+
+    errno = 0;
+
+    long result = strtol(str, &end, 10);
+
+    if ((end == str) || (end > limit) || (errno == ERANGE) || (result < INT_MIN) || (result > INT_MAX))
+        return false;
+
+    value = static_cast<int>(result);
+
+    return true;
+}
+
+bool
+ExchangeConfigHandler::endProtocol()
+{
+    if (!m_nameFound) {
+        Iec104Utility::log_error("%s %s does not exist or is not a string", m_beforeLog.c_str(), JSON_PROT_NAME);
+        return false;
     }
 
-    if (tlsConf.HasMember("own_cert") && tlsConf["own_cert"].IsString()) {
-        m_ownCertificate = tlsConf["own_cert"].GetString();
+    if (!m_isIec104)
+        return true;
+
+    if (!m_addressFound) {
+        Iec104Utility::log_error("%s %s does not exist or is not a string", m_beforeLog.c_str(), JSON_PROT_ADDR);
+        return false;
     }
-    else {
-        Iec104Utility::log_warn("%s own_cert does not exist or is not a string", beforeLog.c_str());
+
+    if (!m_typeIdFound) {
+        Iec104Utility::log_error("%s %s does not exist or is not a string", m_beforeLog.c_str(), JSON_PROT_TYPEID);
+        return false;
     }
 
-    if (tlsConf.HasMember("ca_certs") && tlsConf["ca_certs"].IsArray()) {
+    if (m_giGroupsNotString) {
+        Iec104Utility::log_warn("%s %s value is not a string", m_beforeLog.c_str(), JSON_PROT_GI_GROUPS);
+    }
 
-        const Value& caCerts = tlsConf["ca_certs"];
+    if (m_staleAfterInvalid) {
+        Iec104Utility::log_warn("%s %s value is not a positive integer -> ignore", m_beforeLog.c_str(), JSON_PROT_STALE_AFTER);
+    }
 
-        for (const Value& caCert : caCerts.GetArray()) {
-            if (!caCert.IsObject()) {
-                Iec104Utility::log_warn("%s ca_certs element is not an object", beforeLog.c_str());
-                continue;
-            }
+    if (m_maxAgeInvalid) {
+        Iec104Utility::log_warn("%s %s value is not a positive integer -> ignore", m_beforeLog.c_str(), JSON_PROT_MAX_AGE);
+    }
 
-            if (caCert.HasMember("cert_file") && caCert["cert_file"].IsString()) {
-                string certFileName = caCert["cert_file"].GetString();
-                m_caCertificates.push_back(certFileName);
-            }
-            else {
-                Iec104Utility::log_warn("%s ca_certs.cert_file does not exist or is not a string", beforeLog.c_str());
-            }
-        }
+    size_t sepPos = m_address.find('-');
+
+    if (sepPos == std::string::npos) {
+        Iec104Utility::log_error("%s  %s value does not follow format 'XXX-YYY': %s", m_beforeLog.c_str(), JSON_PROT_ADDR,
+                                m_address.c_str());
+        return false;
     }
-    else {
-        Iec104Utility::log_warn("%s ca_certs does not exist or is not an array", beforeLog.c_str());
+
+    const char* address = m_address.c_str();
+
+    Address entry;
+
+    if (!toInt(address, address + sepPos, entry.ca) || !toInt(address + sepPos + 1, address + m_address.size(), entry.ioa)) {
+        Iec104Utility::log_error("%s  Cannot convert ca '%s' or ioa '%s' to integer", m_beforeLog.c_str(),
+                                m_address.substr(0, sepPos).c_str(), m_address.substr(sepPos + 1).c_str());
+        return false;
     }
 
-    if (tlsConf.HasMember("remote_certs") && tlsConf["remote_certs"].IsArray()) {
+    entry.typeId = IEC104ClientConfig::getTypeIdFromString(m_typeId);
+    entry.giGroups = m_giGroups;
+    entry.staleAfter = m_staleAfter;
+    entry.maxAge = m_maxAge;
 
-        const Value& remoteCerts = tlsConf["remote_certs"];
+    m_addresses.push_back(entry);
 
-        for (const Value& remoteCert : remoteCerts.GetArray()) {
-            if (!remoteCert.IsObject()) {
-                Iec104Utility::log_warn("%s remote_certs element is not an object", beforeLog.c_str());
-                continue;
-            }
+    return true;
+}
 
-            if (remoteCert.HasMember("cert_file") && remoteCert["cert_file"].IsString()) {
-                string certFileName = remoteCert["cert_file"].GetString();
-                m_remoteCertificates.push_back(certFileName);
-            }
-            else {
-                Iec104Utility::log_warn("%s remote_certs.cert_file does not exist or is not a string", beforeLog.c_str());
-            }
-        }
+bool
+ExchangeConfigHandler::endDatapoint()
+{
+    if (!m_labelFound) {
+        Iec104Utility::log_error("%s %s does not exist or is not a string", m_beforeLog.c_str(), JSON_LABEL);
+        return false;
     }
-    else {
-        Iec104Utility::log_warn("%s remote_certs does not exist or is not an array", beforeLog.c_str());
+
+    if (!m_protocolsFound) {
+        Iec104Utility::log_error("%s %s does not exist or is not an array", m_beforeLog.c_str(), JSON_PROTOCOLS);
+        return false;
     }
 
-    m_tlsConfigComplete = true;
+    uint32_t labelId = m_exchangeTable.labels.intern(m_label);
+
+    for (const Address& address : m_addresses) {
+        m_exchangeTable.addPoint(address.ca, address.ioa, address.typeId, address.giGroups,
+                                 m_isGiTriggeringTs ? IEC104ExchangeTable::FLAG_CG_TRIGGERING : 0, labelId, address.staleAfter,
+                                 address.maxAge);
+    }
+
+    m_datapointCount++;
+
+    return true;
 }
 
-static vector<string> tokenizeString(string& str, string delimiter)
+bool
+ExchangeConfigHandler::isComplete() const
 {
-    vector<string> tokens;
+    if (!m_exchangedDataFound) {
+        Iec104Utility::log_fatal("%s %s does not exist or is not an object", m_beforeLog.c_str(), JSON_EXCHANGED_DATA);
+        return false;
+    }
+
+    if (!m_datapointsFound) {
+        Iec104Utility::log_fatal("%s %s does not exist or is not an array", m_beforeLog.c_str(), JSON_DATAPOINTS);
+        return false;
+    }
 
-    size_t pos = 0;
-    std::string token;
+    return true;
+}
+
+const uint32_t IEC104ExchangeTable::NO_POINT;
+const uint8_t IEC104ExchangeTable::FLAG_CG_TRIGGERING;
+const int IEC104ExchangeTable::GI_GROUP_STATION;
+const int IEC104ExchangeTable::GI_GROUP_MAX;
 
-    str = str + delimiter;
+void
+IEC104ExchangeTable::addPoint(int ca, int ioa, int typeId, uint32_t pointGiGroups, uint8_t pointFlags, uint32_t labelId,
+                              uint32_t pointStaleAfter, uint32_t pointMaxAge)
+{
+    cas.push_back(ca);
+    ioas.push_back(ioa);
+    typeIds.push_back(static_cast<uint8_t>(typeId));
+    flags.push_back(pointFlags);
+    giGroups.push_back(pointGiGroups);
+    labelIds.push_back(labelId);
+    staleAfter.push_back(pointStaleAfter);
+    maxAge.push_back(pointMaxAge);
+}
 
-    while ((pos = str.find(delimiter)) != std::string::npos) {
-        token = str.substr(0, pos);
+template <typename T>
+static void
+reorder(std::vector<T>& values, const std::vector<uint32_t>& order)
+{
+    std::vector<T> ordered;
 
-        tokens.push_back(token);
+    ordered.reserve(order.size());
 
-        str.erase(0, pos + delimiter.length());
+    for (uint32_t i : order) {
+        ordered.push_back(values[i]);
     }
 
-    return tokens;
+    values.swap(ordered);
 }
 
-std::shared_ptr<DataExchangeDefinition>
-IEC104ClientConfig::getExchangeDefinitionByLabel(std::string& label)
+void
+IEC104ExchangeTable::buildIndexes()
 {
-    for (auto const& exchangeDefintions : ExchangeDefinition()) {
-        for (auto const& dpPair : exchangeDefintions.second) {
-            std::shared_ptr<DataExchangeDefinition> dp = dpPair.second;
+    auto isBefore = [this](uint32_t a, uint32_t b) {
+        return (cas[a] < cas[b]) || ((cas[a] == cas[b]) && (ioas[a] < ioas[b]));
+    };
 
-            if (dp) {
-                if (dp->label == label) {
-                    return dp;
-                }
-            }
-        }
+    uint32_t count = Size();
+    bool ordered = true;
+
+    /* the cache is already ordered, the JSON usually is */
+    for (uint32_t i = 1; (i < count) && ordered; i++) {
+        ordered = isBefore(i - 1, i);
     }
 
-    return nullptr;
-}
+    if (!ordered) {
+        std::vector<uint32_t> order(count);
 
-void IEC104ClientConfig::importExchangeConfig(const string& exchangeConfig)
-{
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::importExchangeConfig -";
-    m_exchangeConfigComplete = false;
+        for (uint32_t i = 0; i < count; i++) {
+            order[i] = i;
+        }
 
-    deleteExchangeDefinitions();
+        /* stable: the definitions of an address stay in configuration order */
+        std::stable_sort(order.begin(), order.end(), isBefore);
 
-    Document document;
+        std::vector<uint32_t> kept;
 
-    if (document.Parse(const_cast<char*>(exchangeConfig.c_str())).HasParseError()) {
-        Iec104Utility::log_fatal("%s Parsing error in exchanged_data json, offset %u: %s", beforeLog.c_str(),
-                                static_cast<unsigned>(document.GetErrorOffset()), GetParseError_En(document.GetParseError()));
-        return;
-    }
+        kept.reserve(count);
 
-    if (!document.IsObject()) {
-        Iec104Utility::log_fatal("%s Root is not an object", beforeLog.c_str());
-        return;
-    }
+        for (uint32_t i = 0; i < count; i++) {
+            if ((i + 1 < count) && !isBefore(order[i], order[i + 1])) {
+                /* the last definition of the address is kept, a CG triggering TS stays triggering */
+                flags[order[i + 1]] |= flags[order[i]];
+                continue;
+            }
 
-    if (!document.HasMember(JSON_EXCHANGED_DATA) || !document[JSON_EXCHANGED_DATA].IsObject()) {
-        Iec104Utility::log_fatal("%s %s does not exist or is not an object", beforeLog.c_str(), JSON_EXCHANGED_DATA);
-        return;
-    }
+            kept.push_back(order[i]);
+        }
 
-    const Value& exchangeData = document[JSON_EXCHANGED_DATA];
+        reorder(cas, kept);
+        reorder(ioas, kept);
+        reorder(typeIds, kept);
+        reorder(flags, kept);
+        reorder(giGroups, kept);
+        reorder(labelIds, kept);
+        reorder(staleAfter, kept);
+        reorder(maxAge, kept);
 
-    if (!exchangeData.HasMember(JSON_DATAPOINTS) || !exchangeData[JSON_DATAPOINTS].IsArray()) {
-        Iec104Utility::log_fatal("%s %s does not exist or is not an array", beforeLog.c_str(), JSON_DATAPOINTS);
-        return;
+        count = Size();
     }
 
-    const Value& datapoints = exchangeData[JSON_DATAPOINTS];
+    listOfCAs.clear();
+    caFirstPoints.clear();
+    caGiGroups.clear();
+    knownCas.reset();
 
-    for (const Value& datapoint : datapoints.GetArray()) {
+    labelPoints.assign(labels.Size(), NO_POINT);
 
-        if (!datapoint.IsObject()) {
-            Iec104Utility::log_error("%s %s element is not an object", beforeLog.c_str(), JSON_DATAPOINTS);
-            return;
-        } 
+    for (uint32_t pointId = 0; pointId < count; pointId++) {
+        int ca = cas[pointId];
 
-        if (!datapoint.HasMember(JSON_LABEL) || !datapoint[JSON_LABEL].IsString()) {
-            Iec104Utility::log_error("%s %s does not exist or is not a string", beforeLog.c_str(), JSON_LABEL);
-            return;
+        if (listOfCAs.empty() || (listOfCAs.back() != ca)) {
+            listOfCAs.push_back(ca);
+            caFirstPoints.push_back(pointId);
+            caGiGroups.push_back(0);
+
+            if ((ca >= 0) && (ca < 65536)) {
+                knownCas.set(ca);
+            }
         }
 
-        string label = datapoint[JSON_LABEL].GetString();
+        caGiGroups.back() |= giGroups[pointId];
 
+        uint32_t labelId = labelIds[pointId];
 
-        bool isGiTriggeringTs = false;
-        if (datapoint.HasMember(JSON_PIVOT_SUBTYPES) && datapoint[JSON_PIVOT_SUBTYPES].IsArray()) {
-            for (const Value &subtype : datapoint[JSON_PIVOT_SUBTYPES].GetArray()) {
-                if (subtype.IsString() && subtype.GetString() == string(JSON_TRIGGER_SOUTH_GI_PIVOT_SUBTYPE)) {
-                    isGiTriggeringTs = true;
-                    break;
-                }
-            }
+        if ((labelId < labelPoints.size()) && (labelPoints[labelId] == NO_POINT)) {
+            labelPoints[labelId] = pointId;
         }
+    }
 
-        if (!datapoint.HasMember(JSON_PROTOCOLS) || !datapoint[JSON_PROTOCOLS].IsArray()) {
-            Iec104Utility::log_error("%s %s does not exist or is not an array", beforeLog.c_str(), JSON_PROTOCOLS);
-            return;
+    caFirstPoints.push_back(count);
+
+    cas.shrink_to_fit();
+    ioas.shrink_to_fit();
+    typeIds.shrink_to_fit();
+    flags.shrink_to_fit();
+    giGroups.shrink_to_fit();
+    labelIds.shrink_to_fit();
+    staleAfter.shrink_to_fit();
+    maxAge.shrink_to_fit();
+    listOfCAs.shrink_to_fit();
+    caFirstPoints.shrink_to_fit();
+    caGiGroups.shrink_to_fit();
+}
+
+bool
+IEC104ExchangeTable::caRange(int ca, uint32_t& first, uint32_t& last) const
+{
+    auto it = std::lower_bound(listOfCAs.begin(), listOfCAs.end(), ca);
+
+    if ((it == listOfCAs.end()) || (*it != ca))
+        return false;
+
+    size_t caIndex = static_cast<size_t>(it - listOfCAs.begin());
+
+    first = caFirstPoints[caIndex];
+    last = caFirstPoints[caIndex + 1];
+
+    return true;
+}
+
+std::vector<int>
+IEC104ExchangeTable::casInGroup(int group) const
+{
+    std::vector<int> groupCas;
+
+    for (size_t caIndex = 0; caIndex < listOfCAs.size(); caIndex++) {
+        if (caGiGroups[caIndex] & (1u << group)) {
+            groupCas.push_back(listOfCAs[caIndex]);
         }
+    }
 
-        for (const Value& protocol : datapoint[JSON_PROTOCOLS].GetArray()) {
-            
-            if (!protocol.IsObject()) {
-                Iec104Utility::log_error("%s %s element is not an object", beforeLog.c_str(), JSON_PROTOCOLS);
-                return;
-            } 
-            
-            if (!protocol.HasMember(JSON_PROT_NAME) || !protocol[JSON_PROT_NAME].IsString()) {
-                Iec104Utility::log_error("%s %s does not exist or is not a string", beforeLog.c_str(), JSON_PROT_NAME);
-                return;
-            }
-            
-            string protocolName = protocol[JSON_PROT_NAME].GetString();
+    return groupCas;
+}
 
-            if (protocolName == PROTOCOL_IEC104) {
-                int giGroups = 0;
+uint32_t
+IEC104ExchangeTable::find(int ca, int ioa) const
+{
+    uint32_t first, last;
 
-                if (!protocol.HasMember(JSON_PROT_ADDR) || !protocol[JSON_PROT_ADDR].IsString()) {
-                    Iec104Utility::log_error("%s %s does not exist or is not a string", beforeLog.c_str(), JSON_PROT_ADDR);
-                    return;
-                }
-                if (!protocol.HasMember(JSON_PROT_TYPEID) || !protocol[JSON_PROT_TYPEID].IsString()) {
-                    Iec104Utility::log_error("%s %s does not exist or is not a string", beforeLog.c_str(), JSON_PROT_TYPEID);
-                    return;
-                }
+    if (!caRange(ca, first, last))
+        return NO_POINT;
 
-                string address = protocol[JSON_PROT_ADDR].GetString();
-                string typeIdStr = protocol[JSON_PROT_TYPEID].GetString();
+    auto begin = ioas.begin() + first;
+    auto end = ioas.begin() + last;
 
-                if (protocol.HasMember(JSON_PROT_GI_GROUPS)) {
-                    if(protocol[JSON_PROT_GI_GROUPS].IsString()) {
-                        string giGroupsStr = protocol["gi_groups"].GetString();
+    auto it = std::lower_bound(begin, end, ioa);
 
-                        vector<string> tokens = tokenizeString(giGroupsStr, " ");
+    if ((it == end) || (*it != ioa))
+        return NO_POINT;
 
-                        for (string token : tokens) {
-                            if (token == "station") {
-                                giGroups = 1;
-                            }
-                        }
-                    } else {
-                        Iec104Utility::log_warn("%s %s value is not a string", beforeLog.c_str(),
-                                                JSON_PROT_GI_GROUPS);
-                    }
-                }
+    return static_cast<uint32_t>(it - ioas.begin());
+}
 
-                Iec104Utility::log_debug("%s GI GROUPS = %i", beforeLog.c_str(), giGroups);
-
-                size_t sepPos = address.find("-");
-
-                if (sepPos != std::string::npos) {
-                    std::string caStr = address.substr(0, sepPos);
-                    std::string ioaStr = address.substr(sepPos + 1);
-
-                    int ca = 0;
-                    int ioa = 0;
-                    try {
-                        ca = std::stoi(caStr);
-                        ioa = std::stoi(ioaStr);
-                    } catch (const std::invalid_argument &e) {
-                        Iec104Utility::log_error("%s  Cannot convert ca '%s' or ioa '%s' to integer: %s",
-                                                beforeLog.c_str(), caStr.c_str(), ioaStr.c_str(), e.what());
-                        return;
-                    } catch (const std::out_of_range &e) {
-                        Iec104Utility::log_error("%s  Cannot convert ca '%s' or ioa '%s' to integer: %s",
-                                                beforeLog.c_str(), caStr.c_str(), ioaStr.c_str(), e.what());
-                        return;
-                    }
+uint32_t
+IEC104ExchangeTable::findLabel(const std::string& label) const
+{
+    uint32_t labelId = labels.find(label);
+
+    if ((labelId == IEC104LabelPool::NOT_FOUND) || (labelId >= labelPoints.size()))
+        return NO_POINT;
+
+    return labelPoints[labelId];
+}
 
-                    auto def = std::make_shared<DataExchangeDefinition>();
+IEC104ExchangeTable::MemoryUsage
+IEC104ExchangeTable::memoryUsage() const
+{
+    MemoryUsage usage;
 
-                    if (def) {
-                        def->ca = ca;
-                        def->ioa = ioa;
-                        def->label = label;
-                        def->typeId = IEC104ClientConfig::getTypeIdFromString(typeIdStr);
-                        def->giGroups = giGroups;
+    usage.points = Size();
+    usage.labels = labels.Size();
 
-                        Iec104Utility::log_debug("%s  Added exchange data %i:%i type: %i (%s)", beforeLog.c_str(), ca, ioa, def->typeId,
-                                                typeIdStr.c_str());
-                        ExchangeDefinition()[ca][ioa] = def;
+    usage.pointBytes = (cas.capacity() * sizeof(int32_t)) + (ioas.capacity() * sizeof(int32_t)) +
+                       typeIds.capacity() + flags.capacity() +
+                       (giGroups.capacity() * sizeof(uint32_t)) + (labelIds.capacity() * sizeof(uint32_t)) +
+                       (staleAfter.capacity() * sizeof(uint32_t)) + (maxAge.capacity() * sizeof(uint32_t));
 
-                        if (isGiTriggeringTs) {
-                            Iec104Utility::log_debug("Adding TS %s with ca %d ioa %d to GI triggering one", def->label, def->ca, def->ioa);
-                            m_cgTriggeringTsAdresses.insert(make_pair(ca, ioa));
-                        }
-                    }
-                } else {
-                    Iec104Utility::log_error("%s  %s value does not follow format 'XXX-YYY': %s", beforeLog.c_str(), JSON_PROT_ADDR,
-                                            address.c_str());
-                    return;
-                }
-            }
-        }
+    usage.labelBytes = labels.memoryUsage();
+
+    usage.indexBytes = (listOfCAs.capacity() * sizeof(int)) + (caFirstPoints.capacity() * sizeof(uint32_t)) +
+                       (caGiGroups.capacity() * sizeof(uint32_t)) + sizeof(knownCas) + (labelPoints.capacity() * sizeof(uint32_t));
+
+    return usage;
+}
+
+bool
+IEC104ClientConfig::buildExchangeTable(const string& exchangeConfig, IEC104ExchangeTable& exchangeTable)
+{
+    m_exchangeTableFromCache = false;
+
+    if (m_exchangeCacheFile.empty()) {
+        return parseExchangeConfig(exchangeConfig, exchangeTable);
+    }
+
+    uint64_t jsonHash = IEC104ExchangeCache::hash(exchangeConfig);
+
+    if (IEC104ExchangeCache::load(m_exchangeCacheFile, jsonHash, exchangeTable)) {
+        exchangeTable.buildIndexes();
+        m_exchangeTableFromCache = true;
+        return true;
+    }
+
+    if (parseExchangeConfig(exchangeConfig, exchangeTable) == false) {
+        return false;
     }
 
-    for (auto& element : ExchangeDefinition()) {
-        int ca = element.first;
+    IEC104ExchangeCache::save(m_exchangeCacheFile, jsonHash, exchangeTable);
+
+    return true;
+}
+
+bool
+IEC104ClientConfig::parseExchangeConfig(const string& exchangeConfig, IEC104ExchangeTable& exchangeTable) const
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConfig::parseExchangeConfig -";
+
+    /* the configuration string is owned by the caller, so it is not parsed in situ */
+    StringStream stream(exchangeConfig.c_str());
+    ExchangeConfigHandler handler(exchangeTable);
+    Reader reader;
+
+    ParseResult result = reader.Parse(stream, handler);
 
-        if (std::find(m_listOfCAs.begin(), m_listOfCAs.end(), ca) == m_listOfCAs.end()) {
-            m_listOfCAs.push_back(ca);
+    bool complete = false;
+
+    if (result.IsError()) {
+        /* errors detected by the handler are already logged */
+        if (result.Code() != kParseErrorTermination) {
+            Iec104Utility::log_fatal("%s Parsing error in exchanged_data json, offset %u: %s", beforeLog.c_str(),
+                                    static_cast<unsigned>(result.Offset()), GetParseError_En(result.Code()));
         }
     }
+    else {
+        complete = handler.isComplete();
+    }
 
-    m_exchangeConfigComplete = true;
+    exchangeTable.buildIndexes();
+
+    Iec104Utility::log_debug("%s Imported %d data points (%lu CAs)", beforeLog.c_str(), handler.DatapointCount(),
+                            exchangeTable.listOfCAs.size());
+
+    return complete;
 }
@@ -1,5 +1,5 @@
 #include <ctime>
-#include <functional>
+#include <algorithm>
 
 #include <utils.h>
 #include <reading.h>
@@ -31,7 +31,11 @@ static uint64_t getMonotonicTimeInMs()
 IEC104ClientConnection::IEC104ClientConnection(
     std::shared_ptr<IEC104Client> client, std::shared_ptr<IEC104ClientRedGroup> redGroup, std::shared_ptr<RedGroupCon> connection,
     std::shared_ptr<IEC104ClientConfig> config, const std::string& pathLetter):
-    m_config(config), m_redGroup(redGroup), m_redGroupConnection(connection), m_client(client), m_path_letter(pathLetter)
+    m_config(config), m_redGroup(redGroup), m_redGroupConnection(connection), m_client(client),
+    m_reconnectBackoff(redGroup->ReconnectDelay(), redGroup->ReconnectMaxDelay(), redGroup->ReconnectJitter()),
+    m_windowTuner({redGroup->K(), redGroup->W(), redGroup->T2()},
+                  {redGroup->AutoTuneWMin(), redGroup->AutoTuneWMax(), redGroup->AutoTuneT2Min(), redGroup->T2(), redGroup->AutoTuneKMax()}),
+    m_commandPacing(redGroup->CmdRate(), redGroup->CmdBurst()), m_path_letter(pathLetter)
 {
     // Send initial path connection status audit
     m_sendConnectionStatusAudit("disconnected");
@@ -66,6 +70,30 @@ IEC104ClientConnection::Activate()
     }
 }
 
+void
+IEC104ClientConnection::Deactivate()
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::Deactivate - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    std::lock_guard<std::mutex> lock(m_conLock);
+    if (m_connectionState == CON_STATE_CONNECTED_ACTIVE) {
+        if (m_connection) {
+            Iec104Utility::log_info("%s Sending STOP-DT", beforeLog.c_str());
+            CS104_Connection_sendStopDT(m_connection);
+        }
+        else {
+            Iec104Utility::log_warn("%s CS104 connection unavailable, cannot send STOP-DT", beforeLog.c_str());
+        }
+
+        m_startDtSent = false;
+
+        m_connectionState = CON_STATE_CONNECTED_INACTIVE;
+        Iec104Utility::log_debug("%s New internal connection state: %d", beforeLog.c_str(), m_connectionState);
+    }
+}
+
 int
 IEC104ClientConnection::broadcastCA() const
 {
@@ -96,12 +124,28 @@ IEC104ClientConnection::m_connectionHandler(void* parameter, CS104_Connection co
         self->m_connectionState = CON_STATE_CLOSED;
         self->m_connected = false;
         self->m_connecting = false;
+        self->m_pathHealth.connectionClosed();
+    }
+    else if (event == CS104_CONNECTION_FAILED)
+    {
+        /* the TCP connection could not be established */
+        self->m_connectionState = CON_STATE_CLOSED;
+        self->m_connected = false;
+        self->m_connecting = false;
     }
     else if (event == CS104_CONNECTION_OPENED)
     {
         self->m_connectionState = CON_STATE_CONNECTED_INACTIVE;
         self->m_connected = true;
         self->m_connecting = false;
+        self->m_opened = true;
+
+        self->m_pathHealth.connectionOpened();
+
+        /* the TLS handshake takes several round trips */
+        if (!self->m_redGroup->UseTLS()) {
+            self->m_pathHealth.rttSample(static_cast<int64_t>(getMonotonicTimeInMs() - self->m_connectStartTime));
+        }
     }
     else if (event == CS104_CONNECTION_STARTDT_CON_RECEIVED)
     {
@@ -122,8 +166,17 @@ IEC104ClientConnection::m_connectionHandler(void* parameter, CS104_Connection co
     }
 }
 
+void
+IEC104ClientConnection::m_rawMessageHandler(void* parameter, uint8_t* msg, int msgSize, bool sent)
+{
+    IEC104ClientConnection* self = static_cast<IEC104ClientConnection*>(parameter);
+
+    self->m_pathHealth.frame(msg, msgSize, sent, getMonotonicTimeInMs());
+    self->m_windowTuner.frame(msg, msgSize, sent);
+}
+
 bool
-IEC104ClientConnection::sendInterrogationCommand(int ca)
+IEC104ClientConnection::sendInterrogationCommand(int ca, QualifierOfInterrogation qoi)
 {
     std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::sendInterrogationCommand - ["
                         + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
@@ -134,12 +187,12 @@ IEC104ClientConnection::sendInterrogationCommand(int ca)
 
     if ((m_connection != nullptr) && (m_connectionState == CON_STATE_CONNECTED_ACTIVE))
     {
-        if (CS104_Connection_sendInterrogationCommand(m_connection, CS101_COT_ACTIVATION, ca, IEC60870_QOI_STATION)) {
-            Iec104Utility::log_debug("%s Interrogation command sent (CA=%i)", beforeLog.c_str(), ca);
+        if (CS104_Connection_sendInterrogationCommand(m_connection, CS101_COT_ACTIVATION, ca, qoi)) {
+            Iec104Utility::log_debug("%s Interrogation command sent (CA=%i, QOI=%i)", beforeLog.c_str(), ca, qoi);
             success = true;
         }
         else {
-            Iec104Utility::log_warn("%s Failed to send interrogation command (CA=%i)", beforeLog.c_str(), ca);
+            Iec104Utility::log_warn("%s Failed to send interrogation command (CA=%i, QOI=%i)", beforeLog.c_str(), ca, qoi);
         }
     }
     else {
@@ -150,6 +203,34 @@ IEC104ClientConnection::sendInterrogationCommand(int ca)
     return success;
 }
 
+bool
+IEC104ClientConnection::sendReadCommand(int ca, int ioa)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::sendReadCommand - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+    bool success = false;
+
+    std::lock_guard<std::mutex> lock(m_conLock);
+
+    if ((m_connection != nullptr) && (m_connectionState == CON_STATE_CONNECTED_ACTIVE))
+    {
+        if (CS104_Connection_sendReadCommand(m_connection, ca, ioa)) {
+            Iec104Utility::log_debug("%s Read command sent (CA=%i, IOA=%i)", beforeLog.c_str(), ca, ioa);
+            success = true;
+        }
+        else {
+            Iec104Utility::log_warn("%s Failed to send read command (CA=%i, IOA=%i)", beforeLog.c_str(), ca, ioa);
+        }
+    }
+    else {
+        Iec104Utility::log_warn("%s Connection unavailable (%s) or not in connected state (%i), cannot send read command (CA=%i, IOA=%i)",
+                                beforeLog.c_str(), (m_connection == nullptr)?"true":"false", static_cast<int>(m_connectionState), ca, ioa);
+    }
+
+    return success;
+}
+
 bool
 IEC104ClientConnection::sendSingleCommand(int ca, int ioa, bool value, bool withTime, bool select, long msTimestamp)
 {
@@ -428,6 +509,24 @@ IEC104ClientConnection::sendSetpointShort(int ca, int ioa, float value, bool wit
     return success;
 }
 
+bool
+IEC104ClientConnection::takeCommandToken()
+{
+    return m_commandPacing.take(getMonotonicTimeInMs());
+}
+
+void
+IEC104ClientConnection::refundCommandToken()
+{
+    m_commandPacing.refund();
+}
+
+IEC104TokenBucket::State
+IEC104ClientConnection::CommandPacing()
+{
+    return m_commandPacing.getState(getMonotonicTimeInMs());
+}
+
 void
 IEC104ClientConnection::prepareParameters()
 {
@@ -437,13 +536,20 @@ IEC104ClientConnection::prepareParameters()
     // Transport layer initialization
     sCS104_APCIParameters apci_parameters = {12, 8,  10,
                                              15, 10, 20};  // default values
-    apci_parameters.k = m_redGroup->K();
-    apci_parameters.w = m_redGroup->W();
+    /* k, w and t2 of the redundancy group, or the last tuned ones (apci_auto_tune) */
+    IEC104WindowTuner::Parameters window = m_windowTuner.connectionParameters();
+
+    apci_parameters.k = window.k;
+    apci_parameters.w = window.w;
     apci_parameters.t0 = m_redGroup->T0();
     apci_parameters.t1 = m_redGroup->T1();
-    apci_parameters.t2 = m_redGroup->T2();
+    apci_parameters.t2 = window.t2;
     apci_parameters.t3 = m_redGroup->T3();
 
+    if (m_redGroup->AutoTune()) {
+        Iec104Utility::log_info("%s APCI parameters tuned: k=%d, w=%d, t2=%d", beforeLog.c_str(), window.k, window.w, window.t2);
+    }
+
     CS104_Connection_setAPCIParameters(m_connection, &apci_parameters);
 
     int asdu_size = m_config->AsduSize();
@@ -474,10 +580,29 @@ IEC104ClientConnection::startNewInterrogationCycle()
     /* reset end of init flag */
     m_endOfInitReceived = false;
 
-    m_client->createListOfDatapointsInStationGroup();
+    if (m_firstGISent == false) {
+        /* the first GI refreshes all the groups */
+        scheduleGroupInterrogations(getMonotonicTimeInMs());
+    }
+
+    m_partialInterrogation = false;
+    m_interrogationGroup = IEC104ExchangeTable::GI_GROUP_STATION;
+
+    m_coverageWindowStart = getMonotonicTimeInMs();
+    m_skippedGiCycles = 0;
+
+    {
+        /* a full GI also covers the CAs requested after a change of the exchanged data */
+        std::lock_guard<std::mutex> lock(m_requestedCAsLock);
+        m_requestedCAs.clear();
+    }
+
+    m_client->createListOfDatapointsInGroup(IEC104ExchangeTable::GI_GROUP_STATION);
 
     if (!m_config->GiForAllCa()) {
 
+        m_perCaInterrogation = false;
+
         m_client->updateGiStatus(IEC104Client::GiStatus::STARTED);
 
         int broadcastAddr = broadcastCA();
@@ -496,16 +621,432 @@ IEC104ClientConnection::startNewInterrogationCycle()
     }
     else {
         Iec104Utility::log_debug("%s Prepare interrogation command for all CA", beforeLog.c_str());
-        m_listOfCA_it = m_config->ListOfCAs().begin();
 
         m_firstGISent = true;
 
-        if (m_listOfCA_it != m_config->ListOfCAs().end()) {
-            m_interrogationInProgress = true;
+        startCaInterrogations(m_config->ExchangeTable()->listOfCAs);
+    }
+}
+
+bool
+IEC104ClientConnection::skipInterrogationCycle(uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::skipInterrogationCycle - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    if (!m_config->isGiAdaptive())
+        return false;
+
+    if (m_skippedGiCycles >= m_config->GiAdaptiveMaxSkips()) {
+        Iec104Utility::log_debug("%s %d GI cycles skipped -> GI forced", beforeLog.c_str(), m_skippedGiCycles);
+        return false;
+    }
+
+    int maxReads = m_config->GiAdaptiveMaxReads();
+
+    IEC104PointFreshness::Coverage coverage = m_client->PointFreshness().coverage(m_config->ExchangeTable(), m_coverageWindowStart,
+                                                                                  static_cast<size_t>(maxReads));
+
+    if ((coverage.points == 0) || ((coverage.fresh * 100) < (static_cast<size_t>(m_config->GiAdaptiveCoverage()) * coverage.points))) {
+        Iec104Utility::log_debug("%s %lu/%lu data points refreshed since last cycle -> GI required", beforeLog.c_str(),
+                                coverage.fresh, coverage.points);
+        return false;
+    }
+
+    /* the remaining stale data points are read individually, the least recently refreshed first */
+    auto exchangeTable = m_config->ExchangeTable();
+
+    for (const IEC104PointFreshness::StalePoint& stalePoint : coverage.stale) {
+        m_client->ReadScheduler().request(exchangeTable, stalePoint.ca, stalePoint.ioa, currentTime);
+    }
+
+    Iec104Utility::log_info("%s GI cycle skipped: %lu/%lu data points refreshed since last cycle, %lu read command(s) queued",
+                            beforeLog.c_str(), coverage.fresh, coverage.points, coverage.stale.size());
+
+    m_skippedGiCycles++;
+    m_coverageWindowStart = currentTime;
+    m_nextGIStartTime = currentTime + (m_config->GiCycle() * 1000);
+
+    return true;
+}
+
+void
+IEC104ClientConnection::executeReadRefresh(uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::executeReadRefresh - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    /* the reads waiting for their response also use the k window of the connection */
+    size_t maxOutstanding = static_cast<size_t>(std::max(1, std::min(m_config->ReadMaxOutstanding(), m_redGroup->K())));
+
+    std::vector<IEC104ReadScheduler::Read> reads;
+
+    IEC104ReadScheduler& readScheduler = m_client->ReadScheduler();
+
+    readScheduler.tick(m_config->ExchangeTable(), m_client->PointFreshness(), currentTime, m_config->ReadStaleAfter(),
+                       maxOutstanding, static_cast<uint64_t>(m_config->ReadTimeout()) * 1000, reads);
+
+    for (size_t i = 0; i < reads.size(); i++) {
+        if (!sendReadCommand(reads[i].ca, reads[i].ioa)) {
+            /* retried at the next call, in the same order */
+            for (size_t j = reads.size(); j > i; j--) {
+                readScheduler.sendFailed(reads[j - 1]);
+            }
+
+            break;
+        }
+    }
+
+    if (!reads.empty()) {
+        Iec104Utility::log_debug("%s %lu read command(s) released, %lu queued", beforeLog.c_str(), reads.size(),
+                                readScheduler.QueuedCount());
+    }
+}
+
+void
+IEC104ClientConnection::requestInterrogation(const std::vector<int>& cas)
+{
+    std::lock_guard<std::mutex> lock(m_requestedCAsLock);
+
+    for (int ca : cas) {
+        if (std::find(m_requestedCAs.begin(), m_requestedCAs.end(), ca) == m_requestedCAs.end()) {
+            m_requestedCAs.push_back(ca);
+        }
+    }
+}
+
+void
+IEC104ClientConnection::startPartialInterrogationCycle(const std::vector<int>& cas)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::startPartialInterrogationCycle - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    Iec104Utility::log_info("%s Prepare interrogation command for %lu changed CA(s)", beforeLog.c_str(), cas.size());
+
+    m_client->createListOfDatapointsInGroup(IEC104ExchangeTable::GI_GROUP_STATION, cas);
+
+    m_partialInterrogation = true;
+    m_interrogationGroup = IEC104ExchangeTable::GI_GROUP_STATION;
+
+    startCaInterrogations(cas);
+}
+
+void
+IEC104ClientConnection::scheduleGroupInterrogations(uint64_t currentTime)
+{
+    for (int group = 1; group <= IEC104ExchangeTable::GI_GROUP_MAX; group++) {
+        m_nextGroupGIStartTime[group] = currentTime + (m_config->GiGroupCycle(group) * 1000);
+    }
+}
+
+int
+IEC104ClientConnection::dueGroupInterrogation(uint64_t currentTime) const
+{
+    int dueGroup = 0;
+
+    /* the group waiting for the longest time first */
+    for (int group = 1; group <= IEC104ExchangeTable::GI_GROUP_MAX; group++) {
+        if ((m_config->GiGroupCycle(group) > 0) && (currentTime > m_nextGroupGIStartTime[group])) {
+            if ((dueGroup == 0) || (m_nextGroupGIStartTime[group] < m_nextGroupGIStartTime[dueGroup])) {
+                dueGroup = group;
+            }
+        }
+    }
+
+    return dueGroup;
+}
+
+void
+IEC104ClientConnection::startGroupInterrogationCycle(int group, uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::startGroupInterrogationCycle - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    m_nextGroupGIStartTime[group] = currentTime + (m_config->GiGroupCycle(group) * 1000);
+
+    /* a group is interrogated with one request per CA having data points in the group */
+    std::vector<int> cas = m_config->ExchangeTable()->casInGroup(group);
+
+    if (cas.empty()) {
+        Iec104Utility::log_debug("%s No data point in group %d -> skip", beforeLog.c_str(), group);
+        return;
+    }
+
+    Iec104Utility::log_debug("%s Prepare interrogation command of group %d for %lu CA(s)", beforeLog.c_str(), group, cas.size());
+
+    m_client->createListOfDatapointsInGroup(group, cas);
+
+    m_partialInterrogation = false;
+    m_interrogationGroup = group;
+
+    startCaInterrogations(cas);
+}
+
+void
+IEC104ClientConnection::startCaInterrogations(const std::vector<int>& cas)
+{
+    m_listOfCAs = cas;
+    m_listOfCA_it = m_listOfCAs.begin();
+
+    {
+        std::lock_guard<std::mutex> lock(m_caInterrogationsLock);
+        m_caInterrogations.clear();
+    }
+
+    m_caInterrogationFailed = false;
+    m_interrogationCycleStart = getMonotonicTimeInMs();
+    m_perCaInterrogation = true;
+
+    if (m_listOfCA_it != m_listOfCAs.end()) {
+        m_interrogationInProgress = true;
+
+        m_client->updateGiStatus(IEC104Client::GiStatus::STARTED);
+    }
+}
+
+void
+IEC104ClientConnection::executeCaInterrogations(uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::executeCaInterrogations - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    int giTime = m_config->GiTime();
+    int group = m_interrogationGroup;
+    int timedOutCa = -1;
+    int timedOutState = 0;
+    size_t outstanding = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_caInterrogationsLock);
+
+        if (giTime != 0) {
+            for (const CaInterrogation& interrogation : m_caInterrogations) {
+                if (currentTime > interrogation.lastActivity + (giTime * 1000)) {
+                    timedOutCa = interrogation.ca;
+                    timedOutState = interrogation.state;
+                    break;
+                }
+            }
+        }
+
+        outstanding = m_caInterrogations.size();
+    }
+
+    bool failed = false;
+
+    if (timedOutCa != -1) {
+        Iec104Utility::log_error("%s Interrogation request timed out (no %s in %ds for CA=%i)", beforeLog.c_str(),
+                                (timedOutState == 1) ? "ACT_CON" : "ACT_TERM", giTime, timedOutCa);
+        failed = true;
+    }
+
+    /* keep up to gi_parallel CA interrogations outstanding */
+    while (!failed && (outstanding < static_cast<size_t>(m_config->GiParallel())) && (m_listOfCA_it != m_listOfCAs.end())) {
+        int ca = *m_listOfCA_it;
+
+        m_listOfCA_it++;
+
+        {
+            /* registered before sending: the ACT_CON can be received before sendInterrogationCommand returns */
+            std::lock_guard<std::mutex> lock(m_caInterrogationsLock);
+            m_caInterrogations.push_back({ca, 1, getMonotonicTimeInMs()});
+        }
+
+        if (sendInterrogationCommand(ca, static_cast<QualifierOfInterrogation>(IEC60870_QOI_STATION + group))) {
+            Iec104Utility::log_debug("%s Sent GI request to CA=%i (group %d)", beforeLog.c_str(), ca, group);
+            outstanding++;
+        }
+        else {
+            Iec104Utility::log_error("%s Failed to send interrogation command to CA=%i!", beforeLog.c_str(), ca);
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        {
+            std::lock_guard<std::mutex> lock(m_caInterrogationsLock);
+            m_caInterrogations.clear();
+        }
+
+        m_listOfCA_it = m_listOfCAs.end();
+        m_interrogationInProgress = false;
+        m_partialInterrogation = false;
+
+        m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID);
+
+        if (group != IEC104ExchangeTable::GI_GROUP_STATION) {
+            /* only the points of the group are concerned, the group is interrogated again at its next cycle */
+            m_caInterrogationFailed = true;
+            m_nextGroupGIStartTime[group] = currentTime + (m_config->GiGroupCycle(group) * 1000);
+
+            return;
+        }
+
+        m_nextGIStartTime = currentTime + (m_config->GiCycle() * 1000);
+
+        m_client->updateGiStatus(IEC104Client::GiStatus::FAILED);
+
+        closeConnection();
+
+        return;
+    }
+
+    if ((outstanding == 0) && (m_listOfCA_it == m_listOfCAs.end())) {
+        Iec104Utility::log_debug("%s GI of group %d for %lu CA(s) completed in %llu ms", beforeLog.c_str(), group, m_listOfCAs.size(),
+                                (unsigned long long)(currentTime - m_interrogationCycleStart));
+
+        m_interrogationInProgress = false;
+
+        if (group != IEC104ExchangeTable::GI_GROUP_STATION) {
+            /* the GI status only reports the station interrogation */
+            m_nextGroupGIStartTime[group] = currentTime + (m_config->GiGroupCycle(group) * 1000);
+            return;
+        }
+
+        /* a partial GI does not delay the next GI cycle */
+        if (m_partialInterrogation == false) {
+            m_nextGIStartTime = currentTime + (m_config->GiCycle() * 1000);
+        }
+
+        m_partialInterrogation = false;
+
+        auto giStatus = m_client->getGiStatus();
+
+        if (!m_caInterrogationFailed &&
+            ((giStatus == IEC104Client::GiStatus::STARTED) || (giStatus == IEC104Client::GiStatus::IN_PROGRESS))) {
+            m_client->updateGiStatus(IEC104Client::GiStatus::FINISHED);
+        }
+    }
+}
+
+void
+IEC104ClientConnection::handleCaInterrogationMessage(CS101_ASDU asdu, CS101_CauseOfTransmission cot)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::handleCaInterrogationMessage - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    int ca = CS101_ASDU_getCA(asdu);
+    bool isCommand = (CS101_ASDU_getTypeID(asdu) == C_IC_NA_1);
+    int group = m_interrogationGroup;
+    bool isStation = (group == IEC104ExchangeTable::GI_GROUP_STATION);
+
+    enum { NONE, POSITIVE_ACT_CON, NEGATIVE_ACT_CON, ACT_TERM, GI_FAILED, GROUP_REJECTED } action = NONE;
+
+    {
+        std::lock_guard<std::mutex> lock(m_caInterrogationsLock);
+
+        auto interrogation = std::find_if(m_caInterrogations.begin(), m_caInterrogations.end(),
+                                          [ca](const CaInterrogation& entry) { return entry.ca == ca; });
+
+        if (interrogation == m_caInterrogations.end()) {
+            Iec104Utility::log_warn("%s Unexpected interrogation message for CA=%i (COT=%d)", beforeLog.c_str(), ca, cot);
+            return;
+        }
+
+        if (!isCommand) {
+            /* interrogation response */
+            if (cot != CS101_COT_INTERROGATED_BY_STATION + group) {
+                Iec104Utility::log_warn("%s Unexpected interrogation response (CA=%i, group=%d, COT=%d)", beforeLog.c_str(), ca, group,
+                                        cot);
+            }
+            else if (interrogation->state == 2) {
+                interrogation->lastActivity = getMonotonicTimeInMs();
+            }
+            else {
+                Iec104Utility::log_warn("%s Unexpected interrogation response (CA=%i, state=%d, COT=%d)", beforeLog.c_str(), ca,
+                                        interrogation->state, cot);
+            }
+
+            return;
+        }
+
+        if (cot == CS101_COT_ACTIVATION_CON) {
+            if (interrogation->state == 1) {
+                interrogation->state = 2;
+                interrogation->lastActivity = getMonotonicTimeInMs();
+
+                action = CS101_ASDU_isNegative(asdu) ? NEGATIVE_ACT_CON : POSITIVE_ACT_CON;
+
+                if ((action == NEGATIVE_ACT_CON) && !isStation) {
+                    /* the group is not interrogated: no ACT_TERM will follow */
+                    m_caInterrogations.erase(interrogation);
+                }
+            }
+            else {
+                Iec104Utility::log_warn("%s Unexpected ACT_CON (CA=%i, state: %i)", beforeLog.c_str(), ca, interrogation->state);
+            }
+        }
+        else if (cot == CS101_COT_ACTIVATION_TERMINATION) {
+            if (interrogation->state == 2) {
+                m_caInterrogations.erase(interrogation);
+
+                action = ACT_TERM;
+            }
+            else {
+                Iec104Utility::log_warn("%s Unexpected ACT_TERM (CA=%i, state: %i)", beforeLog.c_str(), ca, interrogation->state);
+            }
+        }
+        else if (isStation) {
+            action = GI_FAILED;
+        }
+        else {
+            /* unknown CA or group not supported by the server */
+            m_caInterrogations.erase(interrogation);
 
-            m_client->updateGiStatus(IEC104Client::GiStatus::STARTED);
+            action = GROUP_REJECTED;
         }
     }
+
+    switch (action) {
+        case POSITIVE_ACT_CON:
+            if (isStation) {
+                m_client->updateGiStatus(IEC104Client::GiStatus::IN_PROGRESS);
+            }
+            Iec104Utility::log_debug("%s Received positive ACT_CON (CA=%i, group=%d)", beforeLog.c_str(), ca, group);
+            break;
+
+        case NEGATIVE_ACT_CON:
+            m_caInterrogationFailed = true;
+            if (isStation) {
+                m_client->updateGiStatus(IEC104Client::GiStatus::FAILED);
+            }
+
+            m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID, ca);
+            Iec104Utility::log_debug("%s Received negative ACT_CON (CA=%i, group=%d)", beforeLog.c_str(), ca, group);
+            break;
+
+        case ACT_TERM:
+            /* the data points of this CA not received in the GI response are invalid */
+            m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID, ca);
+            Iec104Utility::log_debug("%s Received ACT_TERM (CA=%i, group=%d)", beforeLog.c_str(), ca, group);
+            break;
+
+        case GROUP_REJECTED:
+            m_caInterrogationFailed = true;
+
+            m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID, ca);
+            Iec104Utility::log_warn("%s Interrogation of group %d rejected (CA=%i, COT=%d)", beforeLog.c_str(), group, ca, cot);
+            break;
+
+        case GI_FAILED:
+            m_caInterrogationFailed = true;
+            m_client->updateGiStatus(IEC104Client::GiStatus::FAILED);
+
+            m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID);
+
+            Disonnect();
+            Iec104Utility::log_debug("%s GI failed (CA=%i, COT=%d)", beforeLog.c_str(), ca, cot);
+            break;
+
+        default:
+            break;
+    }
 }
 
 void
@@ -581,6 +1122,10 @@ IEC104ClientConnection::executePeriodicTasks()
             if (m_firstGISent == false)
             {
                 Iec104Utility::log_debug("%s Starting first GI cycle", beforeLog.c_str());
+
+                /* not delayed, covers the GIs requested before */
+                m_client->GiArbiter().started(getMonotonicTimeInMs(), true);
+
                 startNewInterrogationCycle();
             }
             else
@@ -589,7 +1134,10 @@ IEC104ClientConnection::executePeriodicTasks()
 
                 if (m_interrogationInProgress) {
 
-                    if (m_interrogationRequestState != 0) {
+                    if (m_perCaInterrogation) {
+                        executeCaInterrogations(currentTime);
+                    }
+                    else if (m_interrogationRequestState != 0) {
 
                         int giTime = m_config->GiTime();
                         if (m_interrogationRequestState == 1) { /* wait for ACT_CON */
@@ -631,63 +1179,88 @@ IEC104ClientConnection::executePeriodicTasks()
                         }
                     }
                     else {
-
-                        if (m_config->GiForAllCa()) {
-
-                            if (m_listOfCA_it != m_config->ListOfCAs().end()) {
-                                if (sendInterrogationCommand(*m_listOfCA_it)) {
-                                    Iec104Utility::log_debug("%s Sent GI request to CA=%i", beforeLog.c_str(), *m_listOfCA_it);
-                                    m_interrogationRequestState = 1;
-                                    m_interrogationRequestSent = getMonotonicTimeInMs();
-
-                                    m_client->updateGiStatus(IEC104Client::GiStatus::STARTED); //TODO is STARTED or IN_PROGRESS?
-                                }
-                                else {
-                                    Iec104Utility::log_error("%s Failed to send interrogation command to CA=%i!", beforeLog.c_str(),
-                                                            *m_listOfCA_it);
-
-                                    m_client->updateGiStatus(IEC104Client::GiStatus::FAILED);
-
-                                    m_client->updateQualityForDataObjectsNotReceivedInGIResponse(IEC60870_QUALITY_INVALID);
-
-                                    closeConnection();
-                                }
-
-                                m_listOfCA_it++;
-                            }
-                            else {
-                                Iec104Utility::log_debug("%s GI sent to all CA succesfully", beforeLog.c_str());
-                                m_interrogationInProgress = false;
-                                m_nextGIStartTime = currentTime + (m_config->GiCycle() * 1000);
-                            }
-                        }
-                        else {
-                            Iec104Utility::log_debug("%s GI sent to single CA, end interrogation", beforeLog.c_str());
-                            m_interrogationInProgress = false;
-                        }
+                        Iec104Utility::log_debug("%s GI sent to single CA, end interrogation", beforeLog.c_str());
+                        m_interrogationInProgress = false;
                     }
                 }
                 else
                 {
+                    IEC104GiArbiter& giArbiter = m_client->GiArbiter();
+                    uint64_t giMinInterval = static_cast<uint64_t>(m_config->GiMinInterval()) * 1000;
+
                     if ((m_config->GiCycle() > 0) && (currentTime > m_nextGIStartTime)) {
-                        Iec104Utility::log_debug("%s Starting new GI cycle", beforeLog.c_str());
-                        startNewInterrogationCycle();
+                        if (skipInterrogationCycle(currentTime) == false) {
+                            giArbiter.request(IEC104GiArbiter::Source::CYCLE);
+                            m_nextGIStartTime = currentTime + (m_config->GiCycle() * 1000);
+                        }
                     }
                     else if (m_endOfInitReceived) {
-                        Iec104Utility::log_debug("%s Starting GI cycle after end of init", beforeLog.c_str());
-                        startNewInterrogationCycle();
+                        m_endOfInitReceived = false;
+                        giArbiter.request(IEC104GiArbiter::Source::END_OF_INIT);
                     }
-                    if (getGiRequested() && (m_client->getGiStatus() == IEC104Client::GiStatus::FAILED || m_client->getGiStatus() == IEC104Client::GiStatus::FINISHED)) {
-                        Iec104Utility::log_debug("%s Starting GI cycle on request.", beforeLog.c_str());
-                        setGiRequested(false);
+
+                    uint32_t giSources = 0;
+
+                    if (giArbiter.acquire(currentTime, giMinInterval, giSources)) {
+                        Iec104Utility::log_info("%s Starting GI cycle (requested by: %s)", beforeLog.c_str(),
+                                                IEC104GiArbiter::sourceNames(giSources).c_str());
                         startNewInterrogationCycle();
                     }
+
+                    if ((m_interrogationInProgress == false) && giArbiter.isIntervalElapsed(currentTime, giMinInterval)) {
+                        std::vector<int> requestedCAs;
+
+                        {
+                            std::lock_guard<std::mutex> lock(m_requestedCAsLock);
+                            requestedCAs.swap(m_requestedCAs);
+                        }
+
+                        if (requestedCAs.empty() == false) {
+                            giArbiter.started(currentTime, false);
+                            startPartialInterrogationCycle(requestedCAs);
+                        }
+                    }
+
+                    if (m_interrogationInProgress == false) {
+                        int group = dueGroupInterrogation(currentTime);
+
+                        if (group != 0) {
+                            Iec104Utility::log_debug("%s Starting GI of group %d", beforeLog.c_str(), group);
+                            startGroupInterrogationCycle(group, currentTime);
+                        }
+                    }
                 }
             }
         }
+
+        /* stale data points are read between the GIs */
+        if ((m_config->GiEnabled() == false) || (m_firstGISent && (m_interrogationInProgress == false))) {
+            executeReadRefresh(getMonotonicTimeInMs());
+        }
+    }
+
+    if (m_redGroup->AutoTune()) {
+        tuneWindow(getMonotonicTimeInMs());
     }
 }
 
+void
+IEC104ClientConnection::tuneWindow(uint64_t currentTime)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::tuneWindow - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    IEC104WindowTuner::Parameters window;
+
+    /* applied by the next connection, the running one keeps its parameters */
+    if (m_windowTuner.tune(currentTime, m_pathHealth.getMetrics().srtt, window) == false)
+        return;
+
+    Iec104Utility::log_info("%s APCI parameters tuned for the next connection: k=%d, w=%d, t2=%d", beforeLog.c_str(),
+                            window.k, window.w, window.t2);
+}
+
 
 bool
 IEC104ClientConnection::m_asduReceivedHandler(void* parameter, int address,
@@ -703,8 +1276,11 @@ IEC104ClientConnection::m_asduReceivedHandler(void* parameter, int address,
 
     CS101_CauseOfTransmission cot = CS101_ASDU_getCOT(asdu);
 
-    if (cot == CS101_COT_INTERROGATED_BY_STATION) {
-        if (self->m_interrogationRequestState == 2) {
+    if ((cot >= CS101_COT_INTERROGATED_BY_STATION) && (cot <= CS101_COT_INTERROGATED_BY_GROUP_16)) {
+        if (self->m_perCaInterrogation) {
+            self->handleCaInterrogationMessage(asdu, cot);
+        }
+        else if (self->m_interrogationRequestState == 2) {
             self->m_interrogationRequestSent = getMonotonicTimeInMs();
         }
         else {
@@ -775,7 +1351,10 @@ IEC104ClientConnection::m_asduReceivedHandler(void* parameter, int address,
                 {
                     Iec104Utility::log_debug("%s Received C_IC_NA_1 with COT=%i", beforeLog.c_str(), cot);
 
-                    if (cot == CS101_COT_ACTIVATION_CON) {
+                    if (self->m_perCaInterrogation) {
+                        self->handleCaInterrogationMessage(asdu, cot);
+                    }
+                    else if (cot == CS101_COT_ACTIVATION_CON) {
                         if (self->m_interrogationRequestState == 1) {
                             self->m_interrogationRequestState = 2;
 
@@ -838,6 +1417,21 @@ IEC104ClientConnection::m_asduReceivedHandler(void* parameter, int address,
                 Iec104Utility::log_info("%s Test command with time tag CP56Time2a", beforeLog.c_str());
                 break;
 
+            case C_RD_NA_1:
+                /* the value read is sent with COT=5 (request), only a rejected read command is echoed */
+                Iec104Utility::log_warn("%s Read command rejected (CA=%i, COT=%i)", beforeLog.c_str(), CS101_ASDU_getCA(asdu), cot);
+
+                if (CS101_ASDU_getNumberOfElements(asdu) > 0) {
+                    InformationObject io = CS101_ASDU_getElement(asdu, 0);
+
+                    if (io) {
+                        self->m_client->ReadScheduler().readRejected(CS101_ASDU_getCA(asdu), InformationObject_getObjectAddress(io),
+                                                                     getMonotonicTimeInMs());
+                        InformationObject_destroy(io);
+                    }
+                }
+                break;
+
             default:
                 Iec104Utility::log_debug("%s Type of message (%s (%i), COT: %i) not supported", beforeLog.c_str(),
                                         IEC104ClientConfig::getStringFromTypeID(typeId).c_str(), typeId, cot);
@@ -848,152 +1442,181 @@ IEC104ClientConnection::m_asduReceivedHandler(void* parameter, int address,
     return true;
 }
 
-bool
-IEC104ClientConnection::prepareConnection()
+static std::string certificateFile(const std::string& certificateStore, const std::string& certificateStorePem, const std::string& certificate)
 {
-    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::prepareConnection - ["
+    bool isPemCertificate = certificate.rfind(".pem") == certificate.size() - 4;
+
+    if (isPemCertificate)
+        return certificateStorePem + certificate;
+
+    return certificateStore + certificate;
+}
+
+TLSConfiguration
+IEC104ClientConnection::createTlsConfiguration(const std::string& privateKeyFile, const std::string& clientCertFile,
+                                               const std::vector<std::string>& remoteCertFiles, const std::vector<std::string>& caCertFiles)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::createTlsConfiguration - ["
                         + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
                         + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
-    bool success = false;
 
-    if (m_connection == nullptr)
-    {
-        if (m_redGroup->UseTLS())
-        {
-            TLSConfiguration tlsConfig = TLSConfiguration_create();
+    TLSConfiguration tlsConfig = TLSConfiguration_create();
 
-            bool tlsConfigOk = true;
+    bool tlsConfigOk = true;
 
-            string certificateStore = getDataDir() + string("/etc/certs/");
-            string certificateStorePem = getDataDir() + string("/etc/certs/pem/");
+    if (privateKeyFile.empty() || clientCertFile.empty()) {
+        Iec104Utility::log_error("%s No private key and/or certificate configured for client", beforeLog.c_str());
+        tlsConfigOk = false;
+    }
+    else {
+        if (access(privateKeyFile.c_str(), R_OK) == 0) {
+            if (TLSConfiguration_setOwnKeyFromFile(tlsConfig, privateKeyFile.c_str(), NULL) == false) {
+                Iec104Utility::log_error("%s Failed to load private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
+                tlsConfigOk = false;
+            }
+            else {
+                Iec104Utility::log_info("%s Loaded private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
+            }
+        }
+        else {
+            Iec104Utility::log_error("%s Failed to access private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
+            tlsConfigOk = false;
+        }
 
-            if (m_config->GetOwnCertificate().length() == 0 || m_config->GetPrivateKey().length() == 0) {
-                Iec104Utility::log_error("%s No private key and/or certificate configured for client", beforeLog.c_str());
+        if (access(clientCertFile.c_str(), R_OK) == 0) {
+            if (TLSConfiguration_setOwnCertificateFromFile(tlsConfig, clientCertFile.c_str()) == false) {
+                Iec104Utility::log_error("%s Failed to load client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
                 tlsConfigOk = false;
             }
             else {
-                string privateKeyFile = certificateStore + m_config->GetPrivateKey();
+                Iec104Utility::log_info("%s Loaded client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
+            }
+        }
+        else {
+            Iec104Utility::log_error("%s Failed to access client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
+            tlsConfigOk = false;
+        }
+    }
 
-                if (access(privateKeyFile.c_str(), R_OK) == 0) {
-                    if (TLSConfiguration_setOwnKeyFromFile(tlsConfig, privateKeyFile.c_str(), NULL) == false) {
-                        Iec104Utility::log_error("%s Failed to load private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
-                        tlsConfigOk = false;
-                    }
-                    else {
-                        Iec104Utility::log_info("%s Loaded private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
-                    }
+    if (remoteCertFiles.size() > 0) {
+        TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig, true);
+
+        for (const std::string& remoteCertFile : remoteCertFiles)
+        {
+            if (access(remoteCertFile.c_str(), R_OK) == 0) {
+                if (TLSConfiguration_addAllowedCertificateFromFile(tlsConfig, remoteCertFile.c_str()) == false) {
+                    Iec104Utility::log_warn("%s Failed to load remote certificate file: %s -> ignore certificate", beforeLog.c_str(),
+                                            remoteCertFile.c_str());
                 }
                 else {
-                    Iec104Utility::log_error("%s Failed to access private key file: %s", beforeLog.c_str(), privateKeyFile.c_str());
-                    tlsConfigOk = false;
+                    Iec104Utility::log_info("%s Loaded remote certificate file: %s", beforeLog.c_str(), remoteCertFile.c_str());
                 }
+            }
+            else {
+                Iec104Utility::log_warn("%s Failed to access remote certificate file: %s -> ignore certificate", beforeLog.c_str(),
+                                        remoteCertFile.c_str());
+            }
+        }
+    }
+    else {
+        Iec104Utility::log_info("%s Allowed unknown certificates", beforeLog.c_str());
+        TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig, false);
+    }
 
-                string clientCert =  m_config->GetOwnCertificate();
-                bool isPemClientCertificate = clientCert.rfind(".pem") == clientCert.size() - 4;
-
-                string clientCertFile;
-
-                if(isPemClientCertificate)
-                    clientCertFile = certificateStorePem + clientCert;
-                else
-                    clientCertFile = certificateStore + clientCert;
-
+    if (caCertFiles.size() > 0) {
+        TLSConfiguration_setChainValidation(tlsConfig, true);
 
-                if (access(clientCertFile.c_str(), R_OK) == 0) {
-                    if (TLSConfiguration_setOwnCertificateFromFile(tlsConfig, clientCertFile.c_str()) == false) {
-                        Iec104Utility::log_error("%s Failed to load client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
-                        tlsConfigOk = false;
-                    }
-                    else {
-                        Iec104Utility::log_info("%s Loaded client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
-                    }
+        for (const std::string& caCertFile : caCertFiles)
+        {
+            if (access(caCertFile.c_str(), R_OK) == 0) {
+                if (TLSConfiguration_addCACertificateFromFile(tlsConfig, caCertFile.c_str()) == false) {
+                    Iec104Utility::log_warn("%s Failed to load CA certificate file: %s -> ignore certificate", beforeLog.c_str(),
+                                            caCertFile.c_str());
                 }
                 else {
-                    Iec104Utility::log_error("%s Failed to access client certificate file: %s", beforeLog.c_str(), clientCertFile.c_str());
-                    tlsConfigOk = false;
+                    Iec104Utility::log_info("%s Allowed CA certificate file: %s", beforeLog.c_str(), caCertFile.c_str());
                 }
             }
+            else {
+                Iec104Utility::log_warn("%s Failed to access CA certificate file: %s -> ignore certificate", beforeLog.c_str(),
+                                        caCertFile.c_str());
+            }
+        }
+    }
+    else {
+        Iec104Utility::log_info("%s Disabled chain validation", beforeLog.c_str());
+        TLSConfiguration_setChainValidation(tlsConfig, false);
+    }
 
-            if (m_config->GetRemoteCertificates().size() > 0) {
-                TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig, true);
+    if (!tlsConfigOk) {
+        TLSConfiguration_destroy(tlsConfig);
+        return nullptr;
+    }
 
-                for (std::string& remoteCert : m_config->GetRemoteCertificates())
-                {
-                    bool isPemRemoteCertificate = remoteCert.rfind(".pem") == remoteCert.size() - 4;
+    TLSConfiguration_setRenegotiationTime(tlsConfig, 60000);
+
+    /* the session of the last connection is resumed by the next one, without a full handshake */
+    TLSConfiguration_enableSessionResumption(tlsConfig, true);
 
-                    string remoteCertFile;
+    return tlsConfig;
+}
 
-                    if(isPemRemoteCertificate)
-                        remoteCertFile = certificateStorePem + remoteCert;
-                    else
-                        remoteCertFile = certificateStore + remoteCert;
+bool
+IEC104ClientConnection::prepareConnection()
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::prepareConnection - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+    bool success = false;
 
-                    if (access(remoteCertFile.c_str(), R_OK) == 0) {
-                        if (TLSConfiguration_addAllowedCertificateFromFile(tlsConfig, remoteCertFile.c_str()) == false) {
-                            Iec104Utility::log_warn("%s Failed to load remote certificate file: %s -> ignore certificate", beforeLog.c_str(),
-                                                    remoteCertFile.c_str());
-                        }
-                        else {
-                            Iec104Utility::log_info("%s Loaded remote certificate file: %s", beforeLog.c_str(), remoteCertFile.c_str());
-                        }
-                    }
-                    else {
-                        Iec104Utility::log_warn("%s Failed to access remote certificate file: %s -> ignore certificate", beforeLog.c_str(),
-                                                remoteCertFile.c_str());
-                    }
-                }
-            }
-            else {
-                Iec104Utility::log_info("%s Allowed unknown certificates", beforeLog.c_str());
-                TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig, false);
+    if (m_connection == nullptr)
+    {
+        if (m_redGroup->UseTLS())
+        {
+            string certificateStore = getDataDir() + string("/etc/certs/");
+            string certificateStorePem = getDataDir() + string("/etc/certs/pem/");
+
+            string privateKeyFile;
+            string clientCertFile;
+            std::vector<std::string> remoteCertFiles;
+            std::vector<std::string> caCertFiles;
+
+            if (m_config->GetOwnCertificate().length() != 0 && m_config->GetPrivateKey().length() != 0) {
+                privateKeyFile = certificateStore + m_config->GetPrivateKey();
+                clientCertFile = certificateFile(certificateStore, certificateStorePem, m_config->GetOwnCertificate());
             }
 
-            if (m_config->GetCaCertificates().size() > 0) {
-                TLSConfiguration_setChainValidation(tlsConfig, true);
+            for (const std::string& remoteCert : m_config->GetRemoteCertificates()) {
+                remoteCertFiles.push_back(certificateFile(certificateStore, certificateStorePem, remoteCert));
+            }
 
-                for (std::string& caCert : m_config->GetCaCertificates())
-                {
-                    bool isPemCaCertificate = caCert.rfind(".pem") == caCert.size() - 4;
+            for (const std::string& caCert : m_config->GetCaCertificates()) {
+                caCertFiles.push_back(certificateFile(certificateStore, certificateStorePem, caCert));
+            }
 
-                    string caCertFile;
+            /* the empty entry separates the remote certificates from the CA certificates */
+            std::vector<std::string> tlsFiles = {privateKeyFile, clientCertFile};
+            tlsFiles.insert(tlsFiles.end(), remoteCertFiles.begin(), remoteCertFiles.end());
+            tlsFiles.push_back("");
+            tlsFiles.insert(tlsFiles.end(), caCertFiles.begin(), caCertFiles.end());
 
-                    if(isPemCaCertificate)
-                        caCertFile = certificateStorePem + caCert;
-                    else
-                        caCertFile = certificateStore + caCert;
+            TLSConfiguration tlsConfig = m_tlsCache.get(tlsFiles);
 
-                    if (access(caCertFile.c_str(), R_OK) == 0) {
-                        if (TLSConfiguration_addCACertificateFromFile(tlsConfig, caCertFile.c_str()) == false) {
-                            Iec104Utility::log_warn("%s Failed to load CA certificate file: %s -> ignore certificate", beforeLog.c_str(),
-                                                    caCertFile.c_str());
-                        }
-                        else {
-                            Iec104Utility::log_info("%s Allowed CA certificate file: %s", beforeLog.c_str(), caCertFile.c_str());
-                        }
-                    }
-                    else {
-                        Iec104Utility::log_warn("%s Failed to access CA certificate file: %s -> ignore certificate", beforeLog.c_str(),
-                                                caCertFile.c_str());
-                    }
-                }
+            if (tlsConfig) {
+                Iec104Utility::log_info("%s TLS files unchanged -> reuse TLS configuration and session", beforeLog.c_str());
             }
             else {
-                Iec104Utility::log_info("%s Disabled chain validation", beforeLog.c_str());
-                TLSConfiguration_setChainValidation(tlsConfig, false);
+                tlsConfig = createTlsConfiguration(privateKeyFile, clientCertFile, remoteCertFiles, caCertFiles);
+
+                if (tlsConfig) {
+                    m_tlsCache.set(tlsConfig, tlsFiles);
+                }
             }
 
-            if (tlsConfigOk) {
+            if (tlsConfig) {
                 Iec104Utility::log_info("%s Creating connection with TLS configuration above", beforeLog.c_str());
-                TLSConfiguration_setRenegotiationTime(tlsConfig, 60000);
 
                 m_connection = CS104_Connection_createSecure(m_redGroupConnection->ServerIP().c_str(), m_redGroupConnection->TcpPort(), tlsConfig);
-
-                if (m_connection) {
-                    m_tlsConfig = tlsConfig;
-                }
-                else {
-                    TLSConfiguration_destroy(tlsConfig);
-                }
             }
             else {
                 Iec104Utility::log_error("%s TLS configuration failed", beforeLog.c_str());
@@ -1015,6 +1638,8 @@ IEC104ClientConnection::prepareConnection()
 
             CS104_Connection_setConnectionHandler(m_connection, m_connectionHandler, this);
 
+            CS104_Connection_setRawMessageHandler(m_connection, m_rawMessageHandler, this);
+
             success = true;
             Iec104Utility::log_info("%s CS 104 connection started", beforeLog.c_str());
         }
@@ -1125,8 +1750,15 @@ IEC104ClientConnection::_conThread()
                     if (prepareConnection()) {
                         m_connectionState = CON_STATE_CONNECTING;
                         m_connecting = true;
+                        m_opened = false;
 
-                        m_delayExpirationTime = getMonotonicTimeInMs() + 10000;
+                        m_connectStartTime = getMonotonicTimeInMs();
+                        m_delayExpirationTime = m_connectStartTime + m_redGroup->ConnectTimeout();
+
+                        {
+                            std::lock_guard<std::mutex> statsLock(m_pathStatsLock);
+                            m_pathStats.connectAttempts++;
+                        }
 
                         CS104_Connection_connectAsync(m_connection);
 
@@ -1144,8 +1776,14 @@ IEC104ClientConnection::_conThread()
                 /* wait for connected event or timeout */
 
                 if (getMonotonicTimeInMs() > m_delayExpirationTime) {
-                    Iec104Utility::log_warn("%s Timeout while connecting (%lldms)", beforeLog.c_str(), m_delayExpirationTime);
-                    m_connectionState = CON_STATE_IDLE;
+                    Iec104Utility::log_warn("%s Timeout while connecting (%dms)", beforeLog.c_str(), m_redGroup->ConnectTimeout());
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_conLock);
+                        m_connecting = false;
+                    }
+
+                    scheduleReconnect(false);
                 }
 
                 break;
@@ -1153,6 +1791,15 @@ IEC104ClientConnection::_conThread()
             case CON_STATE_CONNECTED_INACTIVE:
                 /* wait for Activate signal */
                 m_sendConnectionStatusAudit("passive");
+
+                /* tuned parameters are applied by a new connection, only while this one is not active */
+                if (m_redGroup->AutoTune() && m_windowTuner.isChangePending()) {
+                    IEC104WindowTuner::Parameters next = m_windowTuner.getStats().next;
+
+                    Iec104Utility::log_info("%s Reconnecting to apply the tuned k=%d, w=%d, t2=%d", beforeLog.c_str(),
+                                            next.k, next.w, next.t2);
+                    closeConnection();
+                }
                 break;
 
             case CON_STATE_CONNECTED_ACTIVE:
@@ -1165,9 +1812,18 @@ IEC104ClientConnection::_conThread()
             case CON_STATE_CLOSED:
                 m_sendConnectionStatusAudit("disconnected");
 
-                // start delay timer for reconnect
-                m_delayExpirationTime = getMonotonicTimeInMs() + 10000;
-                m_connectionState = CON_STATE_WAIT_FOR_RECONNECT;
+                {
+                    bool connectionLost = false;
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_conLock);
+                        connectionLost = m_opened;
+                        m_opened = false;
+                    }
+
+                    // start delay timer for reconnect
+                    scheduleReconnect(connectionLost);
+                }
 
                 break;
 
@@ -1219,43 +1875,85 @@ IEC104ClientConnection::_conThread()
 
 
     CS104_Connection con = nullptr;
-    TLSConfiguration tlsConfig = nullptr;
 
     {
         std::lock_guard<std::mutex> lock(m_conLock);
 
         con = m_connection;
-        tlsConfig = m_tlsConfig;
 
         m_connection = nullptr;
-        m_tlsConfig = nullptr;
     }
 
     if (con) {
         CS104_Connection_destroy(con);
     }
 
-    if (tlsConfig) {
-        TLSConfiguration_destroy(tlsConfig);
-    }
+    m_tlsCache.clear();
     m_sendConnectionStatusAudit("disconnected");
     Iec104Utility::log_debug("%s Connection thread terminated", beforeLog.c_str());
 }
 
 
+void
+IEC104ClientConnection::scheduleReconnect(bool connectionLost)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ClientConnection::scheduleReconnect - ["
+                        + m_redGroup->Name() + ", " + std::to_string(m_redGroupConnection->ConnId()) + ", "
+                        + m_redGroupConnection->ServerIP() + ":" + std::to_string(m_redGroupConnection->TcpPort()) + "] -";
+
+    if (connectionLost) {
+        m_reconnectBackoff.reset();
+    }
+
+    uint64_t delay = m_reconnectBackoff.nextDelay();
+
+    {
+        std::lock_guard<std::mutex> lock(m_pathStatsLock);
+
+        if (connectionLost) {
+            m_pathStats.connectionsLost++;
+        }
+        else {
+            m_pathStats.connectFailures++;
+        }
+
+        m_pathStats.reconnectDelay = delay;
+    }
+
+    Iec104Utility::log_info("%s %s -> next connection attempt in %lums", beforeLog.c_str(),
+                            connectionLost ? "Connection lost" : "Connection attempt failed", delay);
+
+    m_delayExpirationTime = getMonotonicTimeInMs() + delay;
+    m_connectionState = CON_STATE_WAIT_FOR_RECONNECT;
+}
+
+int
+IEC104ClientConnection::BackupDelay() const
+{
+    return m_redGroup->BackupDelay();
+}
+
+IEC104ClientConnection::PathStats
+IEC104ClientConnection::getPathStats()
+{
+    std::lock_guard<std::mutex> lock(m_pathStatsLock);
+
+    return m_pathStats;
+}
+
 void
 IEC104ClientConnection::m_sendConnectionStatusAudit(const std::string& auditType)
 {
     if (auditType == m_last_audit) {
         return;
     }
-    std::function<void(const std::string&, const std::string&, bool)> auditFn = Iec104Utility::audit_info;
+    IEC104AuditQueue::Level level = IEC104AuditQueue::Level::INFORMATION;
     if (auditType == "disconnected") {
-        auditFn = Iec104Utility::audit_fail;
+        level = IEC104AuditQueue::Level::FAILURE;
     }
     else if (auditType == "passive" || auditType == "active") {
-        auditFn = Iec104Utility::audit_success;
+        level = IEC104AuditQueue::Level::SUCCESS;
     }
-    auditFn("SRVFL", m_client->getServiceName() + "-" + std::to_string(m_redGroup->Index()) + "-" + m_path_letter + "-" + auditType, true);
+    m_client->AuditQueue().push(level, "SRVFL", m_client->getServiceName() + "-" + std::to_string(m_redGroup->Index()) + "-" + m_path_letter + "-" + auditType);
     m_last_audit = auditType;
 }
\ No newline at end of file
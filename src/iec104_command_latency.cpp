@@ -0,0 +1,90 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include "iec104_command_latency.h"
+
+const uint64_t IEC104CommandLatency::bucketBounds[BUCKETS - 1] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+std::string
+IEC104CommandLatency::bucketName(int bucket)
+{
+    if (bucket < BUCKETS - 1)
+        return "le_" + std::to_string(bucketBounds[bucket]);
+
+    return "gt_" + std::to_string(bucketBounds[BUCKETS - 2]);
+}
+
+void
+IEC104CommandLatency::Histogram::add(uint64_t latency)
+{
+    int bucket = 0;
+
+    while ((bucket < BUCKETS - 1) && (latency > bucketBounds[bucket])) {
+        bucket++;
+    }
+
+    counts[bucket]++;
+    count++;
+    total += latency;
+
+    if (latency > max) {
+        max = latency;
+    }
+}
+
+void
+IEC104CommandLatency::add(Latencies& latencies, int64_t actConLatency, int64_t actTermLatency, bool timeout)
+{
+    if (actConLatency >= 0) {
+        latencies.actCon.add(static_cast<uint64_t>(actConLatency));
+    }
+
+    if (actTermLatency >= 0) {
+        latencies.actTerm.add(static_cast<uint64_t>(actTermLatency));
+    }
+
+    if (timeout) {
+        latencies.timeouts++;
+    }
+}
+
+void
+IEC104CommandLatency::record(int typeId, int ca, int64_t actConLatency, int64_t actTermLatency, bool timeout)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* value initialized (all counters 0) when first used */
+    add(m_byType[typeId], actConLatency, actTermLatency, timeout);
+    add(m_byCa[ca], actConLatency, actTermLatency, timeout);
+}
+
+std::map<int, IEC104CommandLatency::Latencies>
+IEC104CommandLatency::byType() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_byType;
+}
+
+std::map<int, IEC104CommandLatency::Latencies>
+IEC104CommandLatency::byCa() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_byCa;
+}
+
+void
+IEC104CommandLatency::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_byType.clear();
+    m_byCa.clear();
+}
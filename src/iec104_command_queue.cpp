@@ -0,0 +1,201 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include "iec104_command_queue.h"
+
+const char*
+IEC104CommandQueue::priorityName(Priority priority)
+{
+    switch (priority) {
+        case Priority::PROTECTION: return "protection";
+        case Priority::OPERATOR: return "operator";
+        case Priority::BULK: return "bulk";
+        default: return "unknown";
+    }
+}
+
+bool
+IEC104CommandQueue::priorityFromString(const std::string& name, Priority& priority)
+{
+    for (int i = 0; i < static_cast<int>(Priority::COUNT); i++) {
+        if (name == priorityName(static_cast<Priority>(i))) {
+            priority = static_cast<Priority>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+IEC104CommandQueue::push(const Command& command, size_t maxSize, std::vector<Command>& dropped)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_size >= maxSize) {
+        /* the last command of the lowest class below the new one makes room */
+        for (int i = static_cast<int>(Priority::COUNT) - 1; i > static_cast<int>(command.priority); i--) {
+            if (!m_commands[i].empty()) {
+                dropped.push_back(m_commands[i].back());
+                m_commands[i].pop_back();
+                m_size--;
+                m_counters.dropped++;
+                break;
+            }
+        }
+
+        if (m_size >= maxSize) {
+            m_counters.rejected++;
+            return false;
+        }
+    }
+
+    m_commands[static_cast<int>(command.priority)].push_back(command);
+    m_size++;
+    m_counters.queued++;
+
+    return true;
+}
+
+bool
+IEC104CommandQueue::replace(const Command& command, Command& superseded)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& commands : m_commands) {
+        for (auto it = commands.begin(); it != commands.end(); ++it) {
+            if ((it->typeId != command.typeId) || (it->ca != command.ca) || (it->ioa != command.ioa))
+                continue;
+
+            superseded = *it;
+            m_counters.superseded++;
+
+            if (it->priority == command.priority) {
+                *it = command;
+            }
+            else {
+                commands.erase(it);
+                m_commands[static_cast<int>(command.priority)].push_back(command);
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+IEC104CommandQueue::pushFront(const Command& command)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_commands[static_cast<int>(command.priority)].push_front(command);
+    m_size++;
+}
+
+bool
+IEC104CommandQueue::pop(Command& command)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& commands : m_commands) {
+        if (!commands.empty()) {
+            command = commands.front();
+            commands.pop_front();
+            m_size--;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+IEC104CommandQueue::released(const Command& command, uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint64_t wait = (currentTime > command.queuedAt) ? currentTime - command.queuedAt : 0;
+
+    m_counters.released++;
+    m_counters.waitTotal += wait;
+
+    if (wait > m_counters.waitMax) {
+        m_counters.waitMax = wait;
+    }
+}
+
+void
+IEC104CommandQueue::expire(uint64_t currentTime, std::vector<Command>& expired)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_size == 0)
+        return;
+
+    for (auto& commands : m_commands) {
+        size_t kept = 0;
+
+        for (size_t i = 0; i < commands.size(); i++) {
+            if ((commands[i].deadline != 0) && (commands[i].deadline <= currentTime)) {
+                expired.push_back(commands[i]);
+                m_counters.expired++;
+                continue;
+            }
+
+            commands[kept++] = commands[i];
+        }
+
+        m_size -= (commands.size() - kept);
+        commands.resize(kept);
+    }
+}
+
+size_t
+IEC104CommandQueue::Size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_size;
+}
+
+size_t
+IEC104CommandQueue::Size(Priority priority) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_commands[static_cast<int>(priority)].size();
+}
+
+IEC104CommandQueue::Counters
+IEC104CommandQueue::getCounters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_counters;
+}
+
+std::vector<IEC104CommandQueue::Command>
+IEC104CommandQueue::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<Command> commands;
+
+    for (auto& queued : m_commands) {
+        commands.insert(commands.end(), queued.begin(), queued.end());
+        queued.clear();
+    }
+
+    m_size = 0;
+
+    return commands;
+}
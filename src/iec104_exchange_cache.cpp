@@ -0,0 +1,229 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <utils.h>
+
+#include "iec104_exchange_cache.h"
+#include "iec104_client_config.h"
+#include "iec104_utility.h"
+
+static const char CACHE_MAGIC[8] = {'I', 'E', 'C', '1', '0', '4', 'X', 'T'};
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t
+IEC104ExchangeCache::hash(const char* data, size_t length, uint64_t seed)
+{
+    uint64_t result = seed;
+
+    for (size_t i = 0; i < length; i++) {
+        result ^= static_cast<unsigned char>(data[i]);
+        result *= FNV_PRIME;
+    }
+
+    return result;
+}
+
+uint64_t
+IEC104ExchangeCache::hash(const std::string& json)
+{
+    return hash(json.c_str(), json.size(), FNV_OFFSET_BASIS);
+}
+
+std::string
+IEC104ExchangeCache::defaultFile(const std::string& serviceName)
+{
+    std::string fileName = serviceName;
+
+    for (char& c : fileName) {
+        if (!isalnum(static_cast<unsigned char>(c)) && (c != '-') && (c != '_'))
+            c = '_';
+    }
+
+    std::string cacheDir = getDataDir() + "/cache";
+
+    mkdir(cacheDir.c_str(), 0755);
+
+    return cacheDir + "/iec104_exchange_" + fileName + ".bin";
+}
+
+bool
+IEC104ExchangeCache::load(const std::string& path, uint64_t jsonHash, IEC104ExchangeTable& exchangeTable)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ExchangeCache::load -";
+
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+        Iec104Utility::log_debug("%s No exchange table cache %s", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    struct stat fileStat;
+
+    if ((fstat(fd, &fileStat) != 0) || (static_cast<size_t>(fileStat.st_size) < sizeof(Header))) {
+        close(fd);
+        Iec104Utility::log_warn("%s Invalid exchange table cache %s -> ignored", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    size_t fileSize = static_cast<size_t>(fileStat.st_size);
+
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        Iec104Utility::log_warn("%s Cannot map exchange table cache %s -> ignored", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(mapping);
+    const Header* header = reinterpret_cast<const Header*>(data);
+
+    bool valid = (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0) && (header->version == FORMAT_VERSION) &&
+                 (fileSize == sizeof(Header) + (header->recordCount * sizeof(Record)) + header->labelBytes);
+
+    if (!valid) {
+        munmap(mapping, fileSize);
+        Iec104Utility::log_warn("%s Invalid exchange table cache %s -> ignored", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    if (header->jsonHash != jsonHash) {
+        munmap(mapping, fileSize);
+        Iec104Utility::log_info("%s Exchange table cache %s created for another exchanged_data -> ignored", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    const char* payload = data + sizeof(Header);
+
+    if (hash(payload, fileSize - sizeof(Header), FNV_OFFSET_BASIS) != header->checksum) {
+        munmap(mapping, fileSize);
+        Iec104Utility::log_warn("%s Corrupted exchange table cache %s -> ignored", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    const Record* records = reinterpret_cast<const Record*>(payload);
+    const char* labels = payload + (header->recordCount * sizeof(Record));
+
+    for (uint32_t i = 0; i < header->recordCount; i++) {
+        const Record& record = records[i];
+
+        if (static_cast<uint64_t>(record.labelOffset) + record.labelLength > header->labelBytes) {
+            munmap(mapping, fileSize);
+            exchangeTable = IEC104ExchangeTable();
+            Iec104Utility::log_warn("%s Invalid label in exchange table cache %s -> ignored", beforeLog.c_str(), path.c_str());
+            return false;
+        }
+
+        exchangeTable.addPoint(record.ca, record.ioa, record.typeId, record.giGroups, record.flags,
+                               exchangeTable.labels.intern(std::string(labels + record.labelOffset, record.labelLength)),
+                               record.staleAfter, record.maxAge);
+    }
+
+    uint32_t recordCount = header->recordCount;
+
+    munmap(mapping, fileSize);
+
+    Iec104Utility::log_info("%s Exchange table loaded from cache %s (%u data points)", beforeLog.c_str(), path.c_str(), recordCount);
+
+    return true;
+}
+
+bool
+IEC104ExchangeCache::save(const std::string& path, uint64_t jsonHash, const IEC104ExchangeTable& exchangeTable)
+{
+    std::string beforeLog = Iec104Utility::PluginName + " - IEC104ExchangeCache::save -";
+
+    std::vector<Record> records;
+    std::string labels;
+    std::vector<uint32_t> labelOffsets;
+
+    /* the labels of the table are already interned, the arena is written in label id order */
+    labelOffsets.reserve(exchangeTable.labels.Size());
+
+    for (uint32_t labelId = 0; labelId < exchangeTable.labels.Size(); labelId++) {
+        labelOffsets.push_back(static_cast<uint32_t>(labels.size()));
+        labels += exchangeTable.labels.Label(labelId);
+    }
+
+    records.reserve(exchangeTable.Size());
+
+    for (uint32_t pointId = 0; pointId < exchangeTable.Size(); pointId++) {
+        Record record;
+
+        memset(&record, 0, sizeof(record));
+
+        record.ca = exchangeTable.cas[pointId];
+        record.ioa = exchangeTable.ioas[pointId];
+        record.typeId = static_cast<int16_t>(exchangeTable.typeIds[pointId]);
+        record.giGroups = exchangeTable.giGroups[pointId];
+        record.flags = exchangeTable.flags[pointId];
+        record.labelOffset = labelOffsets[exchangeTable.labelIds[pointId]];
+        record.labelLength = static_cast<uint32_t>(exchangeTable.label(pointId).size());
+        record.staleAfter = exchangeTable.staleAfter[pointId];
+        record.maxAge = exchangeTable.maxAge[pointId];
+
+        records.push_back(record);
+    }
+
+    Header header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+
+    header.version = FORMAT_VERSION;
+    header.recordCount = static_cast<uint32_t>(records.size());
+    header.jsonHash = jsonHash;
+    header.labelBytes = labels.size();
+
+    size_t recordBytes = records.size() * sizeof(Record);
+
+    header.checksum = hash(reinterpret_cast<const char*>(records.data()), recordBytes, FNV_OFFSET_BASIS);
+    header.checksum = hash(labels.c_str(), labels.size(), header.checksum);
+
+    /* write a temporary file and rename it, so that a partially written cache is never used */
+    std::string tmpPath = path + ".tmp";
+
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+
+    if (file == nullptr) {
+        Iec104Utility::log_warn("%s Cannot create exchange table cache %s", beforeLog.c_str(), tmpPath.c_str());
+        return false;
+    }
+
+    bool written = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+                   (recordBytes == 0 || fwrite(records.data(), recordBytes, 1, file) == 1) &&
+                   (labels.empty() || fwrite(labels.c_str(), labels.size(), 1, file) == 1);
+
+    written = (fclose(file) == 0) && written;
+
+    if (!written || (rename(tmpPath.c_str(), path.c_str()) != 0)) {
+        unlink(tmpPath.c_str());
+        Iec104Utility::log_warn("%s Cannot write exchange table cache %s", beforeLog.c_str(), path.c_str());
+        return false;
+    }
+
+    Iec104Utility::log_debug("%s Exchange table cache %s written (%u data points, %lu label bytes)", beforeLog.c_str(), path.c_str(),
+                            header.recordCount, labels.size());
+
+    return true;
+}
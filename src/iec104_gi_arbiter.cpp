@@ -0,0 +1,167 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include "iec104_gi_arbiter.h"
+
+const char*
+IEC104GiArbiter::sourceName(Source source)
+{
+    switch (source) {
+        case Source::CYCLE: return "cycle";
+        case Source::END_OF_INIT: return "end_of_init";
+        case Source::NORTH_STATUS: return "north_status";
+        case Source::TRIGGER_SOUTH_GI: return "trigger_south_gi";
+        case Source::OPERATION: return "operation";
+        default: return "unknown";
+    }
+}
+
+std::string
+IEC104GiArbiter::sourceNames(uint32_t sources)
+{
+    std::string names;
+
+    for (int i = 0; i < static_cast<int>(Source::COUNT); i++) {
+        if (sources & (1u << i)) {
+            if (!names.empty())
+                names += ", ";
+
+            names += sourceName(static_cast<Source>(i));
+        }
+    }
+
+    return names;
+}
+
+bool
+IEC104GiArbiter::intervalElapsed(uint64_t currentTime, uint64_t minInterval) const
+{
+    return !m_hasStarted || (currentTime >= m_lastStart + minInterval);
+}
+
+void
+IEC104GiArbiter::request(Source source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    SourceCounters& counters = m_counters[static_cast<int>(source)];
+
+    counters.requests++;
+
+    if (m_pendingSources != 0) {
+        counters.merged++;
+    }
+    else {
+        m_pendingFirst = source;
+        m_pendingDeferred = false;
+    }
+
+    m_pendingSources |= (1u << static_cast<int>(source));
+}
+
+bool
+IEC104GiArbiter::isPending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_pendingSources != 0;
+}
+
+bool
+IEC104GiArbiter::acquire(uint64_t currentTime, uint64_t minInterval, uint32_t& sources)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_pendingSources == 0)
+        return false;
+
+    if (!intervalElapsed(currentTime, minInterval)) {
+        if (!m_pendingDeferred) {
+            m_counters[static_cast<int>(m_pendingFirst)].deferred++;
+            m_pendingDeferred = true;
+        }
+
+        return false;
+    }
+
+    sources = m_pendingSources;
+    m_pendingSources = 0;
+
+    m_hasStarted = true;
+    m_lastStart = currentTime;
+    m_startedCount++;
+
+    return true;
+}
+
+void
+IEC104GiArbiter::started(uint64_t currentTime, bool station)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (station && (m_pendingSources != 0)) {
+        /* the other requests were already counted as merged */
+        m_counters[static_cast<int>(m_pendingFirst)].merged++;
+        m_pendingSources = 0;
+    }
+
+    m_hasStarted = true;
+    m_lastStart = currentTime;
+    m_startedCount++;
+}
+
+IEC104GiArbiter::Admission
+IEC104GiArbiter::admit(Source source, uint64_t currentTime, uint64_t minInterval)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    SourceCounters& counters = m_counters[static_cast<int>(source)];
+
+    counters.requests++;
+
+    if (m_pendingSources != 0) {
+        counters.merged++;
+        return Admission::MERGED;
+    }
+
+    if (!intervalElapsed(currentTime, minInterval)) {
+        counters.deferred++;
+        return Admission::DEFER;
+    }
+
+    m_hasStarted = true;
+    m_lastStart = currentTime;
+    m_startedCount++;
+
+    return Admission::SEND;
+}
+
+bool
+IEC104GiArbiter::isIntervalElapsed(uint64_t currentTime, uint64_t minInterval) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return intervalElapsed(currentTime, minInterval);
+}
+
+IEC104GiArbiter::SourceCounters
+IEC104GiArbiter::getCounters(Source source) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_counters[static_cast<int>(source)];
+}
+
+uint64_t
+IEC104GiArbiter::StartedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_startedCount;
+}
@@ -0,0 +1,64 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include "iec104_label_pool.h"
+
+const uint32_t IEC104LabelPool::NOT_FOUND;
+
+uint32_t
+IEC104LabelPool::intern(const std::string& label)
+{
+    auto it = m_index.find(label);
+
+    if (it != m_index.end())
+        return it->second;
+
+    uint32_t labelId = static_cast<uint32_t>(m_labels.size());
+
+    m_labels.push_back(label);
+    m_index.emplace(m_labels.back(), labelId);
+
+    return labelId;
+}
+
+uint32_t
+IEC104LabelPool::find(const std::string& label) const
+{
+    auto it = m_index.find(label);
+
+    if (it == m_index.end())
+        return NOT_FOUND;
+
+    return it->second;
+}
+
+size_t
+IEC104LabelPool::memoryUsage() const
+{
+    size_t bytes = m_labels.size() * sizeof(std::string);
+
+    for (const std::string& label : m_labels) {
+        /* short labels are stored in the string object itself */
+        if (label.capacity() >= sizeof(std::string))
+            bytes += label.capacity() + 1;
+    }
+
+    /* buckets, and a node (next pointer, key, label id, cached hash) per label */
+    bytes += (m_index.bucket_count() * sizeof(void*)) +
+             (m_index.size() * (sizeof(void*) + sizeof(std::reference_wrapper<const std::string>) + sizeof(uint32_t) + sizeof(size_t)));
+
+    return bytes;
+}
+
+void
+IEC104LabelPool::clear()
+{
+    m_index.clear();
+    m_labels.clear();
+}
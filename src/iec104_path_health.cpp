@@ -0,0 +1,159 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <cstdlib>
+
+#include "iec104_path_health.h"
+
+#define STARTDT_ACT 0x07
+#define STOPDT_ACT 0x13
+#define TESTFR_ACT 0x43
+
+#define ERROR_RATE_FRAMES 32.0 /* frames of the error rate average */
+#define ERROR_RATE_WEIGHT 10 /* a path with 10 % errors costs twice its RTT */
+
+/* STARTDT/STOPDT/TESTFR act -> con */
+static uint8_t
+confirmation(uint8_t control)
+{
+    return static_cast<uint8_t>(((control & 0xfc) << 1) | 0x03);
+}
+
+void
+IEC104PathHealth::frame(const uint8_t* msg, int msgSize, bool sent, uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool valid = (msgSize >= 6) && (msg[0] == 0x68) && (msg[1] == msgSize - 2);
+
+    if (!sent) {
+        m_metrics.frames++;
+
+        if (!valid) {
+            m_metrics.frameErrors++;
+            addFrameResult(true);
+            return;
+        }
+
+        addFrameResult(false);
+    }
+
+    if (!valid || ((msg[2] & 0x03) != 0x03))
+        return;
+
+    uint8_t control = msg[2];
+
+    if (sent) {
+        if ((control == STARTDT_ACT) || (control == STOPDT_ACT) || (control == TESTFR_ACT)) {
+            if (m_pendingProbe != 0) {
+                m_metrics.probesLost++;
+                addFrameResult(true);
+            }
+
+            m_metrics.probes++;
+            m_pendingProbe = control;
+            m_pendingProbeTime = currentTime;
+        }
+    }
+    else if ((m_pendingProbe != 0) && (control == confirmation(m_pendingProbe))) {
+        m_pendingProbe = 0;
+        addRttSample((currentTime > m_pendingProbeTime) ? static_cast<int64_t>(currentTime - m_pendingProbeTime) : 0);
+    }
+}
+
+void
+IEC104PathHealth::rttSample(int64_t rtt)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    addRttSample(rtt);
+}
+
+void
+IEC104PathHealth::connectionOpened()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_metrics.rtt = -1;
+    m_metrics.srtt = -1;
+    m_metrics.rttVar = 0;
+    m_pendingProbe = 0;
+}
+
+void
+IEC104PathHealth::connectionClosed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_pendingProbe != 0) {
+        m_pendingProbe = 0;
+        m_metrics.probesLost++;
+        addFrameResult(true);
+    }
+}
+
+void
+IEC104PathHealth::addRttSample(int64_t rtt)
+{
+    m_metrics.rttSamples++;
+    m_metrics.rtt = rtt;
+
+    if ((m_metrics.rttMin < 0) || (rtt < m_metrics.rttMin)) {
+        m_metrics.rttMin = rtt;
+    }
+
+    if (m_metrics.srtt < 0) {
+        m_metrics.srtt = rtt;
+        m_metrics.rttVar = rtt / 2;
+    }
+    else {
+        m_metrics.rttVar = (3 * m_metrics.rttVar + std::llabs(m_metrics.srtt - rtt)) / 4;
+        m_metrics.srtt = (7 * m_metrics.srtt + rtt) / 8;
+    }
+}
+
+void
+IEC104PathHealth::addFrameResult(bool error)
+{
+    m_metrics.errorRate += ((error ? 1.0 : 0.0) - m_metrics.errorRate) / ERROR_RATE_FRAMES;
+}
+
+int64_t
+IEC104PathHealth::cost() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_metrics.srtt < 0)
+        return -1;
+
+    /* at least 1 ms, the errors of a local path count */
+    double rtt = static_cast<double>(m_metrics.srtt + 4 * m_metrics.rttVar + 1);
+
+    return static_cast<int64_t>(rtt * (1.0 + ERROR_RATE_WEIGHT * m_metrics.errorRate));
+}
+
+IEC104PathHealth::Metrics
+IEC104PathHealth::getMetrics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_metrics;
+}
+
+bool
+IEC104PathHealth::isBetter(int64_t candidateCost, int64_t currentCost, int hysteresis)
+{
+    if (candidateCost < 0)
+        return false;
+
+    if (currentCost < 0)
+        return true;
+
+    return (candidateCost * 100) < (currentCost * (100 - hysteresis));
+}
@@ -0,0 +1,147 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_point_freshness.h"
+#include "iec104_client_config.h"
+
+static uint32_t
+toStoredTime(uint64_t time)
+{
+    return static_cast<uint32_t>(time / 1000) + 1;
+}
+
+static uint64_t
+fromStoredTime(uint32_t storedTime)
+{
+    return (storedTime == 0) ? 0 : (static_cast<uint64_t>(storedTime - 1) * 1000);
+}
+
+void
+IEC104PointFreshness::setTable(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable)
+{
+    std::vector<uint32_t> lastRefresh(exchangeTable->Size(), 0);
+
+    if (m_exchangeTable) {
+        const IEC104ExchangeTable& oldTable = *m_exchangeTable;
+        const IEC104ExchangeTable& newTable = *exchangeTable;
+
+        /* both tables are ordered by CA and IOA */
+        uint32_t a = 0;
+        uint32_t b = 0;
+
+        while ((a < oldTable.Size()) && (b < newTable.Size())) {
+            if ((oldTable.cas[a] < newTable.cas[b]) || ((oldTable.cas[a] == newTable.cas[b]) && (oldTable.ioas[a] < newTable.ioas[b]))) {
+                a++;
+            }
+            else if ((oldTable.cas[a] == newTable.cas[b]) && (oldTable.ioas[a] == newTable.ioas[b])) {
+                lastRefresh[b] = m_lastRefresh[a];
+                a++;
+                b++;
+            }
+            else {
+                b++;
+            }
+        }
+    }
+
+    m_exchangeTable = exchangeTable;
+    m_lastRefresh.swap(lastRefresh);
+}
+
+void
+IEC104PointFreshness::refresh(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint32_t pointId, uint64_t time)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_exchangeTable != exchangeTable) {
+        setTable(exchangeTable);
+    }
+
+    if (pointId < m_lastRefresh.size()) {
+        m_lastRefresh[pointId] = toStoredTime(time);
+    }
+}
+
+uint64_t
+IEC104PointFreshness::lastRefresh(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint32_t pointId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_exchangeTable != exchangeTable) {
+        setTable(exchangeTable);
+    }
+
+    return (pointId < m_lastRefresh.size()) ? fromStoredTime(m_lastRefresh[pointId]) : 0;
+}
+
+IEC104PointFreshness::Coverage
+IEC104PointFreshness::coverage(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, uint64_t since, size_t maxStale)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_exchangeTable != exchangeTable) {
+        setTable(exchangeTable);
+    }
+
+    Coverage result = {0, 0, {}};
+
+    uint32_t sinceTime = toStoredTime(since);
+
+    std::vector<uint32_t> stalePoints;
+
+    for (uint32_t pointId = 0; pointId < m_lastRefresh.size(); pointId++) {
+        /* monitoring direction data points (M_xx types) of the station group */
+        if (!exchangeTable->isInStationGroup(pointId) || (exchangeTable->typeIds[pointId] >= 41))
+            continue;
+
+        result.points++;
+
+        if (m_lastRefresh[pointId] >= sinceTime) {
+            result.fresh++;
+        }
+        else {
+            stalePoints.push_back(pointId);
+        }
+    }
+
+    size_t count = std::min(maxStale, stalePoints.size());
+
+    std::partial_sort(stalePoints.begin(), stalePoints.begin() + count, stalePoints.end(),
+                      [this](uint32_t a, uint32_t b) { return m_lastRefresh[a] < m_lastRefresh[b]; });
+
+    result.stale.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t pointId = stalePoints[i];
+        uint32_t storedTime = m_lastRefresh[pointId];
+
+        result.stale.push_back({exchangeTable->cas[pointId], exchangeTable->ioas[pointId], fromStoredTime(storedTime)});
+    }
+
+    return result;
+}
+
+size_t
+IEC104PointFreshness::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_lastRefresh.capacity() * sizeof(uint32_t);
+}
+
+void
+IEC104PointFreshness::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_exchangeTable.reset();
+    m_lastRefresh.clear();
+}
@@ -0,0 +1,273 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_read_scheduler.h"
+#include "iec104_point_freshness.h"
+#include "iec104_client_config.h"
+
+IEC104ReadScheduler::IEC104ReadScheduler(size_t wheelSlots):
+    m_wheel(wheelSlots)
+{
+}
+
+uint32_t
+IEC104ReadScheduler::staleAfter(uint32_t pointId) const
+{
+    /* only the monitoring direction data points (M_xx types) are read */
+    if (m_exchangeTable->typeIds[pointId] >= 41)
+        return 0;
+
+    if (m_exchangeTable->staleAfter[pointId] > 0)
+        return m_exchangeTable->staleAfter[pointId];
+
+    return (m_defaultStaleAfter > 0) ? static_cast<uint32_t>(m_defaultStaleAfter) : 0;
+}
+
+void
+IEC104ReadScheduler::rebuild(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, IEC104PointFreshness& freshness,
+                             uint64_t currentTime)
+{
+    uint32_t now = static_cast<uint32_t>(currentTime / 1000);
+
+    if (!m_exchangeTable) {
+        m_startTime = now;
+    }
+
+    m_exchangeTable = exchangeTable;
+    m_wheel.reset(exchangeTable->Size(), now);
+    m_queued.assign(exchangeTable->Size(), false);
+
+    /* the reads in progress and the queued reads are kept for the addresses that still exist */
+    for (const auto& read : m_outstanding) {
+        uint32_t pointId = exchangeTable->find(read.ca, read.ioa);
+
+        if (pointId != IEC104ExchangeTable::NO_POINT) {
+            m_queued[pointId] = true;
+        }
+    }
+
+    std::deque<Read> queue;
+
+    for (const auto& read : m_queue) {
+        uint32_t pointId = exchangeTable->find(read.ca, read.ioa);
+
+        if ((pointId != IEC104ExchangeTable::NO_POINT) && !m_queued[pointId]) {
+            m_queued[pointId] = true;
+            queue.push_back(read);
+        }
+    }
+
+    m_queue.swap(queue);
+
+    for (uint32_t pointId = 0; pointId < exchangeTable->Size(); pointId++) {
+        uint32_t pointStaleAfter = staleAfter(pointId);
+
+        if ((pointStaleAfter == 0) || m_queued[pointId])
+            continue;
+
+        uint32_t lastRefresh = static_cast<uint32_t>(freshness.lastRefresh(exchangeTable, pointId) / 1000);
+        uint32_t expiry = std::max(lastRefresh, m_startTime) + pointStaleAfter;
+
+        if (expiry <= now) {
+            m_queued[pointId] = true;
+            m_queue.push_back({exchangeTable->cas[pointId], exchangeTable->ioas[pointId]});
+        }
+        else {
+            m_wheel.schedule(pointId, expiry);
+        }
+    }
+}
+
+void
+IEC104ReadScheduler::request(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, int ca, int ioa, uint64_t currentTime)
+{
+    (void)currentTime;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_exchangeTable && (m_exchangeTable == exchangeTable)) {
+        uint32_t pointId = exchangeTable->find(ca, ioa);
+
+        if ((pointId == IEC104ExchangeTable::NO_POINT) || m_queued[pointId])
+            return;
+
+        m_queued[pointId] = true;
+        m_wheel.cancel(pointId);
+    }
+
+    /* with another table the duplicates are removed when the wheel is rebuilt */
+    m_queue.push_back({ca, ioa});
+}
+
+void
+IEC104ReadScheduler::tick(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, IEC104PointFreshness& freshness,
+                          uint64_t currentTime, int defaultStaleAfter, size_t maxOutstanding, uint64_t timeout, std::vector<Read>& reads)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ((m_exchangeTable != exchangeTable) || (m_defaultStaleAfter != defaultStaleAfter)) {
+        m_defaultStaleAfter = defaultStaleAfter;
+        rebuild(exchangeTable, freshness, currentTime);
+    }
+
+    uint32_t now = static_cast<uint32_t>(currentTime / 1000);
+
+    std::vector<uint32_t> expired;
+
+    m_wheel.expire(now, expired);
+
+    for (uint32_t pointId : expired) {
+        /* the data point may have been refreshed since it was scheduled */
+        uint32_t lastRefresh = static_cast<uint32_t>(freshness.lastRefresh(exchangeTable, pointId) / 1000);
+        uint32_t expiry = std::max(lastRefresh, m_startTime) + staleAfter(pointId);
+
+        if (expiry > now) {
+            m_wheel.schedule(pointId, expiry);
+        }
+        else {
+            m_queued[pointId] = true;
+            m_queue.push_back({exchangeTable->cas[pointId], exchangeTable->ioas[pointId]});
+        }
+    }
+
+    /* reads without response */
+    for (size_t i = 0; i < m_outstanding.size();) {
+        if (m_outstanding[i].sentTime + timeout <= currentTime) {
+            m_counters.timedOut++;
+            completeRead(m_outstanding[i].ca, m_outstanding[i].ioa, currentTime);
+        }
+        else {
+            i++;
+        }
+    }
+
+    while (!m_queue.empty() && (m_outstanding.size() < maxOutstanding)) {
+        Read read = m_queue.front();
+        m_queue.pop_front();
+
+        m_outstanding.push_back({read.ca, read.ioa, currentTime});
+        m_counters.sent++;
+
+        reads.push_back(read);
+    }
+}
+
+bool
+IEC104ReadScheduler::completeRead(int ca, int ioa, uint64_t currentTime)
+{
+    auto it = std::find_if(m_outstanding.begin(), m_outstanding.end(),
+                           [ca, ioa](const OutstandingRead& read) { return (read.ca == ca) && (read.ioa == ioa); });
+
+    if (it == m_outstanding.end())
+        return false;
+
+    *it = m_outstanding.back();
+    m_outstanding.pop_back();
+
+    if (m_exchangeTable) {
+        uint32_t pointId = m_exchangeTable->find(ca, ioa);
+
+        if ((pointId != IEC104ExchangeTable::NO_POINT) && m_queued[pointId]) {
+            uint32_t pointStaleAfter = staleAfter(pointId);
+
+            m_queued[pointId] = false;
+
+            if (pointStaleAfter > 0) {
+                m_wheel.schedule(pointId, static_cast<uint32_t>(currentTime / 1000) + pointStaleAfter);
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+IEC104ReadScheduler::sendFailed(const Read& read)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = std::find_if(m_outstanding.begin(), m_outstanding.end(),
+                           [&read](const OutstandingRead& outstanding) { return (outstanding.ca == read.ca) && (outstanding.ioa == read.ioa); });
+
+    if (it == m_outstanding.end())
+        return;
+
+    *it = m_outstanding.back();
+    m_outstanding.pop_back();
+
+    m_counters.sent--;
+
+    m_queue.push_front(read);
+}
+
+void
+IEC104ReadScheduler::readAnswered(int ca, int ioa, uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (completeRead(ca, ioa, currentTime)) {
+        m_counters.answered++;
+    }
+}
+
+void
+IEC104ReadScheduler::readRejected(int ca, int ioa, uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (completeRead(ca, ioa, currentTime)) {
+        m_counters.rejected++;
+    }
+}
+
+IEC104ReadScheduler::Counters
+IEC104ReadScheduler::getCounters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_counters;
+}
+
+size_t
+IEC104ReadScheduler::QueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_queue.size();
+}
+
+size_t
+IEC104ReadScheduler::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t bytes = m_wheel.memoryUsage();
+
+    bytes += m_queued.capacity() / 8;
+    bytes += m_queue.size() * sizeof(Read);
+    bytes += m_outstanding.capacity() * sizeof(OutstandingRead);
+
+    return bytes;
+}
+
+void
+IEC104ReadScheduler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_exchangeTable.reset();
+    m_wheel.clear();
+    m_startTime = 0;
+    m_queued.clear();
+    m_queue.clear();
+    m_outstanding.clear();
+    m_counters = {0, 0, 0, 0};
+}
@@ -0,0 +1,52 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_reconnect_backoff.h"
+
+IEC104ReconnectBackoff::IEC104ReconnectBackoff(int initialDelay, int maxDelay, int jitter):
+    m_initialDelay(static_cast<uint64_t>(std::max(initialDelay, 0))),
+    m_maxDelay(static_cast<uint64_t>(std::max(maxDelay, initialDelay))),
+    m_jitter(std::min(std::max(jitter, 0), 100)),
+    m_random(std::random_device()())
+{
+}
+
+uint64_t
+IEC104ReconnectBackoff::nextDelay()
+{
+    int failures = m_failures++;
+
+    if (failures == 0)
+        return 0;
+
+    uint64_t delay = m_initialDelay;
+
+    for (int i = 1; (i < failures) && (delay < m_maxDelay); i++) {
+        delay *= 2;
+    }
+
+    delay = std::min(delay, m_maxDelay);
+
+    if ((m_jitter > 0) && (delay > 0)) {
+        int64_t range = static_cast<int64_t>(delay) * m_jitter / 100;
+        std::uniform_int_distribution<int64_t> distribution(-range, range);
+
+        delay = static_cast<uint64_t>(static_cast<int64_t>(delay) + distribution(m_random));
+    }
+
+    return delay;
+}
+
+void
+IEC104ReconnectBackoff::reset()
+{
+    m_failures = 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_staleness_monitor.h"
+#include "iec104_point_freshness.h"
+#include "iec104_client_config.h"
+
+IEC104StalenessMonitor::IEC104StalenessMonitor(size_t wheelSlots):
+    m_wheel(wheelSlots)
+{
+}
+
+void
+IEC104StalenessMonitor::rebuild(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, const IEC104ClientConfig& config,
+                                IEC104PointFreshness& freshness, uint32_t now)
+{
+    m_exchangeTable = exchangeTable;
+    m_wheel.reset(exchangeTable->Size(), now);
+    m_maxAge.assign(exchangeTable->Size(), 0);
+    m_reportedAt.assign(exchangeTable->Size(), 0);
+
+    for (uint32_t pointId = 0; pointId < exchangeTable->Size(); pointId++) {
+        int typeId = exchangeTable->typeIds[pointId];
+
+        /* only the monitoring direction data points (M_xx types) */
+        if (typeId >= 41)
+            continue;
+
+        uint32_t maxAge = exchangeTable->maxAge[pointId];
+
+        if (maxAge == 0) {
+            maxAge = static_cast<uint32_t>(config.MaxAge(typeId));
+        }
+
+        if (maxAge == 0)
+            continue;
+
+        m_maxAge[pointId] = maxAge;
+
+        uint32_t lastRefresh = static_cast<uint32_t>(freshness.lastRefresh(exchangeTable, pointId) / 1000);
+
+        m_wheel.schedule(pointId, std::max(lastRefresh, m_startTime) + maxAge);
+    }
+}
+
+void
+IEC104StalenessMonitor::tick(const std::shared_ptr<const IEC104ExchangeTable>& exchangeTable, const IEC104ClientConfig& config,
+                             IEC104PointFreshness& freshness, uint64_t currentTime, std::vector<uint32_t>& stalePoints)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint32_t now = static_cast<uint32_t>(currentTime / 1000);
+
+    if (m_restart || !m_exchangeTable) {
+        m_restart = false;
+        m_startTime = now;
+        rebuild(exchangeTable, config, freshness, now);
+    }
+    else if (m_exchangeTable != exchangeTable) {
+        rebuild(exchangeTable, config, freshness, now);
+    }
+
+    std::vector<uint32_t> expired;
+
+    m_wheel.expire(now, expired);
+
+    for (uint32_t pointId : expired) {
+        /* the data point may have been refreshed since it was scheduled */
+        uint32_t lastRefresh = static_cast<uint32_t>(freshness.lastRefresh(exchangeTable, pointId) / 1000);
+        uint32_t expiry = std::max(lastRefresh, m_startTime) + m_maxAge[pointId];
+
+        if (expiry > now) {
+            m_reportedAt[pointId] = 0;
+            m_wheel.schedule(pointId, expiry);
+            continue;
+        }
+
+        /* reported once, again only when refreshed since */
+        if ((m_reportedAt[pointId] == 0) || (lastRefresh + 1 >= m_reportedAt[pointId])) {
+            m_reportedAt[pointId] = now + 1;
+            m_staleCount++;
+            stalePoints.push_back(pointId);
+        }
+
+        m_wheel.schedule(pointId, now + m_maxAge[pointId]);
+    }
+}
+
+void
+IEC104StalenessMonitor::restart()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_restart = true;
+}
+
+uint64_t
+IEC104StalenessMonitor::StaleCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_staleCount;
+}
+
+size_t
+IEC104StalenessMonitor::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_wheel.memoryUsage() + (m_maxAge.capacity() * sizeof(uint32_t)) + (m_reportedAt.capacity() * sizeof(uint32_t));
+}
+
+void
+IEC104StalenessMonitor::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_exchangeTable.reset();
+    m_restart = false;
+    m_startTime = 0;
+    m_wheel.clear();
+    m_maxAge.clear();
+    m_reportedAt.clear();
+    m_staleCount = 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_timer_wheel.h"
+
+IEC104TimerWheel::IEC104TimerWheel(size_t slots):
+    m_slots(std::max<size_t>(slots, 1))
+{
+}
+
+void
+IEC104TimerWheel::reset(uint32_t points, uint32_t currentTime)
+{
+    for (auto& slot : m_slots) {
+        slot.clear();
+    }
+
+    m_time = currentTime;
+    m_expiry.assign(points, 0);
+}
+
+void
+IEC104TimerWheel::schedule(uint32_t pointId, uint32_t expiry)
+{
+    /* the slots up to m_time are already expired */
+    expiry = std::max(expiry, m_time + 1);
+
+    m_expiry[pointId] = expiry;
+    m_slots[expiry % m_slots.size()].push_back({pointId, expiry});
+}
+
+void
+IEC104TimerWheel::expire(uint32_t currentTime, std::vector<uint32_t>& expired)
+{
+    if (currentTime <= m_time)
+        return;
+
+    /* each slot is visited at most once */
+    uint32_t slotCount = static_cast<uint32_t>(std::min<uint64_t>(currentTime - m_time, m_slots.size()));
+
+    for (uint32_t i = 1; i <= slotCount; i++) {
+        std::vector<Entry>& slot = m_slots[(m_time + i) % m_slots.size()];
+
+        size_t kept = 0;
+
+        for (const auto& entry : slot) {
+            /* obsolete entry: the point was rescheduled or cancelled since */
+            if (entry.expiry != m_expiry[entry.pointId])
+                continue;
+
+            /* entry for a later turn of the wheel */
+            if (entry.expiry > currentTime) {
+                slot[kept++] = entry;
+                continue;
+            }
+
+            m_expiry[entry.pointId] = 0;
+            expired.push_back(entry.pointId);
+        }
+
+        slot.resize(kept);
+    }
+
+    m_time = currentTime;
+}
+
+size_t
+IEC104TimerWheel::memoryUsage() const
+{
+    size_t bytes = m_slots.capacity() * sizeof(std::vector<Entry>);
+
+    for (const auto& slot : m_slots) {
+        bytes += slot.capacity() * sizeof(Entry);
+    }
+
+    return bytes + m_expiry.capacity() * sizeof(uint32_t);
+}
+
+void
+IEC104TimerWheel::clear()
+{
+    for (auto& slot : m_slots) {
+        slot.clear();
+    }
+
+    m_time = 0;
+    m_expiry.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <sys/stat.h>
+
+#include "iec104_tls_cache.h"
+
+IEC104TlsCache::~IEC104TlsCache()
+{
+    clear();
+}
+
+std::string
+IEC104TlsCache::fingerprint(const std::string& file)
+{
+    struct stat fileStat;
+
+    if (stat(file.c_str(), &fileStat) != 0)
+        return "";
+
+    return std::to_string(static_cast<long long>(fileStat.st_size)) + ":" + std::to_string(static_cast<long long>(fileStat.st_mtime)) +
+           ":" + std::to_string(static_cast<unsigned long long>(fileStat.st_ino));
+}
+
+TLSConfiguration
+IEC104TlsCache::get(const std::vector<std::string>& files)
+{
+    if ((m_tlsConfig == nullptr) || (files != m_files))
+        return nullptr;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        if (fingerprint(files[i]) != m_fingerprints[i])
+            return nullptr;
+    }
+
+    m_hits++;
+
+    return m_tlsConfig;
+}
+
+void
+IEC104TlsCache::set(TLSConfiguration tlsConfig, const std::vector<std::string>& files)
+{
+    if (m_tlsConfig && (m_tlsConfig != tlsConfig)) {
+        TLSConfiguration_destroy(m_tlsConfig);
+    }
+
+    m_tlsConfig = tlsConfig;
+    m_files = files;
+    m_fingerprints.clear();
+
+    for (const auto& file : files) {
+        m_fingerprints.push_back(fingerprint(file));
+    }
+
+    m_loads++;
+}
+
+void
+IEC104TlsCache::clear()
+{
+    if (m_tlsConfig) {
+        TLSConfiguration_destroy(m_tlsConfig);
+        m_tlsConfig = nullptr;
+    }
+
+    m_files.clear();
+    m_fingerprints.clear();
+}
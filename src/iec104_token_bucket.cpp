@@ -0,0 +1,81 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+
+#include "iec104_token_bucket.h"
+
+IEC104TokenBucket::IEC104TokenBucket(int rate, int burst):
+    m_rate(std::max(rate, 0)), m_burst(std::max(burst, 1))
+{
+    m_milliTokens = static_cast<uint64_t>(m_burst) * 1000;
+}
+
+void
+IEC104TokenBucket::refill(uint64_t currentTime)
+{
+    if ((m_lastRefill != 0) && (currentTime > m_lastRefill)) {
+        m_milliTokens = std::min(m_milliTokens + ((currentTime - m_lastRefill) * static_cast<uint64_t>(m_rate)),
+                                 static_cast<uint64_t>(m_burst) * 1000);
+    }
+
+    if (currentTime > m_lastRefill) {
+        m_lastRefill = currentTime;
+    }
+}
+
+bool
+IEC104TokenBucket::take(uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_rate == 0) {
+        m_taken++;
+        return true;
+    }
+
+    refill(currentTime);
+
+    if (m_milliTokens < 1000) {
+        m_refused++;
+        return false;
+    }
+
+    m_milliTokens -= 1000;
+    m_taken++;
+
+    return true;
+}
+
+void
+IEC104TokenBucket::refund()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_taken == 0)
+        return;
+
+    m_taken--;
+
+    if (m_rate != 0) {
+        m_milliTokens = std::min(m_milliTokens + 1000, static_cast<uint64_t>(m_burst) * 1000);
+    }
+}
+
+IEC104TokenBucket::State
+IEC104TokenBucket::getState(uint64_t currentTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_rate != 0) {
+        refill(currentTime);
+    }
+
+    return {m_rate, m_burst, static_cast<int>(m_milliTokens / 1000), m_taken, m_refused};
+}
@@ -0,0 +1,177 @@
+/*
+ * Fledge IEC 104 south plugin.
+ *
+ * Copyright (c) 2022, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "iec104_window_tuner.h"
+
+#define SEQUENCE_MASK 0x7fff
+
+IEC104WindowTuner::IEC104WindowTuner(const Parameters& parameters, const Bounds& bounds):
+    m_parameters(parameters), m_next(parameters), m_bounds(bounds)
+{
+    m_stats = {parameters, parameters, 0.0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0};
+}
+
+void
+IEC104WindowTuner::frame(const uint8_t* msg, int msgSize, bool sent)
+{
+    if ((msgSize < 6) || (msg[0] != 0x68) || (msg[1] != msgSize - 2))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int receiveSequence = ((msg[4] >> 1) | (msg[5] << 7)) & SEQUENCE_MASK;
+
+    if ((msg[2] & 0x01) == 0) {
+        /* I-frame */
+        if (sent) {
+            int sendSequence = ((msg[2] >> 1) | (msg[3] << 7)) & SEQUENCE_MASK;
+
+            m_txNext = (sendSequence + 1) & SEQUENCE_MASK;
+            m_stats.txFrames++;
+
+            if (m_rxUnacked > 0) {
+                m_stats.acksSent++;
+                m_rxUnacked = 0;
+            }
+
+            int outstanding = (m_txNext - m_txAcked) & SEQUENCE_MASK;
+            double utilization = 100.0 * outstanding / m_parameters.k;
+
+            m_txUtilizationTotal += utilization;
+            m_stats.txUtilization = m_txUtilizationTotal / m_stats.txFrames;
+            m_stats.txUtilizationMax = std::max(m_stats.txUtilizationMax, utilization);
+
+            if (outstanding >= m_parameters.k) {
+                m_stats.txWindowFull++;
+                m_intervalTxWindowFull++;
+            }
+        }
+        else {
+            m_txAcked = receiveSequence;
+            m_rxUnacked++;
+            m_stats.rxFrames++;
+            m_intervalRxFrames++;
+
+            double utilization = 100.0 * m_rxUnacked / m_parameters.k;
+
+            m_rxUtilizationTotal += utilization;
+            m_stats.rxUtilization = m_rxUtilizationTotal / m_stats.rxFrames;
+            m_stats.rxUtilizationMax = std::max(m_stats.rxUtilizationMax, utilization);
+        }
+    }
+    else if ((msg[2] & 0x03) == 0x01) {
+        /* S-frame */
+        if (sent) {
+            m_stats.acksSent++;
+            m_rxUnacked = 0;
+        }
+        else {
+            m_txAcked = receiveSequence;
+        }
+    }
+}
+
+IEC104WindowTuner::Parameters
+IEC104WindowTuner::connectionParameters()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_parameters = m_next;
+
+    m_rxUnacked = 0;
+    m_txNext = 0;
+    m_txAcked = 0;
+    m_intervalStart = 0;
+
+    m_stats.parameters = m_parameters;
+
+    return m_parameters;
+}
+
+bool
+IEC104WindowTuner::tune(uint64_t currentTime, int64_t srtt, Parameters& parameters)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_intervalStart == 0) {
+        m_intervalStart = currentTime;
+        m_intervalRxFrames = 0;
+        m_intervalTxWindowFull = 0;
+        return false;
+    }
+
+    if (currentTime < m_intervalStart + TUNE_INTERVAL)
+        return false;
+
+    double rate = (1000.0 * m_intervalRxFrames) / (currentTime - m_intervalStart);
+    bool txWindowFull = (m_intervalTxWindowFull > 0);
+
+    m_stats.rxRate = rate;
+    m_intervalStart = currentTime;
+    m_intervalRxFrames = 0;
+    m_intervalTxWindowFull = 0;
+
+    if (txWindowFull && (m_bounds.kMax > m_next.k)) {
+        m_next.k = std::min(m_bounds.kMax, 2 * m_next.k);
+
+        /* w stays below 2/3 of k */
+        m_next.w = std::min(m_next.w, std::max((2 * m_next.k) / 3, 1));
+        m_stats.next = m_next;
+    }
+
+    /* no traffic or no RTT: nothing to tune */
+    if ((rate <= 0.0) || (srtt < 0))
+        return false;
+
+    int k = m_next.k;
+    int wMax = std::max((2 * k) / 3, 1);
+
+    if (m_bounds.wMax > 0) {
+        wMax = std::min(wMax, m_bounds.wMax);
+    }
+
+    int wMin = std::min(std::max(m_bounds.wMin, 1), wMax);
+
+    double framesPerRtt = rate * static_cast<double>(srtt) / 1000.0;
+    int w = std::min(std::max(k - static_cast<int>(std::ceil(framesPerRtt)) - 1, wMin), wMax);
+
+    int t2Max = std::max(m_bounds.t2Max, 1);
+    int t2Min = std::min(std::max(m_bounds.t2Min, 1), t2Max);
+    int t2 = std::min(std::max(static_cast<int>(std::ceil(w / rate)), t2Min), t2Max);
+
+    if ((w == m_next.w) && (t2 == m_next.t2))
+        return false;
+
+    m_next.w = w;
+    m_next.t2 = t2;
+    m_stats.next = m_next;
+
+    parameters = m_next;
+
+    return true;
+}
+
+bool
+IEC104WindowTuner::isChangePending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return (m_next.k != m_parameters.k) || (m_next.w != m_parameters.w) || (m_next.t2 != m_parameters.t2);
+}
+
+IEC104WindowTuner::Stats
+IEC104WindowTuner::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_stats;
+}
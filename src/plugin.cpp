@@ -75,6 +75,7 @@ static const char *default_config = QUOTE({
                     "gi_time" : 60,  
                     "gi_cycle" : 60,                
                     "gi_all_ca" : false,                                          
+                    "gi_parallel" : 1,
                     "utc_time" : false,                
                     "cmd_wttag" : false,              
                     "cmd_parallel" : 0,                                    
@@ -265,22 +266,26 @@ extern "C"
         auto *iec104 = reinterpret_cast<IEC104 *>(*handle);
         ConfigCategory config(iec104->getServiceName(), newConfig);
 
-        iec104->stop();
-
-        if (config.itemExists("protocol_stack") &&
-            config.itemExists("exchanged_data") &&
-            config.itemExists("tls"))
-            iec104->setJsonConfig(config.getValue("protocol_stack"),
-                                  config.getValue("exchanged_data"),
-                                  config.getValue("tls"));
-
         if (config.itemExists("asset"))
         {
             iec104->setAssetName(config.getValue("asset"));
-            Iec104Utility::log_info("%s 104 plugin restart after reconfigure asset", beforeLog.c_str());
-            iec104->start();
+
+            if (config.itemExists("protocol_stack") &&
+                config.itemExists("exchanged_data") &&
+                config.itemExists("tls")) {
+                // restarts the plugin only when needed
+                iec104->reconfigure(config.getValue("protocol_stack"),
+                                    config.getValue("exchanged_data"),
+                                    config.getValue("tls"));
+            }
+            else {
+                Iec104Utility::log_info("%s 104 plugin restart after reconfigure asset", beforeLog.c_str());
+                iec104->stop();
+                iec104->start();
+            }
         }
         else {
+            iec104->stop();
             Iec104Utility::log_error("%s 104 plugin restart failed", beforeLog.c_str());
         }
     }
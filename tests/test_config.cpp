@@ -11,6 +11,8 @@
 
 #include "iec104.h"
 #include "iec104_client_config.h"
+#include "iec104_command_queue.h"
+#include "iec104_client_redgroup.h"
 #include "iec104_utility.h"
 
 using namespace std;
@@ -931,6 +933,264 @@ static string protocol_config_broken19 = QUOTE({
 
 // PLUGIN DEFAULT EXCHANGED DATA CONF
 
+static string protocol_config_asdu_filter = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "asdu_filter" : {
+                    "reject_unknown_ca" : true,
+                    "allowed_cot" : [3, 5, 20, 64],
+                    "allowed_types" : ["M_SP_NA_1", "M_SP_TB_1", "M_XX_NA_1"],
+                    "test_asdu" : "reject"
+                }
+            }
+        }
+    });
+
+static string protocol_config_gi_adaptive = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "gi_adaptive" : {
+                    "coverage" : 90,
+                    "max_reads" : 2,
+                    "max_skips" : 0
+                }
+            }
+        }
+    });
+
+static string protocol_config_read_refresh = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "read_refresh" : {
+                    "stale_after" : 300,
+                    "max_outstanding" : 0,
+                    "timeout" : 5
+                }
+            }
+        }
+    });
+
+static string protocol_config_gi_min_interval = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "gi_min_interval" : 30
+            }
+        }
+    });
+
+static string protocol_config_max_age = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "max_age" : {
+                    "M_SP_NA_1" : 20,
+                    "C_SC_NA_1" : 5,
+                    "M_ME_NB_1" : -1,
+                    "M_XX" : 3
+                }
+            }
+        }
+    });
+
+static string protocol_config_cmd_queue = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "cmd_queue" : {
+                    "size" : 3,
+                    "deadline" : {
+                        "protection" : 1,
+                        "operator" : -1,
+                        "bulk" : 0
+                    }
+                }
+            }
+        }
+    });
+
+static string protocol_config_coalesce_setpoints = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "cmd_queue" : {
+                    "coalesce_setpoints" : true
+                }
+            }
+        }
+    });
+
 static string exchanged_data = QUOTE({
         "exchanged_data": {
             "name" : "iec104client",
@@ -1909,7 +2169,7 @@ protected:
     static bool checkTypeCommand(int ca, int ioa, bool value, bool select, long time, int typeId, std::shared_ptr<IEC104ClientConfig> config)
     {
         // check if the data point is in the exchange configuration
-        if (config->checkExchangeDataLayer(typeId, ca, ioa) == nullptr) {
+        if (config->checkExchangeDataLayer(typeId, ca, ioa) == IEC104ExchangeTable::NO_POINT) {
             Iec104Utility::log_error("Failed to send C_SC_NA_1 command - no such data point");
 
             return false;
@@ -2089,6 +2349,658 @@ TEST_F(ConfigTest, ConfigTest28) {
     ASSERT_FALSE(config.isTsAddressCgTriggering(37873, 3519059));
 }
 
+// Test for the ASDU filter configuration
+TEST_F(ConfigTest, ConfigTest29) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+    config.importExchangeConfig(exchanged_data);
+
+    ASSERT_TRUE(config.isCaAllowed(1234));
+    ASSERT_TRUE(config.isCotAllowed(CS101_COT_PERIODIC));
+    ASSERT_TRUE(config.isTypeIdAllowed(M_ME_NA_1));
+    ASSERT_FALSE(config.RejectTestAsdu());
+
+    IEC104ClientConfig filterConfig;
+
+    filterConfig.importProtocolConfig(protocol_config_asdu_filter);
+    filterConfig.importExchangeConfig(exchanged_data);
+
+    ASSERT_TRUE(filterConfig.isCaAllowed(41025));
+    ASSERT_FALSE(filterConfig.isCaAllowed(1234));
+    ASSERT_TRUE(filterConfig.isCotAllowed(CS101_COT_SPONTANEOUS));
+    ASSERT_TRUE(filterConfig.isCotAllowed(CS101_COT_INTERROGATED_BY_STATION));
+    ASSERT_FALSE(filterConfig.isCotAllowed(CS101_COT_PERIODIC));
+    ASSERT_FALSE(filterConfig.isCotAllowed(CS101_COT_BACKGROUND_SCAN));
+    ASSERT_TRUE(filterConfig.isTypeIdAllowed(M_SP_NA_1));
+    ASSERT_TRUE(filterConfig.isTypeIdAllowed(M_SP_TB_1));
+    ASSERT_FALSE(filterConfig.isTypeIdAllowed(M_ME_NA_1));
+    ASSERT_TRUE(filterConfig.RejectTestAsdu());
+}
+
+TEST_F(ConfigTest, ConfigTest30) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+    config.importExchangeConfig(exchanged_data);
+
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 4202832));
+    ASSERT_EQ(0, config.AddressReport().TotalCount());
+    ASSERT_FALSE(config.AddressReport().newPeriod());
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 999));
+    }
+
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_SP_NA_1, 41025, 4202832));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 999));
+
+    /* unknown addresses are not added to the exchanged data */
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 999));
+
+    ASSERT_EQ(6, config.AddressReport().TotalCount());
+
+    std::vector<IEC104AddressReport::Entry> top = config.AddressReport().top(10);
+
+    ASSERT_EQ(2, top.size());
+    ASSERT_EQ(IEC104AddressReport::Error::NOT_FOUND, top[0].error);
+    ASSERT_EQ(999, top[0].ioa);
+    ASSERT_EQ(5, top[0].count);
+    ASSERT_EQ(IEC104AddressReport::Error::TYPE_MISMATCH, top[1].error);
+    ASSERT_EQ(4202832, top[1].ioa);
+    ASSERT_EQ(M_SP_NA_1, top[1].typeId);
+    ASSERT_EQ(1, top[1].count);
+
+    ASSERT_TRUE(config.AddressReport().newPeriod());
+    ASSERT_FALSE(config.AddressReport().newPeriod());
+    ASSERT_EQ(6, config.AddressReport().TotalCount());
+
+    IEC104AddressReport report(2, 1);
+
+    ASSERT_TRUE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 1, M_ME_NA_1));
+    ASSERT_FALSE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 1, M_ME_NA_1));
+    ASSERT_FALSE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 1, M_ME_NA_1));
+    ASSERT_FALSE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 2, M_ME_NA_1));
+    ASSERT_FALSE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 3, M_ME_NA_1));
+
+    top = report.top(10);
+
+    ASSERT_EQ(2, top.size());
+    ASSERT_EQ(1, top[0].ioa);
+    ASSERT_EQ(3, top[1].ioa);
+    ASSERT_EQ(2, top[1].count);
+
+    report.newPeriod();
+
+    ASSERT_TRUE(report.add(IEC104AddressReport::Error::NOT_FOUND, 1, 4, M_ME_NA_1));
+}
+
+// Test for the replacement of the exchanged data while running
+TEST_F(ConfigTest, ConfigTest31) {
+    IEC104ClientConfig config;
+    std::vector<int> changedCAs;
+
+    config.importProtocolConfig(protocol_config);
+    config.importExchangeConfig(exchanged_data);
+    config.importTlsConfig(tls_config);
+
+    ASSERT_TRUE(config.isConfigComplete());
+
+    auto oldTable = config.ExchangeTable();
+
+    ASSERT_TRUE(config.reloadExchangeConfig(exchanged_data, changedCAs));
+    ASSERT_TRUE(changedCAs.empty());
+
+    ASSERT_FALSE(config.reloadExchangeConfig("{\"exchanged_data\" : {}}", changedCAs));
+    ASSERT_TRUE(config.isConfigComplete());
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 4202832));
+
+    ASSERT_TRUE(config.reloadExchangeConfig(gi_triggering_ts_exchange_data, changedCAs));
+    ASSERT_EQ(1, changedCAs.size());
+    ASSERT_EQ(37873, changedCAs[0]);
+    ASSERT_TRUE(config.isTsAddressCgTriggering(37873, 21096));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 41025, 4202832));
+
+    // previous snapshot is still usable
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, oldTable->find(41025, 4202832));
+}
+
+// Test for the binary cache of the exchange table
+TEST_F(ConfigTest, ConfigTest32) {
+    std::string cacheFile = "./iec104_exchange_cache_test.bin";
+
+    remove(cacheFile.c_str());
+
+    IEC104ClientConfig config;
+
+    config.setExchangeTableCache(cacheFile);
+    config.importExchangeConfig(gi_triggering_ts_exchange_data);
+
+    ASSERT_FALSE(config.isExchangeTableFromCache());
+
+    IEC104ClientConfig cachedConfig;
+
+    cachedConfig.setExchangeTableCache(cacheFile);
+    cachedConfig.importExchangeConfig(gi_triggering_ts_exchange_data);
+
+    ASSERT_TRUE(cachedConfig.isExchangeTableFromCache());
+
+    auto exchangeTable = config.ExchangeTable();
+    auto cachedExchangeTable = cachedConfig.ExchangeTable();
+
+    ASSERT_EQ(exchangeTable->listOfCAs, cachedExchangeTable->listOfCAs);
+    ASSERT_EQ(exchangeTable->knownCas, cachedExchangeTable->knownCas);
+    ASSERT_TRUE(cachedConfig.isTsAddressCgTriggering(37873, 21096));
+    ASSERT_FALSE(cachedConfig.isTsAddressCgTriggering(37873, 20706));
+
+    ASSERT_EQ(exchangeTable->Size(), cachedExchangeTable->Size());
+
+    for (uint32_t pointId = 0; pointId < exchangeTable->Size(); pointId++) {
+        ASSERT_EQ(exchangeTable->cas[pointId], cachedExchangeTable->cas[pointId]);
+        ASSERT_EQ(exchangeTable->ioas[pointId], cachedExchangeTable->ioas[pointId]);
+        ASSERT_EQ(exchangeTable->label(pointId), cachedExchangeTable->label(pointId));
+        ASSERT_EQ(exchangeTable->typeIds[pointId], cachedExchangeTable->typeIds[pointId]);
+        ASSERT_EQ(exchangeTable->giGroups[pointId], cachedExchangeTable->giGroups[pointId]);
+        ASSERT_EQ(exchangeTable->flags[pointId], cachedExchangeTable->flags[pointId]);
+    }
+
+    // another exchanged_data does not use the cache
+    IEC104ClientConfig otherConfig;
+
+    otherConfig.setExchangeTableCache(cacheFile);
+    otherConfig.importExchangeConfig(exchanged_data);
+
+    ASSERT_FALSE(otherConfig.isExchangeTableFromCache());
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, otherConfig.checkExchangeDataLayer(M_ME_NA_1, 41025, 4202832));
+
+    remove(cacheFile.c_str());
+}
+
+// Test for the label index and the interned labels of the exchange table
+TEST_F(ConfigTest, ConfigTest33) {
+    IEC104ClientConfig config;
+
+    config.importExchangeConfig(exchanged_data);
+
+    auto exchangeTable = config.ExchangeTable();
+
+    uint32_t pointId = exchangeTable->findLabel("TM-2");
+
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, pointId);
+    ASSERT_EQ(41025, exchangeTable->cas[pointId]);
+    ASSERT_EQ(4202852, exchangeTable->ioas[pointId]);
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, exchangeTable->findLabel("TM-unknown"));
+
+    // a label used by several addresses is stored once and refers to the first address
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"45-672",
+                          "typeid":"M_ME_NA_1"
+                       },
+                       {
+                          "name":"iec104",
+                          "address":"45-671",
+                          "typeid":"M_ME_NA_1"
+                       }
+                    ]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"44-672",
+                          "typeid":"M_ME_NA_1"
+                       }
+                    ]
+                }
+            ]
+        }
+    }));
+
+    exchangeTable = config.ExchangeTable();
+
+    ASSERT_EQ(2, exchangeTable->labels.Size());
+
+    uint32_t first = exchangeTable->find(45, 671);
+    uint32_t second = exchangeTable->find(45, 672);
+
+    ASSERT_EQ(exchangeTable->labelIds[first], exchangeTable->labelIds[second]);
+    ASSERT_EQ(&exchangeTable->label(first), &exchangeTable->label(second));
+    ASSERT_EQ("TM-1", exchangeTable->label(second));
+    ASSERT_EQ(first, exchangeTable->findLabel("TM-1"));
+    ASSERT_EQ(44, exchangeTable->cas[exchangeTable->findLabel("TM-2")]);
+}
+
+// Test for the data point storage of the exchange table
+TEST_F(ConfigTest, ConfigTest34) {
+    IEC104ClientConfig config;
+
+    // data points are not ordered by address and 45-671 is defined twice
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "datapoints" : [
+                {
+                    "label":"TS-1",
+                    "pivot_subtypes": ["trigger_south_gi"],
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"45-671",
+                          "typeid":"M_SP_NA_1",
+                          "gi_groups":"station"
+                       }
+                    ]
+                },
+                {
+                    "label":"TM-1",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"45-10",
+                          "typeid":"M_ME_NA_1"
+                       }
+                    ]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"12-672",
+                          "typeid":"M_ME_NB_1"
+                       }
+                    ]
+                },
+                {
+                    "label":"TS-2",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"45-671",
+                          "typeid":"M_SP_TB_1"
+                       }
+                    ]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    ASSERT_EQ(3, exchangeTable->Size());
+    ASSERT_EQ(2, exchangeTable->listOfCAs.size());
+    ASSERT_EQ(12, exchangeTable->listOfCAs[0]);
+    ASSERT_EQ(45, exchangeTable->listOfCAs[1]);
+
+    // point ids are ordered by CA and IOA
+    ASSERT_EQ(0, exchangeTable->find(12, 672));
+    ASSERT_EQ(1, exchangeTable->find(45, 10));
+    ASSERT_EQ(2, exchangeTable->find(45, 671));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, exchangeTable->find(45, 672));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, exchangeTable->find(13, 672));
+
+    uint32_t first, last;
+
+    ASSERT_TRUE(exchangeTable->caRange(45, first, last));
+    ASSERT_EQ(1, first);
+    ASSERT_EQ(3, last);
+    ASSERT_FALSE(exchangeTable->caRange(44, first, last));
+
+    // the last definition of an address is kept, it stays CG triggering
+    uint32_t pointId = exchangeTable->find(45, 671);
+
+    ASSERT_EQ("TS-2", exchangeTable->label(pointId));
+    ASSERT_EQ(M_SP_TB_1, exchangeTable->typeIds[pointId]);
+    ASSERT_FALSE(exchangeTable->isInStationGroup(pointId));
+    ASSERT_TRUE(config.isTsAddressCgTriggering(45, 671));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, exchangeTable->findLabel("TS-1"));
+
+    ASSERT_EQ(pointId, config.checkExchangeDataLayer(M_SP_TB_1, 45, 671));
+    ASSERT_EQ(IEC104ExchangeTable::NO_POINT, config.checkExchangeDataLayer(M_ME_NA_1, 45, 671));
+
+    IEC104ExchangeTable::MemoryUsage usage = exchangeTable->memoryUsage();
+
+    ASSERT_EQ(3, usage.points);
+    ASSERT_EQ(4, usage.labels);
+    ASSERT_EQ(3 * (6 * sizeof(uint32_t) + 2), usage.pointBytes);
+    ASSERT_GT(usage.labelBytes, 0);
+    ASSERT_GT(usage.indexBytes, 0);
+}
+
+// Test for the GI pipelining window
+TEST_F(ConfigTest, ConfigTest35) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(1, config.GiParallel());
+
+    string parallelConfig = protocol_config;
+    parallelConfig.replace(parallelConfig.find("\"cmd_parallel\""), 0, "\"gi_parallel\" : 4, ");
+
+    IEC104ClientConfig parallel;
+
+    parallel.importProtocolConfig(parallelConfig);
+
+    ASSERT_EQ(4, parallel.GiParallel());
+
+    string invalidConfig = protocol_config;
+    invalidConfig.replace(invalidConfig.find("\"cmd_parallel\""), 0, "\"gi_parallel\" : 0, ");
+
+    IEC104ClientConfig invalid;
+
+    invalid.importProtocolConfig(invalidConfig);
+
+    ASSERT_EQ(1, invalid.GiParallel());
+
+    string wrongTypeConfig = protocol_config;
+    wrongTypeConfig.replace(wrongTypeConfig.find("\"cmd_parallel\""), 0, "\"gi_parallel\" : \"4\", ");
+
+    IEC104ClientConfig wrongType;
+
+    wrongType.importProtocolConfig(wrongTypeConfig);
+
+    ASSERT_EQ(1, wrongType.GiParallel());
+}
+
+// Test for the interrogation groups
+TEST_F(ConfigTest, ConfigTest36) {
+    IEC104ClientConfig config;
+
+    string groupsConfig = protocol_config;
+    groupsConfig.replace(groupsConfig.find("\"cmd_parallel\""), 0,
+                         "\"gi_group_cycles\" : [{\"group\" : 1, \"cycle\" : 30}, {\"group\" : 16, \"cycle\" : 1800}, "
+                         "{\"group\" : 17, \"cycle\" : 10}, {\"group\" : 2, \"cycle\" : -1}, {\"group\" : 3}], ");
+
+    config.importProtocolConfig(groupsConfig);
+
+    ASSERT_EQ(30, config.GiGroupCycle(1));
+    ASSERT_EQ(1800, config.GiGroupCycle(16));
+    ASSERT_EQ(0, config.GiGroupCycle(2));
+    ASSERT_EQ(0, config.GiGroupCycle(3));
+    ASSERT_EQ(0, config.GiGroupCycle(17));
+    ASSERT_EQ(0, config.GiGroupCycle(0));
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "gi_groups":"station 1 group16"}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_ME_NA_1", "gi_groups":"2 group17 0"}]
+                },
+                {
+                    "label":"TM-3",
+                    "protocols":[{"name":"iec104", "address":"46-1", "typeid":"M_ME_NA_1", "gi_groups":"group2"}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    uint32_t tm1 = exchangeTable->find(45, 1);
+    uint32_t tm2 = exchangeTable->find(45, 2);
+
+    ASSERT_TRUE(exchangeTable->isInStationGroup(tm1));
+    ASSERT_TRUE(exchangeTable->isInGroup(tm1, 1));
+    ASSERT_TRUE(exchangeTable->isInGroup(tm1, 16));
+    ASSERT_FALSE(exchangeTable->isInGroup(tm1, 2));
+    ASSERT_FALSE(exchangeTable->isInStationGroup(tm2));
+    ASSERT_TRUE(exchangeTable->isInGroup(tm2, 2));
+
+    ASSERT_EQ(std::vector<int>({45}), exchangeTable->casInGroup(1));
+    ASSERT_EQ(std::vector<int>({45, 46}), exchangeTable->casInGroup(2));
+    ASSERT_TRUE(exchangeTable->casInGroup(3).empty());
+}
+
+// Test for the adaptive GI cycle configuration
+TEST_F(ConfigTest, GiAdaptiveConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_FALSE(config.isGiAdaptive());
+    ASSERT_EQ(3, config.GiAdaptiveMaxSkips());
+
+    config.importProtocolConfig(protocol_config_gi_adaptive);
+
+    ASSERT_TRUE(config.isGiAdaptive());
+    ASSERT_EQ(90, config.GiAdaptiveCoverage());
+    ASSERT_EQ(2, config.GiAdaptiveMaxReads());
+    ASSERT_EQ(3, config.GiAdaptiveMaxSkips());
+}
+
+// Test for the stale data point read configuration
+TEST_F(ConfigTest, ReadRefreshConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(0, config.ReadStaleAfter());
+    ASSERT_EQ(4, config.ReadMaxOutstanding());
+    ASSERT_EQ(10, config.ReadTimeout());
+
+    config.importProtocolConfig(protocol_config_read_refresh);
+
+    ASSERT_EQ(300, config.ReadStaleAfter());
+    ASSERT_EQ(4, config.ReadMaxOutstanding());
+    ASSERT_EQ(5, config.ReadTimeout());
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "stale_after":10}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_ME_NA_1", "stale_after":20}]
+                },
+                {
+                    "label":"TM-3",
+                    "protocols":[{"name":"iec104", "address":"45-3", "typeid":"M_ME_NA_1", "stale_after":"10"}]
+                },
+                {
+                    "label":"C-1",
+                    "protocols":[{"name":"iec104", "address":"45-100", "typeid":"C_SC_NA_1", "stale_after":10}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    ASSERT_EQ(10, exchangeTable->staleAfter[exchangeTable->find(45, 1)]);
+    ASSERT_EQ(20, exchangeTable->staleAfter[exchangeTable->find(45, 2)]);
+    ASSERT_EQ(0, exchangeTable->staleAfter[exchangeTable->find(45, 3)]);
+}
+
+// Test for the minimum interval between two GIs
+TEST_F(ConfigTest, GiMinIntervalConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(0, config.GiMinInterval());
+
+    config.importProtocolConfig(protocol_config_gi_min_interval);
+
+    ASSERT_EQ(30, config.GiMinInterval());
+}
+
+// Test for the maximum age of the data points
+TEST_F(ConfigTest, MaxAgeConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config_max_age);
+
+    ASSERT_EQ(20, config.MaxAge(M_SP_NA_1));
+    ASSERT_EQ(0, config.MaxAge(C_SC_NA_1));
+    ASSERT_EQ(0, config.MaxAge(M_ME_NB_1));
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "max_age":10}]
+                },
+                {
+                    "label":"TS-1",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_SP_NA_1"}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-3", "typeid":"M_ME_NB_1", "max_age":"10"}]
+                },
+                {
+                    "label":"C-1",
+                    "protocols":[{"name":"iec104", "address":"45-100", "typeid":"C_SC_NA_1", "max_age":10}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    uint32_t tm1 = exchangeTable->find(45, 1);
+    uint32_t ts1 = exchangeTable->find(45, 2);
+
+    ASSERT_EQ(10, exchangeTable->maxAge[tm1]);
+    ASSERT_EQ(0, exchangeTable->maxAge[ts1]);
+    ASSERT_EQ(0, exchangeTable->maxAge[exchangeTable->find(45, 3)]);
+}
+
+// Test for the command queue configuration
+TEST_F(ConfigTest, CommandQueueConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(1000, config.CmdQueueSize());
+    ASSERT_EQ(2, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::PROTECTION)));
+    ASSERT_EQ(10, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::OPERATOR)));
+    ASSERT_EQ(120, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::BULK)));
+
+    config.importProtocolConfig(protocol_config_cmd_queue);
+
+    ASSERT_EQ(3, config.CmdQueueSize());
+    ASSERT_EQ(1, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::PROTECTION)));
+    ASSERT_EQ(10, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::OPERATOR)));
+    ASSERT_EQ(0, config.CmdQueueDeadline(static_cast<int>(IEC104CommandQueue::Priority::BULK)));
+}
+
+// Test for the setpoint coalescing configuration
+TEST_F(ConfigTest, SetpointCoalescingConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_FALSE(config.isSetpointCoalescing());
+
+    config.importProtocolConfig(protocol_config_coalesce_setpoints);
+
+    ASSERT_TRUE(config.isSetpointCoalescing());
+}
+
+TEST_F(ConfigTest, CommandPacingConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(0, config.RedundancyGroups()[0]->CmdRate());
+    ASSERT_EQ(1, config.RedundancyGroups()[0]->CmdBurst());
+
+    string pacingConfig = protocol_config;
+    pacingConfig.replace(pacingConfig.find("\"k_value\""), 0, "\"cmd_rate\" : 5, \"cmd_burst\" : 0, ");
+
+    config.importProtocolConfig(pacingConfig);
+
+    ASSERT_EQ(5, config.RedundancyGroups()[0]->CmdRate());
+    ASSERT_EQ(1, config.RedundancyGroups()[0]->CmdBurst());
+}
+
+TEST_F(ConfigTest, ReconnectConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_EQ(10000, config.RedundancyGroups()[0]->ConnectTimeout());
+    ASSERT_EQ(1000, config.RedundancyGroups()[0]->ReconnectDelay());
+    ASSERT_EQ(10000, config.RedundancyGroups()[0]->ReconnectMaxDelay());
+    ASSERT_EQ(20, config.RedundancyGroups()[0]->ReconnectJitter());
+    ASSERT_EQ(5000, config.RedundancyGroups()[0]->BackupDelay());
+
+    string reconnectConfig = protocol_config;
+    reconnectConfig.replace(reconnectConfig.find("\"k_value\""), 0,
+                            "\"connect_timeout\" : 3000, \"reconnect_delay\" : 500, \"reconnect_max_delay\" : 100, "
+                            "\"reconnect_jitter\" : 101, \"backup_delay\" : 0, ");
+
+    config.importProtocolConfig(reconnectConfig);
+
+    ASSERT_EQ(3000, config.RedundancyGroups()[0]->ConnectTimeout());
+    ASSERT_EQ(500, config.RedundancyGroups()[0]->ReconnectDelay());
+    ASSERT_EQ(10000, config.RedundancyGroups()[0]->ReconnectMaxDelay());
+    ASSERT_EQ(20, config.RedundancyGroups()[0]->ReconnectJitter());
+    ASSERT_EQ(0, config.RedundancyGroups()[0]->BackupDelay());
+}
+
+TEST_F(ConfigTest, PathSelectionConfig) {
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config);
+
+    ASSERT_FALSE(config.isRttPathSelection());
+    ASSERT_FALSE(config.isPathSwitchover());
+    ASSERT_EQ(30, config.PathHysteresis());
+    ASSERT_EQ(30, config.PathHoldTime());
+
+    string pathConfig = protocol_config;
+    pathConfig.replace(pathConfig.find("\"redundancy_groups\""), 0,
+                       "\"path_selection\" : { \"mode\" : \"rtt\", \"switchover\" : true, \"hysteresis\" : 100, \"hold_time\" : 10 }, ");
+
+    config.importProtocolConfig(pathConfig);
+
+    ASSERT_TRUE(config.isRttPathSelection());
+    ASSERT_TRUE(config.isPathSwitchover());
+    ASSERT_EQ(30, config.PathHysteresis());
+    ASSERT_EQ(10, config.PathHoldTime());
+}
+
+TEST_F(ConfigTest, ApciAutoTuneConfig) {
+    IEC104ClientConfig config;
+
+    string autoTuneConfig = protocol_config;
+    autoTuneConfig.replace(autoTuneConfig.find("\"k_value\""), 0,
+                           "\"apci_auto_tune\" : { \"enabled\" : true, \"w_min\" : 0, \"w_max\" : 6, \"t2_min\" : 2, \"k_max\" : 24 }, ");
+
+    config.importProtocolConfig(autoTuneConfig);
+
+    ASSERT_TRUE(config.RedundancyGroups()[0]->AutoTune());
+    ASSERT_EQ(1, config.RedundancyGroups()[0]->AutoTuneWMin());
+    ASSERT_EQ(6, config.RedundancyGroups()[0]->AutoTuneWMax());
+    ASSERT_EQ(2, config.RedundancyGroups()[0]->AutoTuneT2Min());
+    ASSERT_EQ(24, config.RedundancyGroups()[0]->AutoTuneKMax());
+}
+
 // TEST_F(ConfigTest, ConfigTest1)
 // {
 //     asduHandlerCalled = 0;
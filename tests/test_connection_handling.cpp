@@ -11,6 +11,10 @@
 
 #include "iec104.h"
 #include "iec104_client_config.h"
+#include "iec104_tls_cache.h"
+#include "iec104_reconnect_backoff.h"
+#include "iec104_path_health.h"
+#include "iec104_window_tuner.h"
 
 using namespace std;
 
@@ -821,5 +825,492 @@ TEST_F(ConnectionHandlingTest, SingleConnectionTLS)
     TLSConfiguration_destroy(tlsConfig);
 }
 
+TEST_F(ConnectionHandlingTest, SingleConnectionTLSReconnect)
+{
+    openConnections = 0;
+    activations = 0;
+    deactivations = 0;
+
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    iec104->setJsonConfig(protocol_config_4, exchanged_data, tls_config_2);
+
+    setenv("FLEDGE_DATA", "./data", 1);
+
+    TLSConfiguration tlsConfig = TLSConfiguration_create();
+
+    TLSConfiguration_addCACertificateFromFile(tlsConfig, "data/etc/certs/iec104_ca.cer");
+    TLSConfiguration_setOwnCertificateFromFile(tlsConfig, "data/etc/certs/iec104_server.cer");
+    TLSConfiguration_setOwnKeyFromFile(tlsConfig, "data/etc/certs/iec104_server.key", NULL);
+    TLSConfiguration_addAllowedCertificateFromFile(tlsConfig, "data/etc/certs/iec104_client.cer");
+    TLSConfiguration_setChainValidation(tlsConfig, true);
+    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig, true);
+
+    CS104_Slave slave = CS104_Slave_createSecure(10, 10, tlsConfig);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setConnectionEventHandler(slave, connectionEventHandler, this);
+
+    CS104_Slave_start(slave);
+
+    iec104->start();
+
+    Thread_sleep(2000);
+
+    ASSERT_EQ(1, openConnections);
+    ASSERT_EQ(1, activations);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+
+    Thread_sleep(500);
+
+    openConnections = 0;
+    activations = 0;
+
+    // the TLS files did not change: the reconnection reuses the TLS configuration of the first connection
+    slave = CS104_Slave_createSecure(10, 10, tlsConfig);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setConnectionEventHandler(slave, connectionEventHandler, this);
+
+    CS104_Slave_start(slave);
+
+    Thread_sleep(3000);
+
+    ASSERT_EQ(1, openConnections);
+    ASSERT_EQ(1, activations);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+
+    TLSConfiguration_destroy(tlsConfig);
+}
+
+TEST_F(ConnectionHandlingTest, ReconnectWithBackoff)
+{
+    openConnections = 0;
+    activations = 0;
+    deactivations = 0;
+
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    // retries after 0, 500, 1000, 1000, ... ms
+    string reconnectConfig = protocol_config_4;
+    reconnectConfig.replace(reconnectConfig.find("\"tls\" : true"), strlen("\"tls\" : true"), "\"tls\" : false");
+    reconnectConfig.replace(reconnectConfig.find("\"k_value\""), 0,
+                            "\"reconnect_delay\" : 500, \"reconnect_max_delay\" : 1000, \"reconnect_jitter\" : 0, ");
+
+    iec104->setJsonConfig(reconnectConfig, exchanged_data, tls_config);
+
+    iec104->start();
+
+    // outstation not started yet: the connection keeps retrying
+    Thread_sleep(2500);
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setConnectionEventHandler(slave, connectionEventHandler, this);
+
+    CS104_Slave_start(slave);
+
+    // connected by a retry within the maximum delay
+    Thread_sleep(1500);
+
+    ASSERT_EQ(1, openConnections);
+    ASSERT_EQ(1, activations);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ConnectionHandlingTest, PathReportRtt)
+{
+    openConnections = 0;
+    activations = 0;
+    deactivations = 0;
+
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    // TESTFR sent every second on both paths
+    string pathConfig = protocol_config;
+    pathConfig.replace(pathConfig.find("\"redundancy_groups\""), 0,
+                       "\"path_selection\" : { \"mode\" : \"rtt\", \"switchover\" : true }, ");
+    pathConfig.replace(pathConfig.find("\"t3_timeout\" : 20"), strlen("\"t3_timeout\" : 20"), "\"t3_timeout\" : 1");
+    pathConfig.replace(pathConfig.find("\"application_layer\""), 0, "\"south_monitoring\" : { \"asset\" : \"CONSTAT-1\" }, ");
+
+    iec104->setJsonConfig(pathConfig, exchanged_data, tls_config);
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setConnectionEventHandler(slave, connectionEventHandler, this);
+
+    CS104_Slave_start(slave);
+
+    iec104->start();
+
+    Thread_sleep(3000);
+
+    ASSERT_EQ(2, openConnections);
+    ASSERT_EQ(1, activations);
+
+    ASSERT_TRUE(iec104->operation("request_path_report", 0, nullptr));
 
+    ASSERT_FALSE(storedReadings.empty());
+    ASSERT_TRUE(hasObject(*storedReadings.back(), "path_report"));
 
+    Datapoint* pathReport = getObject(*storedReadings.back(), "path_report");
+
+    Datapoint* pathA = getChild(*pathReport, "red-group1-A");
+    ASSERT_NE(nullptr, pathA);
+
+    Datapoint* pathB = getChild(*pathReport, "red-group1-B");
+    ASSERT_NE(nullptr, pathB);
+
+    // one path active, the other one connected as backup
+    ASSERT_NE(getStrValue(getChild(*pathA, "state")), getStrValue(getChild(*pathB, "state")));
+
+    // RTT measured with the TESTFR of the active path
+    Datapoint* activePath = (getStrValue(getChild(*pathA, "state")) == "active") ? pathA : pathB;
+
+    ASSERT_LE(1, getIntValue(getChild(*activePath, "rtt_samples")));
+    ASSERT_EQ(0, getIntValue(getChild(*activePath, "probes_lost")));
+    ASSERT_EQ(0, getIntValue(getChild(*activePath, "frame_errors")));
+    ASSERT_LE(0, getIntValue(getChild(*activePath, "cost")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ConnectionHandlingTest, ApciAutoTune)
+{
+    openConnections = 0;
+    activations = 0;
+    deactivations = 0;
+
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    // TESTFR sent after one second without traffic, w tuned up to 6 and t2 down to 2
+    string autoTuneConfig = protocol_config_4;
+    autoTuneConfig.replace(autoTuneConfig.find("\"tls\" : true"), strlen("\"tls\" : true"), "\"tls\" : false");
+    autoTuneConfig.replace(autoTuneConfig.find("\"t3_timeout\" : 20"), strlen("\"t3_timeout\" : 20"), "\"t3_timeout\" : 1");
+    autoTuneConfig.replace(autoTuneConfig.find("\"k_value\""), 0,
+                           "\"apci_auto_tune\" : { \"enabled\" : true, \"w_max\" : 6, \"t2_min\" : 2 }, ");
+    autoTuneConfig.replace(autoTuneConfig.find("\"application_layer\""), 0, "\"south_monitoring\" : { \"asset\" : \"CONSTAT-1\" }, ");
+
+    iec104->setJsonConfig(autoTuneConfig, exchanged_data, tls_config);
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setConnectionEventHandler(slave, connectionEventHandler, this);
+
+    CS104_Slave_start(slave);
+
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    iec104->start();
+
+    // RTT measured with the TESTFR of the idle connection
+    Thread_sleep(2500);
+
+    ASSERT_EQ(1, activations);
+
+    // about 20 I-frames per second until the first tuning
+    for (int i = 0; i < 180; i++) {
+        CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 41025, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueNormalized_create(NULL, 4202832, 0.5f, IEC60870_QUALITY_GOOD);
+
+        CS101_ASDU_addInformationObject(newAsdu, io);
+
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, newAsdu);
+
+        CS101_ASDU_destroy(newAsdu);
+
+        Thread_sleep(50);
+    }
+
+    Thread_sleep(1500);
+
+    ASSERT_TRUE(iec104->operation("request_path_report", 0, nullptr));
+
+    ASSERT_FALSE(storedReadings.empty());
+    ASSERT_TRUE(hasObject(*storedReadings.back(), "path_report"));
+
+    Datapoint* pathReport = getObject(*storedReadings.back(), "path_report");
+
+    Datapoint* path = getChild(*pathReport, "red-group1-A");
+    ASSERT_NE(nullptr, path);
+
+    ASSERT_LE(1, getIntValue(getChild(*path, "rtt_samples")));
+    ASSERT_LE(180, getIntValue(getChild(*path, "rx_frames")));
+
+    // the running connection keeps its parameters, the tuned ones are used by the next connection
+    ASSERT_EQ(12, getIntValue(getChild(*path, "k")));
+    ASSERT_EQ(8, getIntValue(getChild(*path, "w")));
+    ASSERT_EQ(10, getIntValue(getChild(*path, "t2")));
+
+    ASSERT_EQ(12, getIntValue(getChild(*path, "next_k")));
+    ASSERT_EQ(6, getIntValue(getChild(*path, "next_w")));
+    ASSERT_EQ(2, getIntValue(getChild(*path, "next_t2")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST(IEC104TlsCache, ReuseWhileFilesUnchanged)
+{
+    std::string certFile = "/tmp/iec104_tls_cache_test.pem";
+    std::remove(certFile.c_str());
+
+    ASSERT_EQ("", IEC104TlsCache::fingerprint(certFile));
+
+    FILE* file = fopen(certFile.c_str(), "w");
+    ASSERT_NE(nullptr, file);
+    fputs("certificate", file);
+    fclose(file);
+
+    ASSERT_NE("", IEC104TlsCache::fingerprint(certFile));
+
+    IEC104TlsCache tlsCache;
+    std::vector<std::string> files = {certFile, ""};
+
+    ASSERT_EQ(nullptr, tlsCache.get(files));
+
+    TLSConfiguration tlsConfig = TLSConfiguration_create();
+    tlsCache.set(tlsConfig, files);
+
+    /* files unchanged */
+    ASSERT_EQ(tlsConfig, tlsCache.get(files));
+    ASSERT_EQ(tlsConfig, tlsCache.get(files));
+    ASSERT_EQ(nullptr, tlsCache.get({certFile}));
+    ASSERT_EQ(2, tlsCache.Hits());
+    ASSERT_EQ(1, tlsCache.Loads());
+
+    /* file modified */
+    file = fopen(certFile.c_str(), "a");
+    ASSERT_NE(nullptr, file);
+    fputs(" renewed", file);
+    fclose(file);
+
+    ASSERT_EQ(nullptr, tlsCache.get(files));
+
+    tlsCache.set(TLSConfiguration_create(), files);
+    ASSERT_NE(nullptr, tlsCache.get(files));
+
+    tlsCache.clear();
+    ASSERT_EQ(nullptr, tlsCache.get(files));
+
+    std::remove(certFile.c_str());
+}
+
+TEST(IEC104ReconnectBackoff, DoubledUpToMaxDelay)
+{
+    IEC104ReconnectBackoff backoff(1000, 5000, 0);
+
+    // first retry immediate, then doubled up to the maximum delay
+    ASSERT_EQ(0, backoff.nextDelay());
+    ASSERT_EQ(1000, backoff.nextDelay());
+    ASSERT_EQ(2000, backoff.nextDelay());
+    ASSERT_EQ(4000, backoff.nextDelay());
+    ASSERT_EQ(5000, backoff.nextDelay());
+    ASSERT_EQ(5000, backoff.nextDelay());
+    ASSERT_EQ(6, backoff.Failures());
+
+    backoff.reset();
+
+    ASSERT_EQ(0, backoff.Failures());
+    ASSERT_EQ(0, backoff.nextDelay());
+}
+
+TEST(IEC104ReconnectBackoff, Jitter)
+{
+    IEC104ReconnectBackoff backoff(1000, 1000, 20);
+
+    ASSERT_EQ(0, backoff.nextDelay());
+
+    for (int i = 0; i < 100; i++) {
+        uint64_t delay = backoff.nextDelay();
+
+        ASSERT_GE(delay, 800);
+        ASSERT_LE(delay, 1200);
+    }
+}
+
+TEST(IEC104PathHealth, TestfrRoundTrip)
+{
+    IEC104PathHealth pathHealth;
+
+    ASSERT_EQ(-1, pathHealth.cost());
+
+    uint8_t testfrAct[] = {0x68, 0x04, 0x43, 0x00, 0x00, 0x00};
+    uint8_t testfrCon[] = {0x68, 0x04, 0x83, 0x00, 0x00, 0x00};
+    uint8_t startdtCon[] = {0x68, 0x04, 0x0b, 0x00, 0x00, 0x00};
+    uint8_t malformed[] = {0x68, 0x05, 0x83, 0x00, 0x00, 0x00};
+
+    // TESTFR round trip
+    pathHealth.frame(testfrAct, sizeof(testfrAct), true, 1000);
+    pathHealth.frame(startdtCon, sizeof(startdtCon), false, 1010);
+    pathHealth.frame(testfrCon, sizeof(testfrCon), false, 1080);
+
+    IEC104PathHealth::Metrics metrics = pathHealth.getMetrics();
+
+    ASSERT_EQ(1, metrics.rttSamples);
+    ASSERT_EQ(80, metrics.rtt);
+    ASSERT_EQ(80, metrics.srtt);
+    ASSERT_EQ(40, metrics.rttVar);
+    ASSERT_EQ(80 + 4 * 40 + 1, pathHealth.cost());
+
+    // smoothed
+    pathHealth.rttSample(160);
+
+    metrics = pathHealth.getMetrics();
+
+    ASSERT_EQ(90, metrics.srtt);
+    ASSERT_EQ(50, metrics.rttVar);
+    ASSERT_EQ(80, metrics.rttMin);
+
+    // TESTFR not confirmed, malformed frame
+    pathHealth.frame(testfrAct, sizeof(testfrAct), true, 2000);
+    pathHealth.connectionClosed();
+    pathHealth.frame(malformed, sizeof(malformed), false, 2000);
+
+    metrics = pathHealth.getMetrics();
+
+    ASSERT_EQ(2, metrics.probes);
+    ASSERT_EQ(1, metrics.probesLost);
+    ASSERT_EQ(3, metrics.frames);
+    ASSERT_EQ(1, metrics.frameErrors);
+    ASSERT_GT(metrics.errorRate, 0.0);
+    ASSERT_GT(pathHealth.cost(), 90 + 4 * 50 + 1);
+
+    pathHealth.connectionOpened();
+
+    ASSERT_EQ(-1, pathHealth.cost());
+}
+
+TEST(IEC104PathHealth, IsBetter)
+{
+    // measured path better than a not measured one, hysteresis
+    ASSERT_TRUE(IEC104PathHealth::isBetter(100, -1, 30));
+    ASSERT_FALSE(IEC104PathHealth::isBetter(-1, 100, 30));
+    ASSERT_FALSE(IEC104PathHealth::isBetter(80, 100, 30));
+    ASSERT_TRUE(IEC104PathHealth::isBetter(60, 100, 30));
+}
+
+TEST(IEC104WindowTuner, TuneFromRttAndFrameRate)
+{
+    IEC104WindowTuner windowTuner({12, 8, 10}, {1, 0, 1, 10, 24});
+
+    IEC104WindowTuner::Parameters parameters = windowTuner.connectionParameters();
+
+    ASSERT_EQ(12, parameters.k);
+    ASSERT_EQ(8, parameters.w);
+    ASSERT_EQ(10, parameters.t2);
+
+    ASSERT_FALSE(windowTuner.tune(1000, 500, parameters));
+
+    // 100 I-frames received in 10 s, acknowledged every 4 frames
+    for (int i = 0; i < 100; i++) {
+        uint8_t iFrame[] = {0x68, 0x04, static_cast<uint8_t>((i << 1) & 0xfe), static_cast<uint8_t>(i >> 7), 0x00, 0x00};
+
+        windowTuner.frame(iFrame, sizeof(iFrame), false);
+
+        if ((i % 4) == 3) {
+            uint8_t sFrame[] = {0x68, 0x04, 0x01, 0x00, static_cast<uint8_t>(((i + 1) << 1) & 0xfe), static_cast<uint8_t>((i + 1) >> 7)};
+
+            windowTuner.frame(sFrame, sizeof(sFrame), true);
+        }
+    }
+
+    // 5 frames received per RTT: w = k - 5 - 1, t2 = time to receive w frames
+    ASSERT_TRUE(windowTuner.tune(11000, 500, parameters));
+    ASSERT_EQ(12, parameters.k);
+    ASSERT_EQ(6, parameters.w);
+    ASSERT_EQ(1, parameters.t2);
+
+    // the current connection keeps its parameters
+    ASSERT_TRUE(windowTuner.isChangePending());
+
+    IEC104WindowTuner::Stats stats = windowTuner.getStats();
+
+    ASSERT_EQ(8, stats.parameters.w);
+    ASSERT_EQ(10, stats.parameters.t2);
+    ASSERT_EQ(6, stats.next.w);
+    ASSERT_EQ(1, stats.next.t2);
+
+    ASSERT_EQ(10.0, stats.rxRate);
+    ASSERT_EQ(100, stats.rxFrames);
+    ASSERT_EQ(25, stats.acksSent);
+    ASSERT_NEAR(100.0 * 2.5 / 12, stats.rxUtilization, 0.01);
+    ASSERT_NEAR(100.0 * 4 / 12, stats.rxUtilizationMax, 0.01);
+
+    // window of the client full: k doubled for the next connection
+    for (int i = 0; i < 12; i++) {
+        uint8_t iFrame[] = {0x68, 0x04, static_cast<uint8_t>((i << 1) & 0xfe), 0x00, 0x00, 0x00};
+
+        windowTuner.frame(iFrame, sizeof(iFrame), true);
+    }
+
+    ASSERT_FALSE(windowTuner.tune(21000, 500, parameters));
+    ASSERT_TRUE(windowTuner.isChangePending());
+
+    stats = windowTuner.getStats();
+
+    ASSERT_EQ(12, stats.txFrames);
+    ASSERT_EQ(1, stats.txWindowFull);
+    ASSERT_EQ(12, stats.parameters.k);
+    ASSERT_EQ(24, stats.next.k);
+    ASSERT_NEAR(100.0 * 6.5 / 12, stats.txUtilization, 0.01);
+    ASSERT_NEAR(100.0, stats.txUtilizationMax, 0.01);
+
+    // tuned parameters applied by the next connection
+    parameters = windowTuner.connectionParameters();
+
+    ASSERT_EQ(24, parameters.k);
+    ASSERT_EQ(6, parameters.w);
+    ASSERT_EQ(1, parameters.t2);
+    ASSERT_FALSE(windowTuner.isChangePending());
+}
@@ -12,7 +12,11 @@
 #include <lib60870/hal_thread.h>
 
 #include "iec104.h"
+#include "iec104_client.h"
 #include "iec104_client_config.h"
+#include "iec104_token_bucket.h"
+#include "iec104_command_latency.h"
+#include "iec104_command_queue.h"
 
 using namespace std;
 
@@ -2090,3 +2094,684 @@ TEST_F(ControlCommandsTest, IEC104Client_sendBrokenCommands2)
     CS104_Slave_destroy(slave);
 }
 
+
+TEST_F(ControlCommandsTest, IEC104Client_sendCommandBatch)
+{
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(15, 15);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(500);
+
+    // three single commands and one command not in the exchange configuration
+    PLUGIN_PARAMETER* params[36] = {};
+
+    PLUGIN_PARAMETER type = {"type", "C_SC_NA_1"};
+    PLUGIN_PARAMETER ca = {"ca", "41025"};
+    PLUGIN_PARAMETER ioa = {"ioa", "2000"};
+    PLUGIN_PARAMETER unknownIoa = {"ioa", "2999"};
+    PLUGIN_PARAMETER value = {"", "1"};
+    PLUGIN_PARAMETER select = {"", "0"};
+
+    for (int i = 0; i < 4; i++) {
+        params[i * 9 + 0] = &type;
+        params[i * 9 + 1] = &ca;
+        params[i * 9 + 2] = (i == 2) ? &unknownIoa : &ioa;
+        params[i * 9 + 5] = &select;
+        params[i * 9 + 8] = &value;
+    }
+
+    // quality update for measurement data points
+    ASSERT_EQ(3, ingestCallbackCalled);
+
+    // the number of parameters is not a multiple of 9
+    ASSERT_FALSE(iec104->operation("IEC104CommandBatch", 10, params));
+
+    bool operationResult = iec104->operation("IEC104CommandBatch", 36, params);
+
+    ASSERT_TRUE(operationResult);
+
+    Thread_sleep(500);
+
+    // cmd_parallel = 1: the other commands wait for the ACT-TERM of the first one
+    ASSERT_EQ(1, asduHandlerCalled);
+    ASSERT_EQ(2, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_NE(nullptr, lastConnection);
+
+        CS101_ASDU ctAsdu = CS101_ASDU_create(IMasterConnection_getApplicationLayerParameters(lastConnection),
+            false, CS101_COT_ACTIVATION_TERMINATION,lastOA, 41025, false, false);
+
+        InformationObject io = (InformationObject)SingleCommand_create(NULL, 2000, true, false, 0);
+
+        CS101_ASDU_addInformationObject(ctAsdu, io);
+
+        IMasterConnection_sendASDU(lastConnection, ctAsdu);
+
+        InformationObject_destroy(io);
+
+        CS101_ASDU_destroy(ctAsdu);
+
+        Thread_sleep(500);
+
+        // the ACT-TERM releases the next queued command
+        ASSERT_EQ((i < 2) ? i + 2 : 3, asduHandlerCalled);
+    }
+
+    ASSERT_EQ(0, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    // ACT-CON and ACT-TERM of the three commands
+    ASSERT_EQ(3 + 6, ingestCallbackCalled);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ControlCommandsTest, IEC104Client_sendQueuedCommand)
+{
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(15, 15);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(500);
+
+    PLUGIN_PARAMETER* params[10] = {};
+
+    PLUGIN_PARAMETER type = {"type", "C_SC_NA_1"};
+    params[0] = &type;
+
+    PLUGIN_PARAMETER ca = {"ca", "41025"};
+    params[1] = &ca;
+
+    // ioa
+    PLUGIN_PARAMETER ioa = {"ioa", "2000"};
+    params[2] = &ioa;
+
+    // Third value
+    PLUGIN_PARAMETER value = {"", "1"};
+    params[8] = &value;
+
+    // Third value
+    PLUGIN_PARAMETER select = {"", "0"};
+    params[5] = &select;
+
+    PLUGIN_PARAMETER priority = {"priority", "protection"};
+    params[9] = &priority;
+
+    // quality update for measurement data points
+    ASSERT_EQ(3, ingestCallbackCalled);
+
+    ASSERT_TRUE(iec104->operation("IEC104Command", 9, params));
+
+    // cmd_parallel = 1: the second command is queued until the ACT-TERM of the first one
+    ASSERT_TRUE(iec104->operation("IEC104Command", 10, params));
+
+    Thread_sleep(500);
+
+    ASSERT_EQ(1, asduHandlerCalled);
+    ASSERT_EQ(1, static_cast<int>(iec104->getClient()->CommandQueue().Size(IEC104CommandQueue::Priority::PROTECTION)));
+
+    CS101_ASDU ctAsdu = CS101_ASDU_create(IMasterConnection_getApplicationLayerParameters(lastConnection),
+        false, CS101_COT_ACTIVATION_TERMINATION,lastOA, 41025, false, false);
+
+    InformationObject io = (InformationObject)SingleCommand_create(NULL, 2000, true, false, 0);
+
+    CS101_ASDU_addInformationObject(ctAsdu, io);
+
+    IMasterConnection_sendASDU(lastConnection, ctAsdu);
+
+    InformationObject_destroy(io);
+
+    CS101_ASDU_destroy(ctAsdu);
+
+    Thread_sleep(500);
+
+    ASSERT_EQ(2, asduHandlerCalled);
+    ASSERT_EQ(0, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ControlCommandsTest, IEC104Client_sendSelectBeforeOperate)
+{
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(15, 15);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(500);
+
+    PLUGIN_PARAMETER* params[9] = {};
+
+    PLUGIN_PARAMETER type = {"type", "C_SC_NA_1"};
+    params[0] = &type;
+
+    PLUGIN_PARAMETER ca = {"ca", "41025"};
+    params[1] = &ca;
+
+    // ioa
+    PLUGIN_PARAMETER ioa = {"ioa", "2000"};
+    params[2] = &ioa;
+
+    // Third value
+    PLUGIN_PARAMETER value = {"", "1"};
+    params[8] = &value;
+
+    // ignored, the select and the execute are sent by the plugin
+    PLUGIN_PARAMETER select = {"", "0"};
+    params[5] = &select;
+
+    // quality update for measurement data points
+    ASSERT_EQ(3, ingestCallbackCalled);
+
+    ASSERT_FALSE(iec104->operation("IEC104CommandSBO", 8, params));
+
+    // set points cannot be selected
+    PLUGIN_PARAMETER setpointType = {"type", "C_SE_NC_1"};
+    params[0] = &setpointType;
+
+    ASSERT_FALSE(iec104->operation("IEC104CommandSBO", 9, params));
+
+    // command with time tag but no time
+    PLUGIN_PARAMETER timeType = {"type", "C_SC_TA_1"};
+    params[0] = &timeType;
+
+    ASSERT_FALSE(iec104->operation("IEC104CommandSBO", 9, params));
+
+    params[0] = &type;
+
+    // missing ca
+    params[1] = nullptr;
+
+    ASSERT_FALSE(iec104->operation("IEC104CommandSBO", 9, params));
+
+    params[1] = &ca;
+
+    ASSERT_TRUE(iec104->operation("IEC104CommandSBO", 9, params));
+
+    Thread_sleep(500);
+
+    // the positive ACT-CON of the select triggers the execute
+    ASSERT_EQ(2, asduHandlerCalled);
+
+    // ACT-CON of the select and of the execute
+    ASSERT_EQ(3 + 2, ingestCallbackCalled);
+
+    CS101_ASDU ctAsdu = CS101_ASDU_create(IMasterConnection_getApplicationLayerParameters(lastConnection),
+        false, CS101_COT_ACTIVATION_TERMINATION,lastOA, 41025, false, false);
+
+    InformationObject io = (InformationObject)SingleCommand_create(NULL, 2000, true, false, 0);
+
+    CS101_ASDU_addInformationObject(ctAsdu, io);
+
+    IMasterConnection_sendASDU(lastConnection, ctAsdu);
+
+    InformationObject_destroy(io);
+
+    CS101_ASDU_destroy(ctAsdu);
+
+    Thread_sleep(500);
+
+    // the ACT-TERM of the execute frees the slot: a new command is sent directly
+    ASSERT_TRUE(iec104->operation("IEC104Command", 9, params));
+
+    Thread_sleep(500);
+
+    ASSERT_EQ(3, asduHandlerCalled);
+    ASSERT_EQ(0, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ControlCommandsTest, IEC104Client_sendPacedCommands)
+{
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    // one command per second, no limit of parallel commands
+    string pacingConfig = protocol_config;
+    pacingConfig.replace(pacingConfig.find("\"k_value\""), 0, "\"cmd_rate\" : 1, \"cmd_burst\" : 1, ");
+    pacingConfig.replace(pacingConfig.find("\"cmd_parallel\" : 1"), strlen("\"cmd_parallel\" : 1"), "\"cmd_parallel\" : 0");
+    pacingConfig.replace(pacingConfig.find("\"application_layer\""), 0, "\"south_monitoring\" : { \"asset\" : \"CONSTAT-1\" }, ");
+
+    iec104->setJsonConfig(pacingConfig, exchanged_data, tls_config);
+
+    CS104_Slave slave = CS104_Slave_create(15, 15);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(500);
+
+    PLUGIN_PARAMETER* params[9] = {};
+
+    PLUGIN_PARAMETER type = {"type", "C_SC_NA_1"};
+    params[0] = &type;
+
+    PLUGIN_PARAMETER ca = {"ca", "41025"};
+    params[1] = &ca;
+
+    // ioa
+    PLUGIN_PARAMETER ioa = {"ioa", "2000"};
+    params[2] = &ioa;
+
+    // Third value
+    PLUGIN_PARAMETER value = {"", "1"};
+    params[8] = &value;
+
+    // Third value
+    PLUGIN_PARAMETER select = {"", "0"};
+    params[5] = &select;
+
+    ASSERT_TRUE(iec104->operation("IEC104Command", 9, params));
+
+    // no token left: the second command waits in the queue
+    ASSERT_TRUE(iec104->operation("IEC104Command", 9, params));
+
+    Thread_sleep(300);
+
+    ASSERT_EQ(1, asduHandlerCalled);
+    ASSERT_EQ(1, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    // sent with the next token
+    Thread_sleep(1200);
+
+    ASSERT_EQ(2, asduHandlerCalled);
+    ASSERT_EQ(0, static_cast<int>(iec104->getClient()->CommandQueue().Size()));
+
+    ASSERT_TRUE(iec104->operation("request_command_report", 0, nullptr));
+
+    ASSERT_FALSE(storedReadings.empty());
+    ASSERT_TRUE(hasObject(*storedReadings.back(), "command_report"));
+
+    Datapoint* commandReport = getObject(*storedReadings.back(), "command_report");
+
+    ASSERT_EQ(1, getIntValue(getChild(*commandReport, "pacing_rate")));
+    ASSERT_EQ(1, getIntValue(getChild(*commandReport, "pacing_burst")));
+    // released from the queue
+    ASSERT_EQ(1, getIntValue(getChild(*commandReport, "sent")));
+    ASSERT_LE(1, getIntValue(getChild(*commandReport, "pacing_refused")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(ControlCommandsTest, IEC104Client_commandLatencyReport)
+{
+    asduHandlerCalled = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    string reportConfig = protocol_config;
+    reportConfig.replace(reportConfig.find("\"application_layer\""), 0, "\"south_monitoring\" : { \"asset\" : \"CONSTAT-1\" }, ");
+
+    iec104->setJsonConfig(reportConfig, exchanged_data, tls_config);
+
+    CS104_Slave slave = CS104_Slave_create(15, 15);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(500);
+
+    PLUGIN_PARAMETER* params[9] = {};
+
+    PLUGIN_PARAMETER type = {"type", "C_SC_NA_1"};
+    params[0] = &type;
+
+    PLUGIN_PARAMETER ca = {"ca", "41025"};
+    params[1] = &ca;
+
+    // ioa
+    PLUGIN_PARAMETER ioa = {"ioa", "2000"};
+    params[2] = &ioa;
+
+    // Third value
+    PLUGIN_PARAMETER value = {"", "1"};
+    params[8] = &value;
+
+    // Third value
+    PLUGIN_PARAMETER select = {"", "0"};
+    params[5] = &select;
+
+    ASSERT_TRUE(iec104->operation("IEC104Command", 9, params));
+
+    Thread_sleep(500);
+
+    ASSERT_EQ(1, asduHandlerCalled);
+
+    CS101_ASDU ctAsdu = CS101_ASDU_create(IMasterConnection_getApplicationLayerParameters(lastConnection),
+        false, CS101_COT_ACTIVATION_TERMINATION,lastOA, 41025, false, false);
+
+    InformationObject io = (InformationObject)SingleCommand_create(NULL, 2000, true, false, 0);
+
+    CS101_ASDU_addInformationObject(ctAsdu, io);
+
+    IMasterConnection_sendASDU(lastConnection, ctAsdu);
+
+    InformationObject_destroy(io);
+
+    CS101_ASDU_destroy(ctAsdu);
+
+    Thread_sleep(500);
+
+    ASSERT_TRUE(iec104->operation("request_command_report", 0, nullptr));
+
+    ASSERT_FALSE(storedReadings.empty());
+    ASSERT_TRUE(hasObject(*storedReadings.back(), "command_report"));
+
+    Datapoint* commandReport = getObject(*storedReadings.back(), "command_report");
+
+    // ACT-CON and ACT-TERM latencies of the command, by type and by CA
+    Datapoint* latencyByType = getChild(*commandReport, "latency_by_type");
+    ASSERT_NE(nullptr, latencyByType);
+
+    Datapoint* singleCommand = getChild(*latencyByType, "C_SC_NA_1");
+    ASSERT_NE(nullptr, singleCommand);
+
+    ASSERT_EQ(1, getIntValue(getChild(*getChild(*singleCommand, "act_con"), "count")));
+    ASSERT_EQ(1, getIntValue(getChild(*getChild(*singleCommand, "act_term"), "count")));
+    ASSERT_EQ(0, getIntValue(getChild(*singleCommand, "timeouts")));
+
+    Datapoint* latencyByCa = getChild(*commandReport, "latency_by_ca");
+    ASSERT_NE(nullptr, latencyByCa);
+
+    Datapoint* station = getChild(*latencyByCa, "41025");
+    ASSERT_NE(nullptr, station);
+
+    ASSERT_EQ(1, getIntValue(getChild(*getChild(*station, "act_con"), "count")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST(IEC104TokenBucket, NoPacing)
+{
+    IEC104TokenBucket bucket(0, 1);
+
+    ASSERT_TRUE(bucket.take(1000));
+    ASSERT_TRUE(bucket.take(1000));
+
+    IEC104TokenBucket::State state = bucket.getState(1000);
+
+    ASSERT_EQ(2, state.taken);
+    ASSERT_EQ(0, state.refused);
+}
+
+TEST(IEC104TokenBucket, RateAndBurst)
+{
+    IEC104TokenBucket bucket(5, 2);
+
+    // burst
+    ASSERT_TRUE(bucket.take(1000));
+    ASSERT_TRUE(bucket.take(1000));
+    ASSERT_FALSE(bucket.take(1000));
+
+    // one token every 200 ms
+    ASSERT_FALSE(bucket.take(1199));
+    ASSERT_TRUE(bucket.take(1200));
+    ASSERT_FALSE(bucket.take(1200));
+
+    // never more than burst tokens
+    IEC104TokenBucket::State state = bucket.getState(60000);
+
+    ASSERT_EQ(2, state.tokens);
+    ASSERT_EQ(3, state.taken);
+    ASSERT_EQ(3, state.refused);
+}
+
+TEST(IEC104TokenBucket, Refund)
+{
+    IEC104TokenBucket bucket(1, 2);
+
+    ASSERT_TRUE(bucket.take(1000));
+    ASSERT_TRUE(bucket.take(1000));
+    ASSERT_FALSE(bucket.take(1000));
+
+    // token of a command not sent given back
+    bucket.refund();
+
+    ASSERT_TRUE(bucket.take(1000));
+
+    // never more than burst tokens
+    bucket.refund();
+    bucket.refund();
+    bucket.refund();
+
+    IEC104TokenBucket::State state = bucket.getState(1000);
+
+    ASSERT_EQ(2, state.tokens);
+    ASSERT_EQ(0, state.taken);
+    ASSERT_EQ(1, state.refused);
+}
+
+TEST(IEC104CommandLatency, Histograms)
+{
+    ASSERT_EQ("le_10", IEC104CommandLatency::bucketName(0));
+    ASSERT_EQ("le_10000", IEC104CommandLatency::bucketName(IEC104CommandLatency::BUCKETS - 2));
+    ASSERT_EQ("gt_10000", IEC104CommandLatency::bucketName(IEC104CommandLatency::BUCKETS - 1));
+
+    IEC104CommandLatency commandLatency;
+
+    commandLatency.record(C_SC_NA_1, 41025, 10, 150, false);
+    commandLatency.record(C_SC_NA_1, 41025, 11, -1, true);
+    commandLatency.record(C_SE_NC_1, 41026, 20000, -1, false);
+    commandLatency.record(C_SE_NC_1, 41025, -1, -1, true);
+
+    std::map<int, IEC104CommandLatency::Latencies> byType = commandLatency.byType();
+
+    ASSERT_EQ(2, byType.size());
+
+    IEC104CommandLatency::Latencies& singleCommand = byType[C_SC_NA_1];
+
+    ASSERT_EQ(2, singleCommand.actCon.count);
+    ASSERT_EQ(1, singleCommand.actCon.counts[0]);
+    ASSERT_EQ(1, singleCommand.actCon.counts[1]);
+    ASSERT_EQ(21, singleCommand.actCon.total);
+    ASSERT_EQ(11, singleCommand.actCon.max);
+    ASSERT_EQ(1, singleCommand.actTerm.count);
+    ASSERT_EQ(1, singleCommand.actTerm.counts[4]);
+    ASSERT_EQ(1, singleCommand.timeouts);
+
+    IEC104CommandLatency::Latencies& setpoint = byType[C_SE_NC_1];
+
+    ASSERT_EQ(1, setpoint.actCon.count);
+    ASSERT_EQ(1, setpoint.actCon.counts[IEC104CommandLatency::BUCKETS - 1]);
+    ASSERT_EQ(0, setpoint.actTerm.count);
+    ASSERT_EQ(1, setpoint.timeouts);
+
+    std::map<int, IEC104CommandLatency::Latencies> byCa = commandLatency.byCa();
+
+    ASSERT_EQ(2, byCa.size());
+    ASSERT_EQ(2, byCa[41025].actCon.count);
+    ASSERT_EQ(2, byCa[41025].timeouts);
+    ASSERT_EQ(1, byCa[41026].actCon.count);
+
+    commandLatency.clear();
+
+    ASSERT_EQ(0, commandLatency.byType().size());
+}
+
+TEST(IEC104CommandQueue, PriorityFromString)
+{
+    IEC104CommandQueue::Priority priority = IEC104CommandQueue::Priority::OPERATOR;
+
+    ASSERT_TRUE(IEC104CommandQueue::priorityFromString("protection", priority));
+    ASSERT_TRUE(IEC104CommandQueue::Priority::PROTECTION == priority);
+    ASSERT_FALSE(IEC104CommandQueue::priorityFromString("urgent", priority));
+}
+
+TEST(IEC104CommandQueue, PriorityAndDeadline)
+{
+    IEC104CommandQueue commandQueue;
+    IEC104CommandQueue::Command command;
+    std::vector<IEC104CommandQueue::Command> dropped;
+    std::vector<IEC104CommandQueue::Command> expired;
+
+    command.priority = IEC104CommandQueue::Priority::BULK;
+    command.ioa = 1;
+    ASSERT_TRUE(commandQueue.push(command, 3, dropped));
+    command.ioa = 2;
+    ASSERT_TRUE(commandQueue.push(command, 3, dropped));
+
+    command.priority = IEC104CommandQueue::Priority::OPERATOR;
+    command.ioa = 3;
+    command.deadline = 5000;
+    ASSERT_TRUE(commandQueue.push(command, 3, dropped));
+
+    // queue full: a protection command replaces the last bulk command
+    command.priority = IEC104CommandQueue::Priority::PROTECTION;
+    command.ioa = 4;
+    command.deadline = 0;
+    ASSERT_TRUE(commandQueue.push(command, 3, dropped));
+    ASSERT_EQ(1, dropped.size());
+    ASSERT_EQ(2, dropped[0].ioa);
+
+    // queue full of commands of the same or a higher class
+    command.priority = IEC104CommandQueue::Priority::BULK;
+    command.ioa = 5;
+    ASSERT_FALSE(commandQueue.push(command, 3, dropped));
+    ASSERT_EQ(3, commandQueue.Size());
+
+    commandQueue.expire(4000, expired);
+    ASSERT_EQ(0, expired.size());
+
+    // released by class
+    ASSERT_TRUE(commandQueue.pop(command));
+    ASSERT_EQ(4, command.ioa);
+
+    commandQueue.expire(5000, expired);
+    ASSERT_EQ(1, expired.size());
+    ASSERT_EQ(3, expired[0].ioa);
+
+    ASSERT_TRUE(commandQueue.pop(command));
+    ASSERT_EQ(1, command.ioa);
+
+    // not sent, first of its class at the next try
+    commandQueue.pushFront(command);
+    ASSERT_EQ(1, commandQueue.Size(IEC104CommandQueue::Priority::BULK));
+    ASSERT_TRUE(commandQueue.pop(command));
+    ASSERT_FALSE(commandQueue.pop(command));
+
+    IEC104CommandQueue::Counters counters = commandQueue.getCounters();
+
+    ASSERT_EQ(4, counters.queued);
+    ASSERT_EQ(1, counters.dropped);
+    ASSERT_EQ(1, counters.rejected);
+    ASSERT_EQ(1, counters.expired);
+}
+
+TEST(IEC104CommandQueue, CoalesceSetpoints)
+{
+    IEC104CommandQueue commandQueue;
+    IEC104CommandQueue::Command command;
+    IEC104CommandQueue::Command superseded;
+    std::vector<IEC104CommandQueue::Command> dropped;
+
+    command.typeId = C_SE_NC_1;
+    command.ca = 41025;
+    command.ioa = 2001;
+    command.value = 1.0;
+    ASSERT_FALSE(commandQueue.replace(command, superseded));
+    ASSERT_TRUE(commandQueue.push(command, 10, dropped));
+
+    command.ioa = 2002;
+    ASSERT_TRUE(commandQueue.push(command, 10, dropped));
+
+    // same address: the queued value is replaced in place
+    command.ioa = 2001;
+    command.value = 2.0;
+    command.batchId = 3;
+    ASSERT_TRUE(commandQueue.replace(command, superseded));
+    ASSERT_EQ(1.0, superseded.value);
+    ASSERT_EQ(0, superseded.batchId);
+    ASSERT_EQ(2, commandQueue.Size());
+
+    // other type: not replaced
+    command.typeId = C_SE_NA_1;
+    ASSERT_FALSE(commandQueue.replace(command, superseded));
+
+    // higher priority: moved to its class
+    command.typeId = C_SE_NC_1;
+    command.ioa = 2002;
+    command.priority = IEC104CommandQueue::Priority::PROTECTION;
+    ASSERT_TRUE(commandQueue.replace(command, superseded));
+    ASSERT_EQ(1, commandQueue.Size(IEC104CommandQueue::Priority::PROTECTION));
+    ASSERT_EQ(1, commandQueue.Size(IEC104CommandQueue::Priority::OPERATOR));
+    ASSERT_EQ(2, commandQueue.Size());
+
+    ASSERT_TRUE(commandQueue.pop(command));
+    ASSERT_EQ(2002, command.ioa);
+    ASSERT_TRUE(commandQueue.pop(command));
+    ASSERT_EQ(2001, command.ioa);
+    ASSERT_EQ(2.0, command.value);
+    ASSERT_EQ(3, command.batchId);
+
+    IEC104CommandQueue::Counters counters = commandQueue.getCounters();
+
+    ASSERT_EQ(2, counters.queued);
+    ASSERT_EQ(2, counters.superseded);
+}
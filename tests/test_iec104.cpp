@@ -12,6 +12,9 @@
 #include <lib60870/hal_thread.h>
 
 #include "iec104.h"
+#include "iec104_client_config.h"
+#include "iec104_point_freshness.h"
+#include "iec104_staleness_monitor.h"
 #include "conf_init.h"
 
 using namespace std;
@@ -1302,3 +1305,268 @@ TEST_F(IEC104Test, IEC104_receiveGI_M_ST_NA_1)
 
     CS104_Slave_destroy(slave);
 }
+
+static string exchanged_data_other_types = QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-BO-1",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"41025-4202870",
+                          "typeid":"M_BO_NA_1"
+                       }
+                    ]
+                },
+                {
+                    "label":"TM-IT-1",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"41025-4202871",
+                          "typeid":"M_IT_NA_1"
+                       }
+                    ]
+                }
+            ]
+        }
+    });
+
+TEST_F(IEC104Test, IEC104_receiveSpont_M_BO_NA_1)
+{
+    iec104->setJsonConfig(protocol_config, exchanged_data_other_types, tls_config);
+
+    ingestCallbackCalled = 0;
+    storedReading = nullptr;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_start(slave);
+
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    startIEC104();
+
+    CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 41025, false, false);
+
+    InformationObject io = (InformationObject) BitString32_createEx(NULL, 4202870, 0x12345678, IEC60870_QUALITY_BLOCKED);
+
+    CS101_ASDU_addInformationObject(newAsdu, io);
+
+    InformationObject_destroy(io);
+
+    /* Add ASDU to slave event queue */
+    CS104_Slave_enqueueASDU(slave, newAsdu);
+
+    CS101_ASDU_destroy(newAsdu);
+
+    Thread_sleep(500);
+
+    ASSERT_NE(nullptr, storedReading);
+    ASSERT_EQ("TM-BO-1", storedReading->getAssetName());
+    Datapoint* data_object = getObject(*storedReading, "data_object");
+    ASSERT_NE(nullptr, data_object);
+    ASSERT_FALSE(hasChild(*data_object, "do_ts"));
+
+    ASSERT_EQ("M_BO_NA_1", getStrValue(getChild(*data_object, "do_type")));
+    ASSERT_EQ((int64_t) 4202870, getIntValue(getChild(*data_object, "do_ioa")));
+    ASSERT_EQ((int64_t) 0x12345678, getIntValue(getChild(*data_object, "do_value")));
+    ASSERT_EQ((int64_t) 1, getIntValue(getChild(*data_object, "do_quality_bl")));
+    ASSERT_EQ((int64_t) 0, getIntValue(getChild(*data_object, "do_quality_iv")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+TEST_F(IEC104Test, IEC104_receiveSpont_M_IT_TB_1)
+{
+    iec104->setJsonConfig(protocol_config, exchanged_data_other_types, tls_config);
+
+    ingestCallbackCalled = 0;
+    storedReading = nullptr;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_start(slave);
+
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    startIEC104();
+
+    CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 41025, false, false);
+
+    struct sCP56Time2a ts;
+
+    uint64_t timestamp = Hal_getTimeInMs();
+
+    CP56Time2a_createFromMsTimestamp(&ts, timestamp);
+
+    struct sBinaryCounterReading bcr;
+
+    BinaryCounterReading_create(&bcr, 4711, 1, false, false, true);
+
+    InformationObject io = (InformationObject) IntegratedTotalsWithCP56Time2a_create(NULL, 4202871, &bcr, &ts);
+
+    CS101_ASDU_addInformationObject(newAsdu, io);
+
+    InformationObject_destroy(io);
+
+    /* Add ASDU to slave event queue */
+    CS104_Slave_enqueueASDU(slave, newAsdu);
+
+    CS101_ASDU_destroy(newAsdu);
+
+    Thread_sleep(500);
+
+    ASSERT_NE(nullptr, storedReading);
+    ASSERT_EQ("TM-IT-1", storedReading->getAssetName());
+    Datapoint* data_object = getObject(*storedReading, "data_object");
+    ASSERT_NE(nullptr, data_object);
+    ASSERT_TRUE(hasChild(*data_object, "do_ts"));
+
+    ASSERT_EQ("M_IT_TB_1", getStrValue(getChild(*data_object, "do_type")));
+    ASSERT_EQ((int64_t) 4202871, getIntValue(getChild(*data_object, "do_ioa")));
+    ASSERT_EQ((int64_t) 4711, getIntValue(getChild(*data_object, "do_value")));
+    ASSERT_EQ((int64_t) 1, getIntValue(getChild(*data_object, "do_quality_iv")));
+    ASSERT_EQ((int64_t) timestamp, getIntValue(getChild(*data_object, "do_ts")));
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+}
+
+static string protocol_config_max_age = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 30,
+                "gi_all_ca" : false,
+                "cmd_parallel" : 1,
+                "time_sync" : 0,
+                "max_age" : {
+                    "M_SP_NA_1" : 20,
+                    "C_SC_NA_1" : 5,
+                    "M_ME_NB_1" : -1,
+                    "M_XX" : 3
+                }
+            }
+        }
+    });
+
+TEST(IEC104StalenessMonitor, MaxAgeExceeded)
+{
+    IEC104ClientConfig config;
+
+    config.importProtocolConfig(protocol_config_max_age);
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "max_age":10}]
+                },
+                {
+                    "label":"TS-1",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_SP_NA_1"}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-3", "typeid":"M_ME_NB_1", "max_age":"10"}]
+                },
+                {
+                    "label":"C-1",
+                    "protocols":[{"name":"iec104", "address":"45-100", "typeid":"C_SC_NA_1", "max_age":10}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    uint32_t tm1 = exchangeTable->find(45, 1);
+    uint32_t ts1 = exchangeTable->find(45, 2);
+
+    IEC104PointFreshness freshness;
+    IEC104StalenessMonitor stalenessMonitor;
+    std::vector<uint32_t> stalePoints;
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 100000, stalePoints);
+    ASSERT_EQ(0, stalePoints.size());
+
+    // TM-1 refreshed at 105 s exceeds its max_age at 115 s
+    freshness.refresh(exchangeTable, tm1, 105000);
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 110000, stalePoints);
+    ASSERT_EQ(0, stalePoints.size());
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 115000, stalePoints);
+    ASSERT_EQ(1, stalePoints.size());
+    ASSERT_EQ(tm1, stalePoints[0]);
+
+    // TS-1 never refreshed exceeds the max_age of its type 20 s after the start
+    stalePoints.clear();
+    stalenessMonitor.tick(exchangeTable, config, freshness, 120000, stalePoints);
+    ASSERT_EQ(1, stalePoints.size());
+    ASSERT_EQ(ts1, stalePoints[0]);
+
+    // reported once while not refreshed
+    stalePoints.clear();
+    stalenessMonitor.tick(exchangeTable, config, freshness, 125000, stalePoints);
+    ASSERT_EQ(0, stalePoints.size());
+
+    // reported again when refreshed and stale again
+    freshness.refresh(exchangeTable, tm1, 126000);
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 135000, stalePoints);
+    ASSERT_EQ(0, stalePoints.size());
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 136000, stalePoints);
+    ASSERT_EQ(1, stalePoints.size());
+    ASSERT_EQ(tm1, stalePoints[0]);
+
+    ASSERT_EQ(3, stalenessMonitor.StaleCount());
+
+    // new active connection
+    stalePoints.clear();
+    stalenessMonitor.restart();
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 137000, stalePoints);
+    ASSERT_EQ(0, stalePoints.size());
+
+    stalenessMonitor.tick(exchangeTable, config, freshness, 147000, stalePoints);
+    ASSERT_EQ(1, stalePoints.size());
+    ASSERT_EQ(tm1, stalePoints[0]);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sstream>
+
+#include <sys/resource.h>
+
+#include <lib60870/cs104_connection.h>
+
+#include "iec104_client_config.h"
+
+using namespace std;
+
+// Generate an exchanged_data configuration with the given number of data points (1000 IOAs per CA)
+static string createExchangedData(int datapoints)
+{
+    ostringstream json;
+
+    json << "{\"exchanged_data\":{\"name\":\"SAMPLE\",\"version\":\"1.0\",\"datapoints\":[";
+
+    for (int i = 0; i < datapoints; i++) {
+        if (i > 0)
+            json << ",";
+
+        json << "{\"label\":\"TM-" << i << "\",\"pivot_id\":\"ID-" << i << "\",\"pivot_type\":\"MvTyp\","
+             << "\"protocols\":[{\"name\":\"iec104\",\"address\":\"" << (i / 1000) + 1 << "-" << i << "\","
+             << "\"typeid\":\"M_ME_NC_1\",\"gi_groups\":\"station\"}]}";
+    }
+
+    json << "]}}";
+
+    return json.str();
+}
+
+static long peakRssKb()
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+TEST(PivotIEC104PluginImport, ImportExchangedData)
+{
+    IEC104ClientConfig config;
+
+    config.importExchangeConfig(createExchangedData(2000));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    ASSERT_EQ(2, exchangeTable->listOfCAs.size());
+    ASSERT_EQ(2000, exchangeTable->Size());
+
+    uint32_t first, last;
+
+    ASSERT_TRUE(exchangeTable->caRange(2, first, last));
+    ASSERT_EQ(1000, last - first);
+
+    uint32_t pointId = exchangeTable->find(2, 1999);
+
+    ASSERT_NE(IEC104ExchangeTable::NO_POINT, pointId);
+    ASSERT_EQ("TM-1999", exchangeTable->label(pointId));
+    ASSERT_EQ(M_ME_NC_1, exchangeTable->typeIds[pointId]);
+    ASSERT_EQ(1, exchangeTable->giGroups[pointId]);
+}
+
+// Import time and peak RSS for a very large configuration
+// Run with: ./RunTests --gtest_also_run_disabled_tests --gtest_filter=*BenchmarkImport*
+TEST(PivotIEC104PluginImport, DISABLED_BenchmarkImport)
+{
+    const int datapoints = 200000;
+
+    string exchangedData = createExchangedData(datapoints);
+
+    long rssBefore = peakRssKb();
+
+    IEC104ClientConfig config;
+
+    auto start = chrono::steady_clock::now();
+
+    config.importExchangeConfig(exchangedData);
+
+    auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    long rssAfter = peakRssKb();
+
+    printf("Imported %d data points (%lu bytes of JSON) in %ld ms, peak RSS %ld kB -> %ld kB (+%ld kB)\n", datapoints,
+           exchangedData.size(), static_cast<long>(duration.count()), rssBefore, rssAfter, rssAfter - rssBefore);
+
+    ASSERT_EQ(datapoints / 1000, config.ExchangeTable()->listOfCAs.size());
+
+    IEC104ExchangeTable::MemoryUsage usage = config.ExchangeTable()->memoryUsage();
+
+    printf("Exchange table: %lu bytes per data point (points: %lu, labels: %lu, indexes: %lu bytes)\n",
+           (usage.pointBytes + usage.labelBytes + usage.indexBytes) / usage.points, usage.pointBytes, usage.labelBytes, usage.indexBytes);
+
+    // second import with the same exchanged_data is loaded from the binary cache
+    string cacheFile = "./iec104_exchange_benchmark.bin";
+
+    IEC104ClientConfig cacheWriter;
+
+    cacheWriter.setExchangeTableCache(cacheFile);
+    cacheWriter.importExchangeConfig(exchangedData);
+
+    IEC104ClientConfig cacheReader;
+
+    cacheReader.setExchangeTableCache(cacheFile);
+
+    start = chrono::steady_clock::now();
+
+    cacheReader.importExchangeConfig(exchangedData);
+
+    duration = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    printf("Loaded %d data points from the exchange table cache in %ld ms\n", datapoints, static_cast<long>(duration.count()));
+
+    ASSERT_TRUE(cacheReader.isExchangeTableFromCache());
+
+    remove(cacheFile.c_str());
+}
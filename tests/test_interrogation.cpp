@@ -14,6 +14,9 @@
 
 #include "iec104.h"
 #include "iec104_client_config.h"
+#include "iec104_point_freshness.h"
+#include "iec104_read_scheduler.h"
+#include "iec104_gi_arbiter.h"
 
 using namespace std;
 
@@ -157,6 +160,132 @@ static string protocol_config3 = QUOTE({
     });
 
 
+static string protocol_config_parallel = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            },
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false,
+                        "k_value" : 12,
+                        "w_value" : 8,
+                        "t0_timeout" : 10,
+                        "t1_timeout" : 15,
+                        "t2_timeout" : 10,
+                        "t3_timeout" : 20
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 0,
+                "gi_all_ca" : true,
+                "gi_parallel" : 2,
+                "utc_time" : false,
+                "cmd_with_timetag" : false,
+                "cmd_parallel" : 0,
+                "time_sync" : 100
+            },
+            "south_monitoring" : {
+                "asset": "CONSTAT-1"
+            }
+        }
+    });
+
+static string protocol_config_groups = QUOTE({
+        "protocol_stack" : {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "transport_layer" : {
+                "redundancy_groups" : [
+                    {
+                        "connections" : [
+                            {
+                                "srv_ip" : "127.0.0.1",
+                                "port" : 2404
+                            }
+                        ],
+                        "rg_name" : "red-group1",
+                        "tls" : false,
+                        "k_value" : 12,
+                        "w_value" : 8,
+                        "t0_timeout" : 10,
+                        "t1_timeout" : 15,
+                        "t2_timeout" : 10,
+                        "t3_timeout" : 20
+                    }
+                ]
+            },
+            "application_layer" : {
+                "orig_addr" : 10,
+                "ca_asdu_size" : 2,
+                "ioaddr_size" : 3,
+                "asdu_size" : 0,
+                "gi_time" : 60,
+                "gi_cycle" : 0,
+                "gi_all_ca" : false,
+                "gi_group_cycles" : [
+                    { "group" : 1, "cycle" : 1 },
+                    { "group" : 2, "cycle" : 1800 }
+                ],
+                "utc_time" : false,
+                "cmd_with_timetag" : false,
+                "cmd_parallel" : 0,
+                "time_sync" : 100
+            },
+            "south_monitoring" : {
+                "asset": "CONSTAT-1"
+            }
+        }
+    });
+
+static string exchanged_data_groups = QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"41025-4202832",
+                          "typeid":"M_ME_NA_1",
+                          "gi_groups":"station 1"
+                       }
+                    ]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[
+                       {
+                          "name":"iec104",
+                          "address":"41025-4202852",
+                          "typeid":"M_ME_NA_1",
+                          "gi_groups":"station 2"
+                       }
+                    ]
+                }
+            ]
+        }
+    });
+
 static string exchanged_data = QUOTE({
         "exchanged_data": {
             "name" : "iec104client",
@@ -310,6 +439,7 @@ protected:
     IMasterConnection lastConnection = nullptr;
     int lastOA = 0;
     int interrogationRequestsReceived = 0;
+    int groupInterrogationRequestsReceived[17] = {};
 
     void SetUp()
     {
@@ -803,6 +933,54 @@ protected:
         return true;
     }
 
+    static bool interrogationHandler_groups(void* parameter, IMasterConnection connection, CS101_ASDU asdu, uint8_t qoi)
+    {
+        InterrogationTest* self = (InterrogationTest*)parameter;
+
+        self->interrogationRequestsReceived++;
+
+        printf("CA=%i Received interrogation for group %i\n", CS101_ASDU_getCA(asdu), qoi);
+
+        if ((qoi > 20) && (qoi <= 36)) {
+            self->groupInterrogationRequestsReceived[qoi - 20]++;
+        }
+
+        CS101_AppLayerParameters alParams = IMasterConnection_getApplicationLayerParameters(connection);
+
+        IMasterConnection_sendACT_CON(connection, asdu, false);
+
+        CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, (CS101_CauseOfTransmission)qoi, 0, 41025, false, false);
+
+        CS101_ASDU_addInformationObject(newAsdu, (InformationObject) MeasuredValueNormalized_create(NULL, 4202832, 0.5, IEC60870_QUALITY_GOOD));
+
+        IMasterConnection_sendASDU(connection, newAsdu);
+        CS101_ASDU_destroy(newAsdu);
+
+        IMasterConnection_sendACT_TERM(connection, asdu);
+
+        return true;
+    }
+
+    static bool interrogationHandler_groups_No_ACT_CON(void* parameter, IMasterConnection connection, CS101_ASDU asdu, uint8_t qoi)
+    {
+        InterrogationTest* self = (InterrogationTest*)parameter;
+
+        self->interrogationRequestsReceived++;
+
+        printf("CA=%i Received interrogation for group %i\n", CS101_ASDU_getCA(asdu), qoi);
+
+        if ((qoi > 20) && (qoi <= 36)) {
+            // group interrogations not answered
+            self->groupInterrogationRequestsReceived[qoi - 20]++;
+            return true;
+        }
+
+        IMasterConnection_sendACT_CON(connection, asdu, false);
+        IMasterConnection_sendACT_TERM(connection, asdu);
+
+        return true;
+    }
+
     static bool interrogationHandler_No_ACT_CON(void* parameter, IMasterConnection connection, CS101_ASDU asdu, uint8_t qoi)
     {
         InterrogationTest* self = (InterrogationTest*)parameter;
@@ -1012,6 +1190,118 @@ TEST_F(InterrogationTest, IEC104Client_GIcycleOneSecondNoACT_CON)
     Thread_sleep(500);
 }
 
+TEST_F(InterrogationTest, IEC104Client_parallelRequestsForEachCA)
+{
+    iec104->setJsonConfig(protocol_config_parallel, exchanged_data, tls_config);
+
+    asduHandlerCalled = 0;
+    interrogationRequestsReceived = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setInterrogationHandler(slave, interrogationHandler_No_ACT_CON, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(1000);
+
+    // both CAs are interrogated without waiting for the ACT_CON of the first one
+    ASSERT_EQ(2, interrogationRequestsReceived);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+
+    Thread_sleep(500);
+}
+
+TEST_F(InterrogationTest, IEC104Client_groupInterrogationCycle)
+{
+    iec104->setJsonConfig(protocol_config_groups, exchanged_data_groups, tls_config);
+
+    asduHandlerCalled = 0;
+    interrogationRequestsReceived = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setInterrogationHandler(slave, interrogationHandler_groups, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(2800);
+
+    // station GI at startup only (gi_cycle = 0), group 1 every second, group 2 not due yet
+    ASSERT_EQ(1, interrogationRequestsReceived - groupInterrogationRequestsReceived[1] - groupInterrogationRequestsReceived[2]);
+    ASSERT_GE(groupInterrogationRequestsReceived[1], 2);
+    ASSERT_EQ(0, groupInterrogationRequestsReceived[2]);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+
+    Thread_sleep(500);
+}
+
+TEST_F(InterrogationTest, IEC104Client_groupInterrogationTimeout)
+{
+    // group interrogation timed out after 1 s
+    string timeoutConfig = protocol_config_groups;
+    timeoutConfig.replace(timeoutConfig.find("\"gi_time\" : 60"), strlen("\"gi_time\" : 60"), "\"gi_time\" : 1");
+
+    iec104->setJsonConfig(timeoutConfig, exchanged_data_groups, tls_config);
+
+    asduHandlerCalled = 0;
+    interrogationRequestsReceived = 0;
+    clockSyncHandlerCalled = 0;
+    lastConnection = NULL;
+    ingestCallbackCalled = 0;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+    ASSERT_NE(slave, nullptr);
+
+    CS104_Slave_setLocalPort(slave, TEST_PORT);
+
+    CS104_Slave_setClockSyncHandler(slave, clockSynchronizationHandler, this);
+    CS104_Slave_setASDUHandler(slave, asduHandler, this);
+    CS104_Slave_setInterrogationHandler(slave, interrogationHandler_groups_No_ACT_CON, this);
+
+    CS104_Slave_start(slave);
+
+    startIEC104();
+
+    Thread_sleep(4500);
+
+    // the group is interrogated again at its next cycle, the connection is kept: no new station GI
+    ASSERT_EQ(1, interrogationRequestsReceived - groupInterrogationRequestsReceived[1] - groupInterrogationRequestsReceived[2]);
+    ASSERT_GE(groupInterrogationRequestsReceived[1], 2);
+
+    CS104_Slave_stop(slave);
+
+    CS104_Slave_destroy(slave);
+
+    Thread_sleep(500);
+}
+
 TEST_F(InterrogationTest, InterrogationRequestAfter_M_EI_NA_1)
 {
     iec104->setJsonConfig(protocol_config2, exchanged_data, tls_config);
@@ -1376,3 +1666,232 @@ TEST_F(InterrogationTest, InterrogationRequestAfterExpPart)
     CS104_Slave_stop(slave);
     CS104_Slave_destroy(slave);
 }
+
+TEST(IEC104PointFreshness, StationGroupCoverage)
+{
+    IEC104ClientConfig config;
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "gi_groups":"station"}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_ME_NA_1", "gi_groups":"station"}]
+                },
+                {
+                    "label":"TM-3",
+                    "protocols":[{"name":"iec104", "address":"45-3", "typeid":"M_ME_NA_1", "gi_groups":"station"}]
+                },
+                {
+                    "label":"TM-4",
+                    "protocols":[{"name":"iec104", "address":"45-4", "typeid":"M_ME_NA_1"}]
+                },
+                {
+                    "label":"C-1",
+                    "protocols":[{"name":"iec104", "address":"45-100", "typeid":"C_SC_NA_1", "gi_groups":"station"}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    IEC104PointFreshness freshness;
+
+    freshness.refresh(exchangeTable, exchangeTable->find(45, 1), 10000);
+    freshness.refresh(exchangeTable, exchangeTable->find(45, 2), 20000);
+    freshness.refresh(exchangeTable, exchangeTable->find(45, 4), 20000);
+
+    IEC104PointFreshness::Coverage coverage = freshness.coverage(exchangeTable, 15000, 10);
+
+    // TM-4 is not in the station group and C-1 is a command
+    ASSERT_EQ(3, coverage.points);
+    ASSERT_EQ(1, coverage.fresh);
+    ASSERT_EQ(2, coverage.stale.size());
+    ASSERT_EQ(3, coverage.stale[0].ioa);
+    ASSERT_EQ(0, coverage.stale[0].lastRefresh);
+    ASSERT_EQ(1, coverage.stale[1].ioa);
+    ASSERT_EQ(10000, coverage.stale[1].lastRefresh);
+
+    coverage = freshness.coverage(exchangeTable, 5000, 1);
+
+    ASSERT_EQ(2, coverage.fresh);
+    ASSERT_EQ(1, coverage.stale.size());
+
+    // the refresh times of the addresses kept in a new exchange table are kept
+    std::vector<int> changedCAs;
+
+    ASSERT_TRUE(config.reloadExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_ME_NA_1", "gi_groups":"station"}]
+                },
+                {
+                    "label":"TM-5",
+                    "protocols":[{"name":"iec104", "address":"45-5", "typeid":"M_ME_NA_1", "gi_groups":"station"}]
+                }
+            ]
+        }
+    }), changedCAs));
+
+    coverage = freshness.coverage(config.ExchangeTable(), 15000, 10);
+
+    ASSERT_EQ(2, coverage.points);
+    ASSERT_EQ(1, coverage.fresh);
+    ASSERT_EQ(5, coverage.stale[0].ioa);
+}
+
+TEST(IEC104ReadScheduler, StaleDataPointReads)
+{
+    IEC104ClientConfig config;
+
+    config.importExchangeConfig(QUOTE({
+        "exchanged_data": {
+            "name" : "iec104client",
+            "version" : "1.0",
+            "datapoints" : [
+                {
+                    "label":"TM-1",
+                    "protocols":[{"name":"iec104", "address":"45-1", "typeid":"M_ME_NA_1", "stale_after":10}]
+                },
+                {
+                    "label":"TM-2",
+                    "protocols":[{"name":"iec104", "address":"45-2", "typeid":"M_ME_NA_1", "stale_after":20}]
+                },
+                {
+                    "label":"TM-3",
+                    "protocols":[{"name":"iec104", "address":"45-3", "typeid":"M_ME_NA_1", "stale_after":"10"}]
+                },
+                {
+                    "label":"C-1",
+                    "protocols":[{"name":"iec104", "address":"45-100", "typeid":"C_SC_NA_1", "stale_after":10}]
+                }
+            ]
+        }
+    }));
+
+    auto exchangeTable = config.ExchangeTable();
+
+    IEC104PointFreshness freshness;
+    IEC104ReadScheduler readScheduler;
+    std::vector<IEC104ReadScheduler::Read> reads;
+
+    // TM-3 has no stale_after and no default, C-1 is a command
+    readScheduler.tick(exchangeTable, freshness, 100000, 0, 1, 10000, reads);
+    ASSERT_EQ(0, reads.size());
+
+    // TM-1 refreshed at 105 s is read at 115 s
+    freshness.refresh(exchangeTable, exchangeTable->find(45, 1), 105000);
+
+    readScheduler.tick(exchangeTable, freshness, 110000, 0, 1, 10000, reads);
+    ASSERT_EQ(0, reads.size());
+
+    readScheduler.tick(exchangeTable, freshness, 115000, 0, 1, 10000, reads);
+    ASSERT_EQ(1, reads.size());
+    ASSERT_EQ(1, reads[0].ioa);
+
+    // TM-2 never refreshed is stale 20 s after the start, but only one read at a time
+    reads.clear();
+    readScheduler.tick(exchangeTable, freshness, 120000, 0, 1, 10000, reads);
+    ASSERT_EQ(0, reads.size());
+    ASSERT_EQ(1, readScheduler.QueuedCount());
+
+    freshness.refresh(exchangeTable, exchangeTable->find(45, 1), 120000);
+    readScheduler.readAnswered(45, 1, 120000);
+
+    readScheduler.tick(exchangeTable, freshness, 120000, 0, 1, 10000, reads);
+    ASSERT_EQ(1, reads.size());
+    ASSERT_EQ(2, reads[0].ioa);
+
+    // read on request (skipped GI) whatever the age
+    reads.clear();
+    readScheduler.request(exchangeTable, 45, 3, 121000);
+    readScheduler.tick(exchangeTable, freshness, 121000, 0, 1, 10000, reads);
+    ASSERT_EQ(0, reads.size());
+
+    // no response for TM-2 within the timeout, TM-1 is read again 10 s after the response
+    readScheduler.tick(exchangeTable, freshness, 130000, 0, 1, 10000, reads);
+    ASSERT_EQ(1, reads.size());
+    ASSERT_EQ(3, reads[0].ioa);
+    ASSERT_EQ(1, readScheduler.QueuedCount());
+
+    readScheduler.readRejected(45, 3, 130000);
+
+    reads.clear();
+    readScheduler.tick(exchangeTable, freshness, 130000, 0, 1, 10000, reads);
+    ASSERT_EQ(1, reads.size());
+    ASSERT_EQ(1, reads[0].ioa);
+
+    readScheduler.sendFailed(reads[0]);
+    ASSERT_EQ(1, readScheduler.QueuedCount());
+
+    IEC104ReadScheduler::Counters counters = readScheduler.getCounters();
+
+    ASSERT_EQ(3, counters.sent);
+    ASSERT_EQ(1, counters.answered);
+    ASSERT_EQ(1, counters.rejected);
+    ASSERT_EQ(1, counters.timedOut);
+
+    // with a default stale_after TM-3 is read as well
+    reads.clear();
+    readScheduler.tick(exchangeTable, freshness, 131000, 1, 4, 10000, reads);
+    ASSERT_EQ(3, reads.size());
+}
+
+TEST(IEC104GiArbiter, MergedAndDeferredRequests)
+{
+    IEC104GiArbiter giArbiter;
+    uint32_t sources = 0;
+
+    // requests received before the first GI are covered by it
+    giArbiter.request(IEC104GiArbiter::Source::NORTH_STATUS);
+    giArbiter.started(1000, true);
+
+    ASSERT_FALSE(giArbiter.isPending());
+    ASSERT_EQ(1, giArbiter.getCounters(IEC104GiArbiter::Source::NORTH_STATUS).merged);
+
+    // requests of several sources are merged into one GI, delayed by the minimum interval
+    giArbiter.request(IEC104GiArbiter::Source::TRIGGER_SOUTH_GI);
+    giArbiter.request(IEC104GiArbiter::Source::TRIGGER_SOUTH_GI);
+    giArbiter.request(IEC104GiArbiter::Source::NORTH_STATUS);
+
+    ASSERT_FALSE(giArbiter.acquire(10000, 30000, sources));
+    ASSERT_FALSE(giArbiter.acquire(20000, 30000, sources));
+    ASSERT_TRUE(giArbiter.acquire(31000, 30000, sources));
+    ASSERT_EQ("north_status, trigger_south_gi", IEC104GiArbiter::sourceNames(sources));
+    ASSERT_FALSE(giArbiter.acquire(70000, 30000, sources));
+
+    IEC104GiArbiter::SourceCounters counters = giArbiter.getCounters(IEC104GiArbiter::Source::TRIGGER_SOUTH_GI);
+
+    ASSERT_EQ(2, counters.requests);
+    ASSERT_EQ(1, counters.merged);
+    ASSERT_EQ(1, counters.deferred);
+
+    counters = giArbiter.getCounters(IEC104GiArbiter::Source::NORTH_STATUS);
+
+    ASSERT_EQ(2, counters.requests);
+    ASSERT_EQ(2, counters.merged);
+    ASSERT_EQ(0, counters.deferred);
+
+    // interrogation of a single CA
+    ASSERT_TRUE(IEC104GiArbiter::Admission::DEFER == giArbiter.admit(IEC104GiArbiter::Source::OPERATION, 40000, 30000));
+    ASSERT_TRUE(IEC104GiArbiter::Admission::SEND == giArbiter.admit(IEC104GiArbiter::Source::OPERATION, 61000, 30000));
+
+    giArbiter.request(IEC104GiArbiter::Source::CYCLE);
+
+    ASSERT_TRUE(IEC104GiArbiter::Admission::MERGED == giArbiter.admit(IEC104GiArbiter::Source::OPERATION, 100000, 30000));
+    ASSERT_TRUE(giArbiter.acquire(100000, 30000, sources));
+    ASSERT_EQ("cycle", IEC104GiArbiter::sourceNames(sources));
+
+    ASSERT_EQ(4, giArbiter.StartedCount());
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
 
 #include "iec104_utility.h"
+#include "iec104_audit_queue.h"
 
 TEST(PivotIEC104PluginUtility, Logs)
 {
@@ -24,4 +27,50 @@ TEST(PivotIEC104PluginUtility, Audit)
     ASSERT_NO_THROW(Iec104Utility::audit_info("SRVFL", jsonAudit, false));
     ASSERT_NO_THROW(Iec104Utility::audit_warn("SRVFL", jsonAudit, false));
     ASSERT_NO_THROW(Iec104Utility::audit_fail("SRVFL", jsonAudit, false));
-}
\ No newline at end of file
+}
+
+TEST(PivotIEC104PluginUtility, AuditQueue)
+{
+    IEC104AuditQueue auditQueue(2, 500);
+
+    // not started: audits are sent immediately
+    ASSERT_NO_THROW(auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", "service-disconnected"));
+    ASSERT_NO_THROW(auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", "service-disconnected"));
+    ASSERT_EQ(1, auditQueue.CoalescedCount());
+    ASSERT_EQ(1, auditQueue.SentCount());
+    ASSERT_EQ(0, auditQueue.BatchCount());
+
+    auditQueue.start();
+
+    // the first audit after start is never coalesced, the oldest audits are dropped when the queue is full
+    auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", "service-disconnected");
+    auditQueue.push(IEC104AuditQueue::Level::SUCCESS, "SRVFL", "service-connected");
+    auditQueue.push(IEC104AuditQueue::Level::SUCCESS, "SRVFL", "service-connected");
+    auditQueue.push(IEC104AuditQueue::Level::FAILURE, "SRVFL", "service-disconnected");
+    auditQueue.push(IEC104AuditQueue::Level::INFORMATION, "SRVFL", "{}", false);
+    ASSERT_EQ(2, auditQueue.CoalescedCount());
+    ASSERT_EQ(2, auditQueue.DroppedCount());
+
+    // the audits queued during the batch delay are sent in one batch
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    ASSERT_EQ(3, auditQueue.SentCount());
+    ASSERT_EQ(1, auditQueue.BatchCount());
+
+    // stop sends the queued audits without waiting for the batch delay
+    auditQueue.push(IEC104AuditQueue::Level::WARNING, "SRVFL", "service-warning");
+    auditQueue.push(IEC104AuditQueue::Level::SUCCESS, "SRVFL", "service-connected");
+
+    auto stopStart = std::chrono::steady_clock::now();
+
+    ASSERT_NO_THROW(auditQueue.stop());
+    ASSERT_LT(std::chrono::steady_clock::now() - stopStart, std::chrono::milliseconds(500));
+    ASSERT_EQ(5, auditQueue.SentCount());
+    ASSERT_EQ(2, auditQueue.BatchCount());
+    ASSERT_EQ(2, auditQueue.DroppedCount());
+
+    ASSERT_NO_THROW(auditQueue.stop());
+
+    ASSERT_NO_THROW(auditQueue.push(IEC104AuditQueue::Level::WARNING, "SRVFL", "service-warning"));
+    ASSERT_EQ(6, auditQueue.SentCount());
+}